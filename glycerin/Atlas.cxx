@@ -0,0 +1,75 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "glycerin/Atlas.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs an atlas.
+ *
+ * @param bitmap Bitmap holding every packed bitmap
+ * @param regions Where each bitmap is, in the order they were added
+ */
+Atlas::Atlas(const Bitmap& bitmap, const vector<AtlasRegion>& regions) :
+        _bitmap(bitmap),
+        _regions(regions) {
+    // empty
+}
+
+/**
+ * Returns the bitmap holding every packed bitmap.
+ */
+const Bitmap& Atlas::bitmap() const {
+    return _bitmap;
+}
+
+/**
+ * Creates a new OpenGL texture on the current texture unit from the atlas.
+ *
+ * @param mipmaps Whether to automatically generate mipmaps, by default `true`
+ * @return Handle for the new OpenGL texture
+ * @see Bitmap::createTexture
+ */
+Gloop::TextureObject Atlas::createTexture(const bool mipmaps) const {
+    return _bitmap.createTexture(mipmaps);
+}
+
+/**
+ * Returns where one of the packed bitmaps is.
+ *
+ * @param index Position of the bitmap in the order they were added
+ * @return Region of the atlas holding the bitmap
+ * @throws out_of_range if index is not less than the number of bitmaps
+ */
+const AtlasRegion& Atlas::region(const size_t index) const {
+    if (index >= _regions.size()) {
+        throw out_of_range("[Atlas] Index is out of range!");
+    }
+    return _regions[index];
+}
+
+/**
+ * Returns the number of bitmaps packed into the atlas.
+ */
+size_t Atlas::size() const {
+    return _regions.size();
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,63 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_ATLAS_HXX
+#define GLYCERIN_ATLAS_HXX
+#include "glycerin/common.h"
+#include <vector>
+#include <gloop/TextureObject.hxx>
+#include "glycerin/AtlasRegion.hxx"
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Many bitmaps packed into one.
+ *
+ * To get an _Atlas_, add bitmaps to an [atlas builder] and build it.  Then
+ * make a single texture out of it with [create-texture] and look up where
+ * each bitmap ended up with [region], passing the order it was added in.
+ *
+ * ~~~
+ * const Atlas atlas = AtlasBuilder().add(play).add(pause).build();
+ * const Gloop::TextureObject texture = atlas.createTexture();
+ * const AtlasRegion& region = atlas.region(1);
+ * ~~~
+ *
+ * [atlas builder]: @ref AtlasBuilder "AtlasBuilder"
+ * [create-texture]: @ref createTexture(bool) const "createTexture(bool)"
+ * [region]: @ref region(size_t) const "region(size_t)"
+ */
+class Atlas {
+public:
+// Methods
+    const Bitmap& bitmap() const;
+    Gloop::TextureObject createTexture(bool mipmaps = true) const;
+    const AtlasRegion& region(size_t index) const;
+    size_t size() const;
+private:
+// Attributes
+    Bitmap _bitmap;
+    std::vector<AtlasRegion> _regions;
+// Methods
+    Atlas(const Bitmap& bitmap, const std::vector<AtlasRegion>& regions);
+// Friends
+    friend class AtlasBuilder;
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,357 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "glycerin/AtlasBuilder.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Orders bitmaps from tallest to shortest, then widest to narrowest.
+ */
+class AtlasBuilder::TallestFirst {
+public:
+    TallestFirst(const vector<Bitmap>& bitmaps) : bitmaps(bitmaps) { }
+    bool operator()(size_t a, size_t b) const {
+        if (bitmaps[a].getHeight() != bitmaps[b].getHeight()) {
+            return bitmaps[a].getHeight() > bitmaps[b].getHeight();
+        }
+        return bitmaps[a].getWidth() > bitmaps[b].getWidth();
+    }
+private:
+    const vector<Bitmap>& bitmaps;
+};
+
+/**
+ * Constructs an atlas builder with default settings.
+ */
+AtlasBuilder::AtlasBuilder() :
+        _maxSize(DEFAULT_MAX_SIZE),
+        _padding(DEFAULT_PADDING) {
+    // empty
+}
+
+/**
+ * Destroys the atlas builder.
+ */
+AtlasBuilder::~AtlasBuilder() {
+    // empty
+}
+
+/**
+ * Adds a bitmap to pack into the atlas.
+ *
+ * @param bitmap Bitmap to add, which is shared rather than copied
+ * @return Reference to this builder to support chaining
+ * @throws invalid_argument if bitmap is empty or not in `GL_BGR` or `GL_BGRA` format
+ */
+AtlasBuilder& AtlasBuilder::add(const Bitmap& bitmap) {
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[AtlasBuilder] Bitmap is empty!");
+    } else if ((bitmap.format != GL_BGR) && (bitmap.format != GL_BGRA)) {
+        throw invalid_argument("[AtlasBuilder] Bitmap is not GL_BGR or GL_BGRA!");
+    }
+    _bitmaps.push_back(bitmap);
+    return (*this);
+}
+
+/**
+ * Packs every bitmap that was added into a new atlas.
+ *
+ * @return Atlas holding the bitmaps, with regions in the order they were added
+ * @throws logic_error if no bitmaps were added
+ * @throws length_error if the bitmaps do not fit in the maximum size
+ */
+Atlas AtlasBuilder::build() const {
+
+    if (_bitmaps.empty()) {
+        throw logic_error("[AtlasBuilder] No bitmaps were added!");
+    }
+
+    // Find the smallest size that could possibly hold everything
+    size_t area = 0;
+    GLsizei widest = 0;
+    GLsizei tallest = 0;
+    GLenum format = GL_BGR;
+    for (size_t i = 0; i < _bitmaps.size(); ++i) {
+        const GLsizei width = _bitmaps[i].width + 2 * _padding;
+        const GLsizei height = _bitmaps[i].height + 2 * _padding;
+        area += ((size_t) width) * height;
+        widest = max(widest, width);
+        tallest = max(tallest, height);
+        if (_bitmaps[i].format == GL_BGRA) {
+            format = GL_BGRA;
+        }
+    }
+    GLsizei width = 1;
+    GLsizei height = 1;
+    while (width < widest) {
+        width *= 2;
+    }
+    while (height < tallest) {
+        height *= 2;
+    }
+    while (((size_t) width) * height < area) {
+        (width <= height) ? (width *= 2) : (height *= 2);
+    }
+
+    // Grow until everything fits
+    vector<GLint> xs;
+    vector<GLint> ys;
+    while (true) {
+        if ((width > _maxSize) || (height > _maxSize)) {
+            throw length_error("[AtlasBuilder] Bitmaps do not fit in maximum size!");
+        } else if (pack(width, height, xs, ys)) {
+            break;
+        }
+        (width <= height) ? (width *= 2) : (height *= 2);
+    }
+
+    // Make the bitmap
+    const GLsizei bytesPerPixel = (format == GL_BGRA) ? 4 : 3;
+    const GLsizei stride = ((width * bytesPerPixel + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+    Bitmap bitmap;
+    bitmap.setPixels(new GLubyte[((size_t) stride) * height], NULL);
+    bitmap.format = format;
+    bitmap.width = width;
+    bitmap.height = height;
+    bitmap.size = stride * height;
+    bitmap.alignment = ALIGNMENT;
+    memset(bitmap.pixels, 0, bitmap.size);
+
+    // Copy each bitmap in and record where it went
+    vector<AtlasRegion> regions(_bitmaps.size());
+    for (size_t i = 0; i < _bitmaps.size(); ++i) {
+        copy(_bitmaps[i], xs[i], ys[i], bitmap);
+        AtlasRegion& region = regions[i];
+        region._x = xs[i] + _padding;
+        region._y = ys[i] + _padding;
+        region._width = _bitmaps[i].width;
+        region._height = _bitmaps[i].height;
+        region._s0 = ((GLfloat) region._x) / width;
+        region._t0 = ((GLfloat) region._y) / height;
+        region._s1 = ((GLfloat) (region._x + region._width)) / width;
+        region._t1 = ((GLfloat) (region._y + region._height)) / height;
+    }
+    return Atlas(bitmap, regions);
+}
+
+/**
+ * Copies a bitmap into the atlas, surrounded by copies of its edge pixels.
+ *
+ * @param src Bitmap to copy
+ * @param x Position of the left edge of the padding in the atlas
+ * @param y Position of the bottom edge of the padding in the atlas
+ * @param dst Atlas to copy into
+ */
+void AtlasBuilder::copy(const Bitmap& src, const GLint x, const GLint y, Bitmap& dst) const {
+
+    const GLsizei srcBytesPerPixel = (src.format == GL_BGRA) ? 4 : 3;
+    const GLsizei dstBytesPerPixel = (dst.format == GL_BGRA) ? 4 : 3;
+    const size_t srcStride = ((src.width * srcBytesPerPixel + (src.alignment - 1)) / src.alignment) * src.alignment;
+    const size_t dstStride = dst.size / dst.height;
+
+    for (GLsizei row = 0; row < src.height + 2 * _padding; ++row) {
+        const GLsizei sy = min(max(row - _padding, 0), src.height - 1);
+        const GLubyte* const in = src.pixels + sy * srcStride;
+        GLubyte* const out = dst.pixels + (y + row) * dstStride + x * dstBytesPerPixel;
+
+        // Copy the middle of the row all at once if the formats match
+        const bool same = (srcBytesPerPixel == dstBytesPerPixel);
+        if (same) {
+            memcpy(out + _padding * dstBytesPerPixel, in, src.width * srcBytesPerPixel);
+        }
+
+        // Copy everything else a pixel at a time
+        for (GLsizei column = 0; column < src.width + 2 * _padding; ++column) {
+            if (same && (column >= _padding) && (column < _padding + src.width)) {
+                continue;
+            }
+            const GLsizei sx = min(max(column - _padding, 0), src.width - 1);
+            const GLubyte* const pixel = in + sx * srcBytesPerPixel;
+            GLubyte* const target = out + column * dstBytesPerPixel;
+            target[0] = pixel[0];
+            target[1] = pixel[1];
+            target[2] = pixel[2];
+            if (dstBytesPerPixel == 4) {
+                target[3] = (srcBytesPerPixel == 4) ? pixel[3] : 255;
+            }
+        }
+    }
+}
+
+/**
+ * Changes the largest width or height the atlas may have.
+ *
+ * @param maxSize Largest number of pixels along each edge of the atlas
+ * @return Reference to this builder to support chaining
+ * @throws invalid_argument if maximum size is less than one
+ */
+AtlasBuilder& AtlasBuilder::maxSize(const GLsizei maxSize) {
+    if (maxSize < 1) {
+        throw invalid_argument("[AtlasBuilder] Maximum size is less than one!");
+    }
+    _maxSize = maxSize;
+    return (*this);
+}
+
+/**
+ * Tries to find a position for every bitmap in an atlas of a certain size.
+ *
+ * @param width Size of the atlas in the X direction
+ * @param height Size of the atlas in the Y direction
+ * @param xs Positions of the left edges of the padding around each bitmap, if they fit
+ * @param ys Positions of the bottom edges of the padding around each bitmap, if they fit
+ * @return `true` if every bitmap fit
+ */
+bool AtlasBuilder::pack(const GLsizei width,
+                        const GLsizei height,
+                        vector<GLint>& xs,
+                        vector<GLint>& ys) const {
+
+    // Place the tallest bitmaps first
+    vector<size_t> order(_bitmaps.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), TallestFirst(_bitmaps));
+
+    // Start with an empty skyline
+    vector<Node> skyline(1);
+    skyline[0].x = 0;
+    skyline[0].y = 0;
+    skyline[0].width = width;
+
+    // Place each one
+    xs.resize(_bitmaps.size());
+    ys.resize(_bitmaps.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Bitmap& bitmap = _bitmaps[order[i]];
+        if (!place(skyline,
+                   bitmap.width + 2 * _padding,
+                   bitmap.height + 2 * _padding,
+                   height,
+                   xs[order[i]],
+                   ys[order[i]])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Changes the number of pixels between each bitmap and the edge of its area.
+ *
+ * @param padding Number of pixels to surround each bitmap with
+ * @return Reference to this builder to support chaining
+ * @throws invalid_argument if padding is negative
+ */
+AtlasBuilder& AtlasBuilder::padding(const GLsizei padding) {
+    if (padding < 0) {
+        throw invalid_argument("[AtlasBuilder] Padding is negative!");
+    }
+    _padding = padding;
+    return (*this);
+}
+
+/**
+ * Places a rectangle on the skyline as low as possible, and then as far left as possible.
+ *
+ * @param skyline Top edges of everything placed so far, from left to right
+ * @param width Size of the rectangle in the X direction
+ * @param height Size of the rectangle in the Y direction
+ * @param atlasHeight Size of the atlas in the Y direction
+ * @param x Position of the left edge of the rectangle, if it fits
+ * @param y Position of the bottom edge of the rectangle, if it fits
+ * @return `true` if the rectangle fit
+ */
+bool AtlasBuilder::place(vector<Node>& skyline,
+                         const GLsizei width,
+                         const GLsizei height,
+                         const GLsizei atlasHeight,
+                         GLint& x,
+                         GLint& y) {
+
+    const GLint atlasWidth = skyline.back().x + skyline.back().width;
+
+    // Find the lowest spot, breaking ties with the narrowest segment
+    size_t best = skyline.size();
+    GLint bestY = numeric_limits<GLint>::max();
+    GLsizei bestWidth = numeric_limits<GLsizei>::max();
+    for (size_t i = 0; i < skyline.size(); ++i) {
+        if (skyline[i].x + width > atlasWidth) {
+            break;
+        }
+        GLint top = 0;
+        GLint covered = 0;
+        for (size_t j = i; covered < width; ++j) {
+            top = max(top, skyline[j].y);
+            covered += skyline[j].width;
+        }
+        if (top + height > atlasHeight) {
+            continue;
+        }
+        if ((top < bestY) || ((top == bestY) && (skyline[i].width < bestWidth))) {
+            best = i;
+            bestY = top;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (best == skyline.size()) {
+        return false;
+    }
+    x = skyline[best].x;
+    y = bestY;
+
+    // Raise the skyline over the rectangle
+    Node node;
+    node.x = x;
+    node.y = y + height;
+    node.width = width;
+    skyline.insert(skyline.begin() + best, node);
+
+    // Trim segments now underneath it
+    const GLint right = x + width;
+    size_t i = best + 1;
+    while ((i < skyline.size()) && (skyline[i].x < right)) {
+        const GLint end = skyline[i].x + skyline[i].width;
+        if (end <= right) {
+            skyline.erase(skyline.begin() + i);
+        } else {
+            skyline[i].width = end - right;
+            skyline[i].x = right;
+            break;
+        }
+    }
+
+    // Merge neighboring segments at the same height
+    for (i = 0; i + 1 < skyline.size(); ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+    return true;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,83 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_ATLASBUILDER_HXX
+#define GLYCERIN_ATLASBUILDER_HXX
+#include "glycerin/common.h"
+#include <vector>
+#include "glycerin/Atlas.hxx"
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for packing many small bitmaps into one atlas.
+ *
+ * Binding a separate texture for every icon breaks batches and costs a state
+ * change each time.  _AtlasBuilder_ packs bitmaps into one larger bitmap so
+ * they can all be drawn from a single texture.  Add each bitmap with [add],
+ * then call [build].
+ *
+ * ~~~
+ * AtlasBuilder builder;
+ * builder.padding(2).add(play).add(pause).add(stop);
+ * const Atlas atlas = builder.build();
+ * ~~~
+ *
+ * Bitmaps are placed with a skyline packer, tallest first, in the smallest
+ * power-of-two atlas they fit in.  Each one is surrounded by padding filled
+ * with copies of its edge pixels, so filtering near an edge does not pick up
+ * its neighbors.  The builder starts with one pixel of padding and a maximum
+ * atlas size of 4096x4096.  If any added bitmap has alpha, the atlas is
+ * `GL_BGRA`; otherwise it is `GL_BGR`.
+ *
+ * [add]: @ref add(const Bitmap&) "add(const Bitmap&)"
+ * [build]: @ref build() const "build()"
+ */
+class AtlasBuilder {
+public:
+// Methods
+    AtlasBuilder();
+    virtual ~AtlasBuilder();
+    AtlasBuilder& add(const Bitmap& bitmap);
+    Atlas build() const;
+    AtlasBuilder& maxSize(GLsizei maxSize);
+    AtlasBuilder& padding(GLsizei padding);
+private:
+// Types
+    class TallestFirst;
+    struct Node {
+        GLint x;
+        GLint y;
+        GLsizei width;
+    };
+// Constants
+    static const GLint ALIGNMENT = 4;
+    static const GLsizei DEFAULT_MAX_SIZE = 4096;
+    static const GLsizei DEFAULT_PADDING = 1;
+// Attributes
+    std::vector<Bitmap> _bitmaps;
+    GLsizei _maxSize;
+    GLsizei _padding;
+// Methods
+    void copy(const Bitmap& src, GLint x, GLint y, Bitmap& dst) const;
+    bool pack(GLsizei width, GLsizei height, std::vector<GLint>& xs, std::vector<GLint>& ys) const;
+    static bool place(std::vector<Node>& skyline, GLsizei width, GLsizei height, GLsizei atlasHeight, GLint& x, GLint& y);
+};
+
+} /* namespace Glycerin */
+#endif
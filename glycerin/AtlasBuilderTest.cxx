@@ -0,0 +1,140 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/AtlasBuilder.hxx"
+#include "glycerin/BitmapGenerator.hxx"
+
+
+/**
+ * Unit test for `AtlasBuilder`.
+ */
+class AtlasBuilderTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Returns a noise bitmap of a certain size.
+     */
+    static Glycerin::Bitmap getBitmap(GLsizei width, GLsizei height, GLuint seed) {
+        return Glycerin::BitmapGenerator().size(width, height).seed(seed).generate();
+    }
+
+    /**
+     * Ensures `AtlasBuilder::build` places bitmaps without overlapping, inside the atlas.
+     */
+    void testBuildWithoutOverlap() {
+
+        // Pack a mix of sizes
+        Glycerin::AtlasBuilder builder;
+        for (GLuint i = 0; i < 40; ++i) {
+            builder.add(getBitmap(3 + (i * 7) % 29, 2 + (i * 11) % 23, i));
+        }
+        const Glycerin::Atlas atlas = builder.padding(2).build();
+        CPPUNIT_ASSERT_EQUAL((size_t) 40, atlas.size());
+
+        // Check every pair, including padding
+        const GLsizei width = atlas.bitmap().getWidth();
+        const GLsizei height = atlas.bitmap().getHeight();
+        for (size_t i = 0; i < atlas.size(); ++i) {
+            const Glycerin::AtlasRegion& a = atlas.region(i);
+            CPPUNIT_ASSERT(a.x() >= 2 && a.x() + a.width() + 2 <= width);
+            CPPUNIT_ASSERT(a.y() >= 2 && a.y() + a.height() + 2 <= height);
+            for (size_t j = i + 1; j < atlas.size(); ++j) {
+                const Glycerin::AtlasRegion& b = atlas.region(j);
+                const bool apart = (a.x() + a.width() + 2 <= b.x() - 2)
+                        || (b.x() + b.width() + 2 <= a.x() - 2)
+                        || (a.y() + a.height() + 2 <= b.y() - 2)
+                        || (b.y() + b.height() + 2 <= a.y() - 2);
+                CPPUNIT_ASSERT(apart);
+            }
+        }
+    }
+
+    /**
+     * Ensures `AtlasBuilder::build` copies pixels and pads with edge pixels.
+     */
+    void testBuildCopiesPixels() {
+
+        // Pack two bitmaps
+        const Glycerin::Bitmap first = getBitmap(5, 3, 1);
+        const Glycerin::Bitmap second = getBitmap(4, 6, 2);
+        const Glycerin::Atlas atlas = Glycerin::AtlasBuilder().add(first).add(second).build();
+
+        // Compare the second bitmap, including the pixel to its left
+        const std::vector<GLubyte> expected = getPixels(second);
+        const std::vector<GLubyte> actual = getPixels(atlas.bitmap());
+        const Glycerin::AtlasRegion& region = atlas.region(1);
+        const GLsizei stride = atlas.bitmap().getSize() / atlas.bitmap().getHeight();
+        for (GLsizei y = 0; y < 6; ++y) {
+            for (GLsizei x = -1; x < 4; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    const GLubyte e = expected[y * 12 + (x < 0 ? 0 : x) * 3 + c];
+                    const GLubyte a = actual[(region.y() + y) * stride + (region.x() + x) * 3 + c];
+                    CPPUNIT_ASSERT_EQUAL((int) e, (int) a);
+                }
+            }
+        }
+
+        // Check texture coordinates
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(((double) region.x()) / atlas.bitmap().getWidth(), region.s0(), 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(((double) region.y() + 6) / atlas.bitmap().getHeight(), region.t1(), 1e-6);
+    }
+
+    /**
+     * Ensures `AtlasBuilder::build` throws if the bitmaps cannot fit.
+     */
+    void testBuildWithTooSmallMaxSize() {
+        Glycerin::AtlasBuilder builder;
+        builder.maxSize(16).add(getBitmap(12, 12, 0)).add(getBitmap(12, 12, 1));
+        CPPUNIT_ASSERT_THROW(builder.build(), std::length_error);
+    }
+
+    /**
+     * Ensures `AtlasBuilder::build` throws if no bitmaps were added.
+     */
+    void testBuildWithNoBitmaps() {
+        CPPUNIT_ASSERT_THROW(Glycerin::AtlasBuilder().build(), std::logic_error);
+    }
+
+    CPPUNIT_TEST_SUITE(AtlasBuilderTest);
+    CPPUNIT_TEST(testBuildWithoutOverlap);
+    CPPUNIT_TEST(testBuildCopiesPixels);
+    CPPUNIT_TEST(testBuildWithTooSmallMaxSize);
+    CPPUNIT_TEST(testBuildWithNoBitmaps);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(AtlasBuilderTest::suite());
+    runner.run();
+    return 0;
+}
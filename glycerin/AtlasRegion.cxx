@@ -0,0 +1,78 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "glycerin/AtlasRegion.hxx"
+namespace Glycerin {
+
+/**
+ * Returns the size of the region in the Y direction, in pixels.
+ */
+GLsizei AtlasRegion::height() const {
+    return _height;
+}
+
+/**
+ * Returns the texture coordinate of the left edge of the region.
+ */
+GLfloat AtlasRegion::s0() const {
+    return _s0;
+}
+
+/**
+ * Returns the texture coordinate of the right edge of the region.
+ */
+GLfloat AtlasRegion::s1() const {
+    return _s1;
+}
+
+/**
+ * Returns the texture coordinate of the bottom edge of the region.
+ */
+GLfloat AtlasRegion::t0() const {
+    return _t0;
+}
+
+/**
+ * Returns the texture coordinate of the top edge of the region.
+ */
+GLfloat AtlasRegion::t1() const {
+    return _t1;
+}
+
+/**
+ * Returns the size of the region in the X direction, in pixels.
+ */
+GLsizei AtlasRegion::width() const {
+    return _width;
+}
+
+/**
+ * Returns the position of the left edge of the region, in pixels.
+ */
+GLint AtlasRegion::x() const {
+    return _x;
+}
+
+/**
+ * Returns the position of the bottom edge of the region, in pixels.
+ */
+GLint AtlasRegion::y() const {
+    return _y;
+}
+
+} /* namespace Glycerin */
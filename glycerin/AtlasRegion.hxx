@@ -0,0 +1,58 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_ATLASREGION_HXX
+#define GLYCERIN_ATLASREGION_HXX
+#include "glycerin/common.h"
+namespace Glycerin {
+
+
+/**
+ * Area of an atlas holding one of the bitmaps packed into it.
+ *
+ * Positions are measured in pixels from the bottom-left corner of the atlas,
+ * and texture coordinates run from zero to one across the whole atlas, so
+ * `s0` and `t0` are the bottom-left corner of the bitmap and `s1` and `t1`
+ * are its top-right corner.
+ */
+class AtlasRegion {
+public:
+// Methods
+    GLsizei height() const;
+    GLfloat s0() const;
+    GLfloat s1() const;
+    GLfloat t0() const;
+    GLfloat t1() const;
+    GLsizei width() const;
+    GLint x() const;
+    GLint y() const;
+private:
+// Attributes
+    GLint _x;
+    GLint _y;
+    GLsizei _width;
+    GLsizei _height;
+    GLfloat _s0;
+    GLfloat _t0;
+    GLfloat _s1;
+    GLfloat _t1;
+// Friends
+    friend class AtlasBuilder;
+};
+
+} /* namespace Glycerin */
+#endif
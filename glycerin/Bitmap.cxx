@@ -18,9 +18,13 @@
 #include "config.h"
 #include "glycerin/common.h"
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 #include <stdexcept>
 #include <gloop/TextureTarget.hxx>
 #include "glycerin/Bitmap.hxx"
+#include "glycerin/MappedFile.hxx"
+#include "glycerin/StateCache.hxx"
 using namespace std;
 namespace Glycerin {
 
@@ -28,6 +32,7 @@ namespace Glycerin {
  * Constructs an empty bitmap image.
  */
 Bitmap::Bitmap() {
+    this->storage = NULL;
     this->pixels = NULL;
     this->format = DEFAULT_FORMAT;
     this->width = 0;
@@ -37,33 +42,20 @@ Bitmap::Bitmap() {
 }
 
 /**
- * Constructs a bitmap by copying another bitmap.
+ * Constructs a bitmap sharing the pixels of another bitmap.
  *
  * @param bitmap Bitmap to copy
  */
 Bitmap::Bitmap(const Bitmap& bitmap) {
+    this->storage = NULL;
     (*this) = bitmap;
 }
 
 /**
- * Destroys the bitmap image.
+ * Destroys the bitmap image, freeing its pixels if no other bitmap shares them.
  */
 Bitmap::~Bitmap() {
-    if (pixels != NULL) {
-        delete[] pixels;
-    }
-}
-
-/**
- * Copies the pixels of a bitmap.
- *
- * @param bitmap Bitmap to copy pixels of
- * @return Pointer to a newly-allocated array containing the same pixels as the bitmap
- */
-GLubyte* Bitmap::copyPixels(const Bitmap& bitmap) {
-    GLubyte* const copy = new GLubyte[bitmap.size];
-    memcpy(copy, bitmap.pixels, bitmap.size);
-    return copy;
+    release();
 }
 
 /**
@@ -91,16 +83,17 @@ Gloop::TextureObject Bitmap::createTexture(const bool mipmaps) const {
 
     // Bind texture
     const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
-    target.bind(texture);
+    StateCache::current().bindTexture(GL_TEXTURE_2D, texture.id());
 
     // Store unpack alignment
     const GLenum lastAlignment = getUnpackAlignment();
 
-    // Load texture data
+    // Load texture data, keeping alpha if there is any
+    const GLint internalFormat = getInternalFormat(format);
     setUnpackAlignment(alignment);
     target.texImage2d(
                 0,                // level
-                GL_RGB,           // internal format
+                internalFormat,   // internal format
                 width,            // width
                 height,           // height
                 format,           // format
@@ -129,14 +122,24 @@ GLint Bitmap::getAlignment() const {
 }
 
 /**
- * Returns the format of the image, either `GL_RGB` or `GL_RGBA`.
+ * Returns the format of the image, either `GL_BGR`, `GL_BGRA`, `GL_RGB`, or `GL_RGBA`.
  *
- * @return Format of the image, either `GL_RGB` or `GL_RGBA`
+ * @return Format of the image, either `GL_BGR`, `GL_BGRA`, `GL_RGB`, or `GL_RGBA`
  */
 GLenum Bitmap::getFormat() const {
     return format;
 }
 
+/**
+ * Determines the internal format a texture should use for pixels in a format.
+ *
+ * @param format Format of the pixels
+ * @return `GL_RGBA` if the format has alpha, otherwise `GL_RGB`
+ */
+GLint Bitmap::getInternalFormat(const GLenum format) {
+    return (sizeOf(format) == 4) ? GL_RGBA : GL_RGB;
+}
+
 /**
  * Returns the size of the image in the Y direction.
  *
@@ -176,15 +179,13 @@ GLsizei Bitmap::getSize() const {
 }
 
 /**
- * Returns the current value of `GL_UNPACK_ALIGNMENT`.
+ * Returns the current value of `GL_UNPACK_ALIGNMENT`, from the state cache when it is known.
  *
  * @return Current value of `GL_UNPACK_ALIGNMENT`
  * @see http://www.opengl.org/sdk/docs/man3/xhtml/glGet.xml
  */
 GLenum Bitmap::getUnpackAlignment() {
-    GLint value;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &value);
-    return (GLenum) value;
+    return (GLenum) StateCache::current().pixelStore(GL_UNPACK_ALIGNMENT);
 }
 
 /**
@@ -216,18 +217,46 @@ bool Bitmap::isUnpackAlignment(const GLenum enumeration) {
 }
 
 /**
- * Changes this bitmap to be a copy of another bitmap.
+ * Changes this bitmap to share the pixels of another bitmap.
  *
  * @param bitmap Bitmap to copy
  * @return Reference to this bitmap to support chaining
  */
 Bitmap& Bitmap::operator=(const Bitmap& bitmap) {
-    this->pixels = copyPixels(bitmap);
+
+    // Take a reference before releasing ours in case they are the same
+    Storage* const storage = bitmap.storage;
+    GLubyte* const pixels = bitmap.pixels;
+    if (storage != NULL) {
+        __sync_add_and_fetch(&storage->references, 1);
+    }
+    release();
+
+    // Copy everything
+    this->storage = storage;
+    this->pixels = pixels;
     this->format = bitmap.format;
     this->width = bitmap.width;
     this->height = bitmap.height;
     this->size = bitmap.size;
     this->alignment = bitmap.alignment;
+    return (*this);
+}
+
+/**
+ * Gives up this bitmap's reference to its pixels, freeing them if it was the last one.
+ */
+void Bitmap::release() {
+    if ((storage != NULL) && (__sync_sub_and_fetch(&storage->references, 1) == 0)) {
+        if (storage->mapping != NULL) {
+            delete storage->mapping;
+        } else {
+            delete[] storage->pixels;
+        }
+        delete storage;
+    }
+    storage = NULL;
+    pixels = NULL;
 }
 
 /**
@@ -237,7 +266,48 @@ Bitmap& Bitmap::operator=(const Bitmap& bitmap) {
  */
 void Bitmap::setUnpackAlignment(const GLenum alignment) {
     assert (isUnpackAlignment(alignment));
-    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    StateCache::current().pixelStore(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+/**
+ * Hands pixels to this bitmap, which becomes their only owner.
+ *
+ * @param pixels Pixels allocated with `new`, or pointing inside `mapping`
+ * @param mapping Mapped file containing the pixels, or `NULL` if they were allocated with `new`
+ */
+void Bitmap::setPixels(GLubyte* const pixels, MappedFile* const mapping) {
+    release();
+    Storage* const storage = new Storage();
+    storage->pixels = pixels;
+    storage->mapping = mapping;
+    storage->references = 1;
+    this->storage = storage;
+    this->pixels = pixels;
+}
+
+/**
+ * Determines the size of a pixel in bytes.
+ *
+ * @param format Format of the pixel, i.e. `GL_BGR`, `GL_BGRA`, `GL_RGB`, or `GL_RGBA`
+ * @return Number of bytes needed to store one pixel in the format
+ */
+GLsizei Bitmap::sizeOf(const GLenum format) {
+    return ((format == GL_BGRA) || (format == GL_RGBA)) ? 4 : 3;
+}
+
+/**
+ * Exchanges the contents of this bitmap with another bitmap.
+ *
+ * @param bitmap Bitmap to exchange contents with
+ */
+void Bitmap::swap(Bitmap& bitmap) {
+    std::swap(storage, bitmap.storage);
+    std::swap(pixels, bitmap.pixels);
+    std::swap(format, bitmap.format);
+    std::swap(width, bitmap.width);
+    std::swap(height, bitmap.height);
+    std::swap(size, bitmap.size);
+    std::swap(alignment, bitmap.alignment);
 }
 
 } /* namespace Glycerin */
@@ -22,6 +22,8 @@
 #include <gloop/TextureObject.hxx>
 namespace Glycerin {
 
+class MappedFile;
+
 
 /**
  * Bitmap image.
@@ -73,6 +75,11 @@ namespace Glycerin {
  * glGenerateMipmap(GL_TEXTURE_2D);
  * ~~~
  *
+ * Copying or assigning a _Bitmap_ is cheap.  Pixels are never changed once a
+ * bitmap has been made, so copies simply share them, and they are freed when
+ * the last bitmap using them is destroyed.  Use [swap] to exchange the
+ * contents of two bitmaps without touching the reference counts at all.
+ *
  * [get-alignment]: @ref getAlignment() const "getAlignment()"
  * [get-format]: @ref getFormat() const "getFormat()"
  * [get-height]: @ref getHeight() const "getHeight()"
@@ -83,10 +90,22 @@ namespace Glycerin {
  * [glPixelStore]: http://www.opengl.org/sdk/docs/man3/xhtml/glPixelStore.xml
  * [glTexImage2D]: http://www.opengl.org/sdk/docs/man3/xhtml/glTexImage2D.xml
  * [read]: @ref BitmapReader::read(const std::string&) "BitmapReader::read(const std::string&)"
+ * [swap]: @ref swap(Bitmap&) "swap(Bitmap&)"
  */
 class Bitmap {
 // Friends
+    friend class AtlasBuilder;
+    friend class BitmapCompressor;
+    friend class BitmapConverter;
+    friend class BitmapGenerator;
+    friend class BitmapLoader;
     friend class BitmapReader;
+    friend class BitmapResizer;
+    friend class BitmapWriter;
+    friend class DistanceFieldGenerator;
+    friend class DynamicTexture;
+    friend class FrameCapture;
+    friend class MipmapGenerator;
 public:
 // Methods
     Bitmap(const Bitmap& bitmap);
@@ -99,11 +118,19 @@ public:
     void getPixels(GLubyte* arr, GLsizei size) const;
     GLsizei getSize() const;
     Bitmap& operator=(const Bitmap& bitmap);
+    void swap(Bitmap& bitmap);
 private:
+// Types
+    struct Storage {
+        GLubyte* pixels;
+        MappedFile* mapping;
+        int references;
+    };
 // Constants
     static const GLenum DEFAULT_FORMAT = GL_BGR;
     static const GLint DEFAULT_ALIGNMENT = 4;
 // Attributes
+    Storage* storage;
     GLubyte* pixels;
     GLenum format;
     GLsizei width, height;
@@ -111,10 +138,13 @@ private:
     GLint alignment;
 // Methods
     Bitmap();
-    static GLubyte* copyPixels(const Bitmap& bitmap);
+    void release();
+    void setPixels(GLubyte* pixels, MappedFile* mapping);
+    static GLint getInternalFormat(GLenum format);
     static GLenum getUnpackAlignment();
     static bool isUnpackAlignment(GLenum enumeration);
     static void setUnpackAlignment(GLenum unpackAlignment);
+    static GLsizei sizeOf(GLenum format);
 };
 
 } /* namespace Glycerin */
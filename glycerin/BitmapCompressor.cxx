@@ -0,0 +1,440 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "glycerin/BitmapCompressor.hxx"
+#include "glycerin/MappedFile.hxx"
+#include "glycerin/Parallel.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * First bytes of a file made by [compressCached](@ref BitmapCompressor::compressCached).
+ */
+const char BitmapCompressor::MAGIC[8] = { 'G', 'L', 'Y', 'C', 'B', 'C', '0', '1' };
+
+/**
+ * Encodes a range of rows of blocks.
+ */
+class BitmapCompressor::BlockTask : public Parallel::Task {
+public:
+    BlockTask(const Bitmap& bitmap, Format format, int channel, CompressedBitmap& compressed) :
+            bitmap(bitmap), format(format), channel(channel), compressed(compressed) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Bitmap& bitmap;
+    const Format format;
+    const int channel;
+    CompressedBitmap& compressed;
+};
+
+/**
+ * Constructs a bitmap compressor with default settings.
+ */
+BitmapCompressor::BitmapCompressor() :
+        _channel(GL_RED),
+        _format(BC1) {
+    // empty
+}
+
+/**
+ * Destroys the bitmap compressor.
+ */
+BitmapCompressor::~BitmapCompressor() {
+    // empty
+}
+
+/**
+ * Changes which component of the bitmap is kept when compressing to [BC4](@ref BC4).
+ *
+ * @param channel Either `GL_RED`, `GL_GREEN`, `GL_BLUE`, or `GL_ALPHA`
+ * @return Reference to this compressor to support chaining
+ * @throws invalid_argument if channel is not one of the supported components
+ */
+BitmapCompressor& BitmapCompressor::channel(const GLenum channel) {
+    switch (channel) {
+    case GL_RED:
+    case GL_GREEN:
+    case GL_BLUE:
+    case GL_ALPHA:
+        _channel = channel;
+        return (*this);
+    default:
+        throw invalid_argument("[BitmapCompressor] Channel must be GL_RED, GL_GREEN, GL_BLUE, or GL_ALPHA!");
+    }
+}
+
+/**
+ * Compresses a bitmap using the current settings.
+ *
+ * Partial blocks at the right and top edges are filled by repeating the last
+ * column and row.  Compressing to [BC4](@ref BC4) from `GL_ALPHA` of a
+ * bitmap without alpha gives an opaque image.
+ *
+ * @param bitmap Bitmap to compress
+ * @return Compressed copy of the bitmap
+ * @throws invalid_argument if the bitmap is empty
+ */
+CompressedBitmap BitmapCompressor::compress(const Bitmap& bitmap) const {
+
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[BitmapCompressor] Bitmap is empty!");
+    }
+
+    // Find the channel in the bitmap's layout
+    const bool redFirst = (bitmap.format == GL_RGB) || (bitmap.format == GL_RGBA);
+    int channel;
+    switch (_channel) {
+    case GL_RED:
+        channel = redFirst ? 0 : 2;
+        break;
+    case GL_GREEN:
+        channel = 1;
+        break;
+    case GL_BLUE:
+        channel = redFirst ? 2 : 0;
+        break;
+    default:
+        channel = (Bitmap::sizeOf(bitmap.format) == 4) ? 3 : -1;
+        break;
+    }
+
+    // Encode every row of blocks
+    CompressedBitmap compressed(getCompressedFormat(), bitmap.width, bitmap.height);
+    BlockTask task(bitmap, _format, channel, compressed);
+    Parallel::forEach((bitmap.height + 3) / 4, task, 4);
+    return compressed;
+}
+
+/**
+ * Loads a compressed bitmap from a file, or compresses it and saves it if the file is not usable.
+ *
+ * The file records a checksum of the bitmap's pixels along with the settings
+ * used, so changing either makes the bitmap be compressed again.
+ *
+ * @param bitmap Bitmap to compress
+ * @param filename Path to the file to keep the compressed bitmap in
+ * @return Compressed copy of the bitmap
+ * @throws invalid_argument if the bitmap is empty
+ * @throws runtime_error if the bitmap needed to be compressed but could not be written
+ */
+CompressedBitmap BitmapCompressor::compressCached(const Bitmap& bitmap, const string& filename) const {
+
+    // Try to load it from the file
+    const GLenum format = getCompressedFormat();
+    const GLuint checksum = computeChecksum(bitmap) ^ _channel;
+    CompressedBitmap compressed(format, bitmap.width, bitmap.height);
+    try {
+        const MappedFile file(filename);
+        const GLubyte* const bytes = file.data();
+        if ((file.size() == HEADER_SIZE + compressed._data.size())
+                && (memcmp(bytes, MAGIC, sizeof(MAGIC)) == 0)
+                && (readInt(bytes + 8) == format)
+                && (readInt(bytes + 12) == (GLuint) bitmap.width)
+                && (readInt(bytes + 16) == (GLuint) bitmap.height)
+                && (readInt(bytes + 20) == checksum)) {
+            copy(bytes + HEADER_SIZE, bytes + file.size(), compressed._data.begin());
+            return compressed;
+        }
+    } catch (exception&) {
+        // Missing or unreadable, so compress it instead
+    }
+
+    // Compress it and save it for next time
+    compressed = compress(bitmap);
+    ofstream file(filename.c_str(), ios_base::binary);
+    if (!file) {
+        throw runtime_error("[BitmapCompressor] File could not be opened!");
+    }
+    file.write(MAGIC, sizeof(MAGIC));
+    writeInt(file, format);
+    writeInt(file, bitmap.width);
+    writeInt(file, bitmap.height);
+    writeInt(file, checksum);
+    file.write((const char*) compressed.data(), compressed.size());
+    if (!file) {
+        throw runtime_error("[BitmapCompressor] All blocks could not be written!");
+    }
+    return compressed;
+}
+
+/**
+ * Computes a checksum of a bitmap's size, format and pixels.
+ *
+ * @param bitmap Bitmap to compute the checksum of
+ * @return FNV-1a hash of the bitmap
+ */
+GLuint BitmapCompressor::computeChecksum(const Bitmap& bitmap) {
+    GLuint hash = 2166136261u;
+    const GLuint fields[] = { bitmap.format, (GLuint) bitmap.width, (GLuint) bitmap.height };
+    const GLubyte* const header = (const GLubyte*) fields;
+    for (size_t i = 0; i < sizeof(fields); ++i) {
+        hash = (hash ^ header[i]) * 16777619u;
+    }
+    for (GLsizei i = 0; i < bitmap.size; ++i) {
+        hash = (hash ^ bitmap.pixels[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Encodes one block of pixels as BC1.
+ *
+ * Endpoints are the two pixels furthest apart along the principal axis of
+ * the block's colors, found with a few rounds of power iteration.  The block
+ * always uses the four-color mode, so it never has transparent pixels.
+ *
+ * @param rgb Sixteen pixels in rows of four, as red, green and blue components
+ * @param block Storage for the eight bytes of the encoded block
+ */
+void BitmapCompressor::encodeBc1(const GLubyte* rgb, GLubyte* block) {
+
+    // Find the covariance of the colors
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            mean[c] += rgb[i * 3 + c];
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        mean[c] /= 16;
+    }
+    float covariance[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+    for (int i = 0; i < 16; ++i) {
+        const float d[3] = { rgb[i * 3] - mean[0], rgb[i * 3 + 1] - mean[1], rgb[i * 3 + 2] - mean[2] };
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                covariance[r][c] += d[r] * d[c];
+            }
+        }
+    }
+
+    // Approximate its largest eigenvector, starting from the row with the most variance
+    int start = 0;
+    for (int r = 1; r < 3; ++r) {
+        if (covariance[r][r] > covariance[start][start]) {
+            start = r;
+        }
+    }
+    float axis[3] = { covariance[start][0], covariance[start][1], covariance[start][2] };
+    for (int k = 0; k < 4; ++k) {
+        float next[3];
+        for (int r = 0; r < 3; ++r) {
+            next[r] = covariance[r][0] * axis[0] + covariance[r][1] * axis[1] + covariance[r][2] * axis[2];
+        }
+        const float length = max(fabsf(next[0]), max(fabsf(next[1]), fabsf(next[2])));
+        if (length == 0) {
+            break;
+        }
+        for (int c = 0; c < 3; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    // Pick the pixels at either end of it
+    int lo = 0, hi = 0;
+    float loDot = 1e30f, hiDot = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        const float dot = rgb[i * 3] * axis[0] + rgb[i * 3 + 1] * axis[1] + rgb[i * 3 + 2] * axis[2];
+        if (dot < loDot) {
+            loDot = dot;
+            lo = i;
+        }
+        if (dot > hiDot) {
+            hiDot = dot;
+            hi = i;
+        }
+    }
+
+    // Quantize them, keeping the first larger for the four-color mode
+    GLushort endpoints[2];
+    const GLubyte* const ends[2] = { rgb + hi * 3, rgb + lo * 3 };
+    for (int e = 0; e < 2; ++e) {
+        const GLushort r = (ends[e][0] * 31 + 127) / 255;
+        const GLushort g = (ends[e][1] * 63 + 127) / 255;
+        const GLushort b = (ends[e][2] * 31 + 127) / 255;
+        endpoints[e] = (r << 11) | (g << 5) | b;
+    }
+    if (endpoints[0] < endpoints[1]) {
+        swap(endpoints[0], endpoints[1]);
+    }
+
+    // Build the palette the decoder will see
+    int palette[4][3];
+    for (int e = 0; e < 2; ++e) {
+        const int r = endpoints[e] >> 11;
+        const int g = (endpoints[e] >> 5) & 0x3f;
+        const int b = endpoints[e] & 0x1f;
+        palette[e][0] = (r << 3) | (r >> 2);
+        palette[e][1] = (g << 2) | (g >> 4);
+        palette[e][2] = (b << 3) | (b >> 2);
+    }
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    // Choose the closest palette entry for each pixel
+    GLuint indices = 0;
+    if (endpoints[0] != endpoints[1]) {
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            int bestDistance = 0x7fffffff;
+            for (int j = 0; j < 4; ++j) {
+                int distance = 0;
+                for (int c = 0; c < 3; ++c) {
+                    const int d = rgb[i * 3 + c] - palette[j][c];
+                    distance += d * d;
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = j;
+                }
+            }
+            indices |= ((GLuint) best) << (i * 2);
+        }
+    }
+
+    // Store it all in little-endian order
+    block[0] = endpoints[0] & 0xff;
+    block[1] = endpoints[0] >> 8;
+    block[2] = endpoints[1] & 0xff;
+    block[3] = endpoints[1] >> 8;
+    for (int i = 0; i < 4; ++i) {
+        block[4 + i] = (indices >> (i * 8)) & 0xff;
+    }
+}
+
+/**
+ * Encodes one block of values as BC4.
+ *
+ * The block always uses the eight-value mode, with the largest value first.
+ *
+ * @param values Sixteen values in rows of four
+ * @param block Storage for the eight bytes of the encoded block
+ */
+void BitmapCompressor::encodeBc4(const GLubyte* values, GLubyte* block) {
+
+    // Use the range of the values as the endpoints
+    const int lo = *min_element(values, values + 16);
+    const int hi = *max_element(values, values + 16);
+    block[0] = hi;
+    block[1] = lo;
+
+    // Pick the nearest of the eight steps for each value
+    GLuint64 indices = 0;
+    if (hi > lo) {
+        const int range = hi - lo;
+        for (int i = 0; i < 16; ++i) {
+            const int step = ((values[i] - lo) * 14 + range) / (2 * range);
+            const GLuint64 code = (step == 7) ? 0 : ((step == 0) ? 1 : (8 - step));
+            indices |= code << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        block[2 + i] = (indices >> (i * 8)) & 0xff;
+    }
+}
+
+/**
+ * Changes the format bitmaps are compressed to.
+ *
+ * @param format Either [BC1](@ref BC1) or [BC4](@ref BC4)
+ * @return Reference to this compressor to support chaining
+ */
+BitmapCompressor& BitmapCompressor::format(const Format format) {
+    _format = format;
+    return (*this);
+}
+
+/**
+ * Determines the OpenGL format for the current settings.
+ *
+ * @return Either `GL_COMPRESSED_RGB_S3TC_DXT1_EXT` or `GL_COMPRESSED_RED_RGTC1`
+ */
+GLenum BitmapCompressor::getCompressedFormat() const {
+    return (_format == BC4) ? GL_COMPRESSED_RED_RGTC1 : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+/**
+ * Reads a four-byte value in little-endian order.
+ *
+ * @param bytes Location of the value
+ * @return Value at the location
+ */
+GLuint BitmapCompressor::readInt(const GLubyte* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (((GLuint) bytes[3]) << 24);
+}
+
+/**
+ * Writes a four-byte value in little-endian order.
+ *
+ * @param stream Stream to write to
+ * @param value Value to write
+ */
+void BitmapCompressor::writeInt(ostream& stream, const GLuint value) {
+    const char bytes[] = {
+            (char) (value & 0xff),
+            (char) ((value >> 8) & 0xff),
+            (char) ((value >> 16) & 0xff),
+            (char) (value >> 24) };
+    stream.write(bytes, 4);
+}
+
+// HELPERS
+
+void BitmapCompressor::BlockTask::run(const size_t begin, const size_t end) {
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    const size_t stride = ((bitmap.width * bytesPerPixel + (bitmap.alignment - 1)) / bitmap.alignment) * bitmap.alignment;
+    const bool redFirst = (bitmap.format == GL_RGB) || (bitmap.format == GL_RGBA);
+    const GLsizei blocksPerRow = (bitmap.width + 3) / 4;
+    GLubyte pixels[16 * 3];
+    for (size_t by = begin; by < end; ++by) {
+        GLubyte* block = &compressed._data[by * blocksPerRow * 8];
+        for (GLsizei bx = 0; bx < blocksPerRow; ++bx) {
+
+            // Gather the pixels, repeating the edges
+            for (int i = 0; i < 16; ++i) {
+                const size_t y = min(by * 4 + i / 4, (size_t) bitmap.height - 1);
+                const size_t x = min(bx * 4 + i % 4, bitmap.width - 1);
+                const GLubyte* const pixel = bitmap.pixels + y * stride + x * bytesPerPixel;
+                if (format == BC4) {
+                    pixels[i] = (channel < 0) ? 255 : pixel[channel];
+                } else {
+                    pixels[i * 3 + 0] = pixel[redFirst ? 0 : 2];
+                    pixels[i * 3 + 1] = pixel[1];
+                    pixels[i * 3 + 2] = pixel[redFirst ? 2 : 0];
+                }
+            }
+
+            // Encode them
+            if (format == BC4) {
+                encodeBc4(pixels, block);
+            } else {
+                encodeBc1(pixels, block);
+            }
+            block += 8;
+        }
+    }
+}
+
+} /* namespace Glycerin */
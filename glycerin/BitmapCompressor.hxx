@@ -0,0 +1,85 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPCOMPRESSOR_HXX
+#define GLYCERIN_BITMAPCOMPRESSOR_HXX
+#include "glycerin/common.h"
+#include <ostream>
+#include <string>
+#include "glycerin/Bitmap.hxx"
+#include "glycerin/CompressedBitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for block-compressing bitmaps.
+ *
+ * Uncompressed textures take four to eight times the memory and bandwidth of
+ * block-compressed ones.  _BitmapCompressor_ encodes a bitmap into blocks of
+ * four by four pixels on the CPU, spreading rows of blocks across threads.
+ *
+ * ~~~
+ * BitmapCompressor compressor;
+ * const CompressedBitmap compressed = compressor.format(BitmapCompressor::BC1).compress(bitmap);
+ * ~~~
+ *
+ * [BC1](@ref BC1), the default, keeps the color components and drops alpha.
+ * [BC4](@ref BC4) keeps just one component, chosen with [channel], which
+ * suits masks and glyphs.  Endpoints are found along the principal axis of
+ * each block's colors, which is fast and close to what slower searching
+ * encoders produce.
+ *
+ * Since encoding takes much longer than reading, [compress-cached] keeps the
+ * result in a file and reuses it as long as the bitmap has not changed.
+ *
+ * [channel]: @ref channel(GLenum) "channel(GLenum)"
+ * [compress-cached]: @ref compressCached(const Bitmap&, const std::string&) const "compressCached(const Bitmap&, const std::string&)"
+ */
+class BitmapCompressor {
+public:
+// Types
+    enum Format {
+        BC1,
+        BC4
+    };
+// Methods
+    BitmapCompressor();
+    virtual ~BitmapCompressor();
+    BitmapCompressor& channel(GLenum channel);
+    CompressedBitmap compress(const Bitmap& bitmap) const;
+    CompressedBitmap compressCached(const Bitmap& bitmap, const std::string& filename) const;
+    BitmapCompressor& format(Format format);
+    static void encodeBc1(const GLubyte* rgb, GLubyte* block);
+    static void encodeBc4(const GLubyte* values, GLubyte* block);
+private:
+// Types
+    class BlockTask;
+// Constants
+    static const char MAGIC[8];
+    static const size_t HEADER_SIZE = 24;
+// Attributes
+    GLenum _channel;
+    Format _format;
+// Methods
+    static GLuint computeChecksum(const Bitmap& bitmap);
+    GLenum getCompressedFormat() const;
+    static GLuint readInt(const GLubyte* bytes);
+    static void writeInt(std::ostream& stream, GLuint value);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapCompressor.hxx"
+#include "glycerin/BitmapGenerator.hxx"
+
+
+/**
+ * Unit test for `BitmapCompressor`.
+ */
+class BitmapCompressorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Name of the file used for caching.
+     */
+    static const char* FILENAME;
+
+    /**
+     * Decodes a BC1 block into sixteen red, green and blue pixels.
+     */
+    static void decodeBc1(const GLubyte* block, int* rgb) {
+        int palette[4][3];
+        for (int e = 0; e < 2; ++e) {
+            const int value = block[e * 2] | (block[e * 2 + 1] << 8);
+            palette[e][0] = ((value >> 11) << 3) | (value >> 13);
+            palette[e][1] = (((value >> 5) & 0x3f) << 2) | ((value >> 9) & 0x3);
+            palette[e][2] = ((value & 0x1f) << 3) | ((value >> 2) & 0x7);
+        }
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int index = (block[4 + i / 4] >> ((i % 4) * 2)) & 0x3;
+            for (int c = 0; c < 3; ++c) {
+                rgb[i * 3 + c] = palette[index][c];
+            }
+        }
+    }
+
+    /**
+     * Decodes a BC4 block into sixteen values.
+     */
+    static void decodeBc4(const GLubyte* block, int* values) {
+        const int r0 = block[0];
+        const int r1 = block[1];
+        unsigned long long bits = 0;
+        for (int i = 0; i < 6; ++i) {
+            bits |= ((unsigned long long) block[2 + i]) << (i * 8);
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int code = (bits >> (i * 3)) & 0x7;
+            values[i] = (code == 0) ? r0 : ((code == 1) ? r1 : (((8 - code) * r0 + (code - 1) * r1) / 7));
+        }
+    }
+
+    /**
+     * Ensures `BitmapCompressor::encodeBc1` reproduces a block of one color exactly.
+     */
+    void testEncodeBc1WithSolidBlock() {
+        GLubyte rgb[48];
+        for (int i = 0; i < 16; ++i) {
+            rgb[i * 3 + 0] = 255;
+            rgb[i * 3 + 1] = 0;
+            rgb[i * 3 + 2] = 132;
+        }
+        GLubyte block[8];
+        Glycerin::BitmapCompressor::encodeBc1(rgb, block);
+        int decoded[48];
+        decodeBc1(block, decoded);
+        for (int i = 0; i < 16; ++i) {
+            CPPUNIT_ASSERT_EQUAL(255, decoded[i * 3 + 0]);
+            CPPUNIT_ASSERT_EQUAL(0, decoded[i * 3 + 1]);
+            CPPUNIT_ASSERT(abs(decoded[i * 3 + 2] - 132) <= 4);
+        }
+    }
+
+    /**
+     * Ensures `BitmapCompressor::encodeBc1` keeps a gradient within half a palette step.
+     */
+    void testEncodeBc1WithGradient() {
+        GLubyte rgb[48];
+        for (int i = 0; i < 16; ++i) {
+            rgb[i * 3 + 0] = i * 16;
+            rgb[i * 3 + 1] = 255 - i * 16;
+            rgb[i * 3 + 2] = 64;
+        }
+        GLubyte block[8];
+        Glycerin::BitmapCompressor::encodeBc1(rgb, block);
+        CPPUNIT_ASSERT((block[0] | (block[1] << 8)) > (block[2] | (block[3] << 8)));
+        int decoded[48];
+        decodeBc1(block, decoded);
+        for (int i = 0; i < 48; ++i) {
+            CPPUNIT_ASSERT(abs(decoded[i] - rgb[i]) <= 42);
+        }
+    }
+
+    /**
+     * Ensures `BitmapCompressor::encodeBc4` keeps every value within half a step.
+     */
+    void testEncodeBc4() {
+        GLubyte values[16];
+        for (int i = 0; i < 16; ++i) {
+            values[i] = 20 + (i * 37) % 141;
+        }
+        GLubyte block[8];
+        Glycerin::BitmapCompressor::encodeBc4(values, block);
+        int decoded[16];
+        decodeBc4(block, decoded);
+        for (int i = 0; i < 16; ++i) {
+            CPPUNIT_ASSERT(abs(decoded[i] - values[i]) <= 11);
+        }
+    }
+
+    /**
+     * Ensures `BitmapCompressor::compress` makes one block per four by four pixels, rounding up.
+     */
+    void testCompress() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(13, 6).generate();
+        Glycerin::BitmapCompressor compressor;
+        const Glycerin::CompressedBitmap bc1 = compressor.compress(bitmap);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_COMPRESSED_RGB_S3TC_DXT1_EXT, bc1.format());
+        CPPUNIT_ASSERT_EQUAL(13, bc1.width());
+        CPPUNIT_ASSERT_EQUAL(6, bc1.height());
+        CPPUNIT_ASSERT_EQUAL(4 * 2 * 8, bc1.size());
+        const Glycerin::CompressedBitmap bc4 = compressor.format(Glycerin::BitmapCompressor::BC4).compress(bitmap);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_COMPRESSED_RED_RGTC1, bc4.format());
+        CPPUNIT_ASSERT_EQUAL(4 * 2 * 8, bc4.size());
+    }
+
+    /**
+     * Ensures `BitmapCompressor::compressCached` writes the file once and then reads it back.
+     */
+    void testCompressCached() {
+
+        // Compress and save
+        remove(FILENAME);
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(32, 16).seed(9).generate();
+        Glycerin::BitmapCompressor compressor;
+        const Glycerin::CompressedBitmap first = compressor.compressCached(bitmap, FILENAME);
+        FILE* const file = fopen(FILENAME, "rb");
+        CPPUNIT_ASSERT(file != NULL);
+        fclose(file);
+
+        // Load it again
+        const Glycerin::CompressedBitmap second = compressor.compressCached(bitmap, FILENAME);
+        CPPUNIT_ASSERT_EQUAL(first.size(), second.size());
+        for (GLsizei i = 0; i < first.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL((int) first.data()[i], (int) second.data()[i]);
+        }
+
+        // Change the settings so the file is replaced
+        compressor.format(Glycerin::BitmapCompressor::BC4);
+        const Glycerin::CompressedBitmap third = compressor.compressCached(bitmap, FILENAME);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_COMPRESSED_RED_RGTC1, third.format());
+        remove(FILENAME);
+    }
+
+    /**
+     * Ensures `BitmapCompressor` rejects unsupported input.
+     */
+    void testInvalidInput() {
+        Glycerin::BitmapCompressor compressor;
+        CPPUNIT_ASSERT_THROW(compressor.channel(GL_RGB), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapCompressorTest);
+    CPPUNIT_TEST(testEncodeBc1WithSolidBlock);
+    CPPUNIT_TEST(testEncodeBc1WithGradient);
+    CPPUNIT_TEST(testEncodeBc4);
+    CPPUNIT_TEST(testCompress);
+    CPPUNIT_TEST(testCompressCached);
+    CPPUNIT_TEST(testInvalidInput);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+const char* BitmapCompressorTest::FILENAME = "BitmapCompressorTest.bc";
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapCompressorTest::suite());
+    runner.run();
+    return 0;
+}
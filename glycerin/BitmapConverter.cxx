@@ -0,0 +1,465 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "glycerin/BitmapConverter.hxx"
+#include "glycerin/Parallel.hxx"
+using namespace std;
+namespace Glycerin {
+
+// Fills the conversion tables only once, even when several threads convert at the same time
+static pthread_once_t tablesOnce = PTHREAD_ONCE_INIT;
+
+// Table converting 8-bit sRGB values to 8-bit linear values
+static GLubyte toLinearTable[256];
+
+// Table converting 8-bit linear values to 8-bit sRGB values
+static GLubyte toSrgbTable[256];
+
+/**
+ * Fills the conversion tables.
+ */
+static void createTables() {
+    for (int i = 0; i < 256; ++i) {
+        const double c = i / 255.0;
+        const double l = (c <= 0.04045) ? (c / 12.92) : pow((c + 0.055) / 1.055, 2.4);
+        toLinearTable[i] = (GLubyte) (l * 255 + 0.5);
+    }
+    for (int i = 0; i < 256; ++i) {
+        const double l = i / 255.0;
+        const double c = (l <= 0.0031308) ? (l * 12.92) : (1.055 * pow(l, 1 / 2.4) - 0.055);
+        toSrgbTable[i] = (GLubyte) (c * 255 + 0.5);
+    }
+}
+
+/**
+ * Converts a range of rows of a bitmap into another bitmap.
+ */
+class BitmapConverter::RowTask : public Parallel::Task {
+public:
+    RowTask(const BitmapConverter& converter, const Bitmap& src, Bitmap& dst) :
+            converter(converter), src(src), dst(dst) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const BitmapConverter& converter;
+    const Bitmap& src;
+    Bitmap& dst;
+};
+
+/**
+ * Constructs a bitmap converter with default settings.
+ */
+BitmapConverter::BitmapConverter() :
+        _alignment(4),
+        _format(GL_BGRA),
+        _linear(false),
+        _premultiply(false) {
+    // empty
+}
+
+/**
+ * Destroys the bitmap converter.
+ */
+BitmapConverter::~BitmapConverter() {
+    // empty
+}
+
+/**
+ * Adds an opaque alpha component to pixels with three components.
+ *
+ * @param src Pixels with three components each
+ * @param count Number of pixels to convert
+ * @param swap `true` to also exchange the first and third components
+ * @param dst Storage for pixels with four components each, not overlapping _src_
+ */
+void BitmapConverter::addAlpha(const GLubyte* src, const size_t count, const bool swap, GLubyte* dst) {
+    size_t i = 0;
+#ifdef __SSSE3__
+    const __m128i mask = swap
+            ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+            : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+#ifdef __AVX2__
+    const __m256i wideMask = _mm256_inserti128_si256(_mm256_castsi128_si256(mask), mask, 1);
+    const __m256i wideAlpha = _mm256_set1_epi32(0xFF000000);
+    for (; i + 10 <= count; i += 8) {
+        const __m128i lo = _mm_loadu_si128((const __m128i*) (src + i * 3));
+        const __m128i hi = _mm_loadu_si128((const __m128i*) (src + i * 3 + 12));
+        const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256((__m256i*) (dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, wideMask), wideAlpha));
+    }
+#endif
+    for (; i + 6 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) (src + i * 3));
+        _mm_storeu_si128((__m128i*) (dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+    }
+#endif
+    const int r = swap ? 2 : 0;
+    for (; i < count; ++i) {
+        const GLubyte* const s = src + i * 3;
+        GLubyte* const d = dst + i * 4;
+        d[0] = s[r];
+        d[1] = s[1];
+        d[2] = s[2 - r];
+        d[3] = 255;
+    }
+}
+
+/**
+ * Changes the number of bytes each row of a converted bitmap is padded to.
+ *
+ * @param alignment Either 1, 2, 4, or 8, where 1 means rows are not padded
+ * @return Reference to this converter to support chaining
+ * @throws invalid_argument if alignment is not 1, 2, 4, or 8
+ */
+BitmapConverter& BitmapConverter::alignment(const GLint alignment) {
+    switch (alignment) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        _alignment = alignment;
+        return (*this);
+    default:
+        throw invalid_argument("[BitmapConverter] Alignment must be 1, 2, 4, or 8!");
+    }
+}
+
+/**
+ * Makes a copy of a bitmap using the current settings.
+ *
+ * @param bitmap Bitmap to copy
+ * @return Copy of the bitmap in the chosen format and alignment
+ * @throws invalid_argument if the bitmap is not in a format that can be converted
+ */
+Bitmap BitmapConverter::convert(const Bitmap& bitmap) const {
+
+    if (!isFormat(bitmap.format)) {
+        throw invalid_argument("[BitmapConverter] Bitmap is not in a supported format!");
+    }
+
+    // Make the new bitmap
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(_format);
+    const GLsizei stride = ((bitmap.width * bytesPerPixel + (_alignment - 1)) / _alignment) * _alignment;
+    Bitmap result;
+    result.setPixels(new GLubyte[((size_t) stride) * bitmap.height], NULL);
+    result.format = _format;
+    result.width = bitmap.width;
+    result.height = bitmap.height;
+    result.size = stride * bitmap.height;
+    result.alignment = _alignment;
+
+    // Fill it
+    RowTask task(*this, bitmap, result);
+    Parallel::forEach(bitmap.height, task, 16);
+    return result;
+}
+
+/**
+ * Converts one row of pixels.
+ *
+ * @param src Row to convert
+ * @param width Number of pixels in the row
+ * @param format Format of the row to convert
+ * @param dst Storage for the converted row
+ */
+void BitmapConverter::convertRow(const GLubyte* src, const GLsizei width, const GLenum format, GLubyte* dst) const {
+
+    // Rearrange the components
+    const GLsizei srcBytesPerPixel = Bitmap::sizeOf(format);
+    const GLsizei dstBytesPerPixel = Bitmap::sizeOf(_format);
+    const bool swap = (isRedFirst(format) != isRedFirst(_format));
+    if (srcBytesPerPixel < dstBytesPerPixel) {
+        addAlpha(src, width, swap, dst);
+    } else if (srcBytesPerPixel > dstBytesPerPixel) {
+        removeAlpha(src, width, swap, dst);
+    } else if (swap) {
+        swapRedBlue(src, width, srcBytesPerPixel, dst);
+    } else {
+        memcpy(dst, src, ((size_t) width) * srcBytesPerPixel);
+    }
+
+    // Change the values
+    if (_linear) {
+        toLinear(dst, width, dstBytesPerPixel);
+    }
+    if (_premultiply && (dstBytesPerPixel == 4)) {
+        premultiplyPixels(dst, width);
+    }
+}
+
+/**
+ * Changes the format of converted bitmaps.
+ *
+ * @param format Either `GL_BGR`, `GL_BGRA`, `GL_RGB`, or `GL_RGBA`
+ * @return Reference to this converter to support chaining
+ * @throws invalid_argument if format is not one of the supported formats
+ */
+BitmapConverter& BitmapConverter::format(const GLenum format) {
+    if (!isFormat(format)) {
+        throw invalid_argument("[BitmapConverter] Format must be GL_BGR, GL_BGRA, GL_RGB, or GL_RGBA!");
+    }
+    _format = format;
+    return (*this);
+}
+
+/**
+ * Returns a table converting 8-bit sRGB values to 8-bit linear values.
+ *
+ * @return Table of 256 linear values
+ */
+const GLubyte* BitmapConverter::getToLinearTable() {
+    pthread_once(&tablesOnce, &createTables);
+    return toLinearTable;
+}
+
+/**
+ * Returns a table converting 8-bit linear values to 8-bit sRGB values.
+ *
+ * @return Table of 256 sRGB values
+ */
+const GLubyte* BitmapConverter::getToSrgbTable() {
+    pthread_once(&tablesOnce, &createTables);
+    return toSrgbTable;
+}
+
+/**
+ * Checks if a format can be converted to and from.
+ *
+ * @param format Format to check
+ * @return `true` if format is `GL_BGR`, `GL_BGRA`, `GL_RGB`, or `GL_RGBA`
+ */
+bool BitmapConverter::isFormat(const GLenum format) {
+    switch (format) {
+    case GL_BGR:
+    case GL_BGRA:
+    case GL_RGB:
+    case GL_RGBA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Checks if a format stores the red component first.
+ *
+ * @param format Format to check
+ * @return `true` if format is `GL_RGB` or `GL_RGBA`
+ */
+bool BitmapConverter::isRedFirst(const GLenum format) {
+    return (format == GL_RGB) || (format == GL_RGBA);
+}
+
+/**
+ * Changes whether color components are converted from sRGB to linear values.
+ *
+ * @param linear `true` to convert color components to linear values, `false` to leave them alone
+ * @return Reference to this converter to support chaining
+ */
+BitmapConverter& BitmapConverter::linear(const bool linear) {
+    _linear = linear;
+    return (*this);
+}
+
+/**
+ * Changes whether color components of converted bitmaps are multiplied by alpha.
+ *
+ * Only has an effect when converting to a format with alpha.
+ *
+ * @param premultiply `true` to multiply color components by alpha, `false` to leave them alone
+ * @return Reference to this converter to support chaining
+ */
+BitmapConverter& BitmapConverter::premultiply(const bool premultiply) {
+    _premultiply = premultiply;
+    return (*this);
+}
+
+/**
+ * Multiplies the color components of pixels by their alpha, in place.
+ *
+ * Results are rounded to the nearest value, so opaque pixels are unchanged.
+ *
+ * @param pixels Pixels with four components each, alpha last
+ * @param count Number of pixels to change
+ */
+void BitmapConverter::premultiplyPixels(GLubyte* pixels, const size_t count) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colors = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+    const __m128i opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i half = _mm_set1_epi16(128);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) (pixels + i * 4));
+        __m128i halves[2];
+        halves[0] = _mm_unpacklo_epi8(v, zero);
+        halves[1] = _mm_unpackhi_epi8(v, zero);
+        for (int h = 0; h < 2; ++h) {
+            __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], 0xFF), 0xFF);
+            a = _mm_or_si128(_mm_and_si128(a, colors), opaque);
+            const __m128i t = _mm_add_epi16(_mm_mullo_epi16(halves[h], a), half);
+            halves[h] = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+        _mm_storeu_si128((__m128i*) (pixels + i * 4), _mm_packus_epi16(halves[0], halves[1]));
+    }
+#endif
+    for (; i < count; ++i) {
+        GLubyte* const p = pixels + i * 4;
+        for (int c = 0; c < 3; ++c) {
+            const unsigned int t = p[c] * p[3] + 128;
+            p[c] = (GLubyte) ((t + (t >> 8)) >> 8);
+        }
+    }
+}
+
+/**
+ * Drops the alpha component from pixels with four components.
+ *
+ * @param src Pixels with four components each
+ * @param count Number of pixels to convert
+ * @param swap `true` to also exchange the first and third components
+ * @param dst Storage for pixels with three components each, not overlapping _src_
+ */
+void BitmapConverter::removeAlpha(const GLubyte* src, const size_t count, const bool swap, GLubyte* dst) {
+    size_t i = 0;
+#ifdef __SSSE3__
+    const __m128i mask = swap
+            ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+            : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (; i + 6 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) (src + i * 4));
+        _mm_storeu_si128((__m128i*) (dst + i * 3), _mm_shuffle_epi8(v, mask));
+    }
+#endif
+    const int r = swap ? 2 : 0;
+    for (; i < count; ++i) {
+        const GLubyte* const s = src + i * 4;
+        GLubyte* const d = dst + i * 3;
+        d[0] = s[r];
+        d[1] = s[1];
+        d[2] = s[2 - r];
+    }
+}
+
+/**
+ * Exchanges the first and third components of pixels.
+ *
+ * @param src Pixels to convert
+ * @param count Number of pixels to convert
+ * @param bytesPerPixel Either 3 or 4
+ * @param dst Storage for converted pixels, which may be the same as _src_
+ */
+void BitmapConverter::swapRedBlue(const GLubyte* src, const size_t count, const int bytesPerPixel, GLubyte* dst) {
+    size_t i = 0;
+#ifdef __SSSE3__
+    if (bytesPerPixel == 4) {
+        const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+#ifdef __AVX2__
+        const __m256i wideMask = _mm256_inserti128_si256(_mm256_castsi128_si256(mask), mask, 1);
+        for (; i + 8 <= count; i += 8) {
+            const __m256i v = _mm256_loadu_si256((const __m256i*) (src + i * 4));
+            _mm256_storeu_si256((__m256i*) (dst + i * 4), _mm256_shuffle_epi8(v, wideMask));
+        }
+#endif
+        for (; i + 4 <= count; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i*) (src + i * 4));
+            _mm_storeu_si128((__m128i*) (dst + i * 4), _mm_shuffle_epi8(v, mask));
+        }
+    } else {
+        // Five pixels at a time, carrying the sixteenth byte through untouched
+        const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+        for (; i + 6 <= count; i += 5) {
+            const __m128i v = _mm_loadu_si128((const __m128i*) (src + i * 3));
+            _mm_storeu_si128((__m128i*) (dst + i * 3), _mm_shuffle_epi8(v, mask));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const GLubyte* const s = src + i * bytesPerPixel;
+        GLubyte* const d = dst + i * bytesPerPixel;
+        const GLubyte first = s[0];
+        d[0] = s[2];
+        d[1] = s[1];
+        d[2] = first;
+        if (bytesPerPixel == 4) {
+            d[3] = s[3];
+        }
+    }
+}
+
+/**
+ * Converts the color components of pixels from sRGB to linear values, in place.
+ *
+ * @param pixels Pixels to convert, with color components first
+ * @param count Number of pixels to convert
+ * @param bytesPerPixel Either 3 or 4
+ */
+void BitmapConverter::toLinear(GLubyte* pixels, const size_t count, const int bytesPerPixel) {
+    const GLubyte* const table = getToLinearTable();
+    for (size_t i = 0; i < count; ++i) {
+        GLubyte* const p = pixels + i * bytesPerPixel;
+        p[0] = table[p[0]];
+        p[1] = table[p[1]];
+        p[2] = table[p[2]];
+    }
+}
+
+/**
+ * Converts the color components of pixels from linear to sRGB values, in place.
+ *
+ * @param pixels Pixels to convert, with color components first
+ * @param count Number of pixels to convert
+ * @param bytesPerPixel Either 3 or 4
+ */
+void BitmapConverter::toSrgb(GLubyte* pixels, const size_t count, const int bytesPerPixel) {
+    const GLubyte* const table = getToSrgbTable();
+    for (size_t i = 0; i < count; ++i) {
+        GLubyte* const p = pixels + i * bytesPerPixel;
+        p[0] = table[p[0]];
+        p[1] = table[p[1]];
+        p[2] = table[p[2]];
+    }
+}
+
+// HELPERS
+
+void BitmapConverter::RowTask::run(const size_t begin, const size_t end) {
+    const size_t srcStride = ((src.width * Bitmap::sizeOf(src.format) + (src.alignment - 1)) / src.alignment) * src.alignment;
+    const size_t dstStride = ((dst.width * Bitmap::sizeOf(dst.format) + (dst.alignment - 1)) / dst.alignment) * dst.alignment;
+    const size_t used = ((size_t) dst.width) * Bitmap::sizeOf(dst.format);
+    for (size_t y = begin; y < end; ++y) {
+        GLubyte* const row = dst.pixels + y * dstStride;
+        converter.convertRow(src.pixels + y * srcStride, src.width, src.format, row);
+        memset(row + used, 0, dstStride - used);
+    }
+}
+
+} /* namespace Glycerin */
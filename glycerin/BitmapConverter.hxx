@@ -0,0 +1,85 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPCONVERTER_HXX
+#define GLYCERIN_BITMAPCONVERTER_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for changing the layout and color space of bitmaps.
+ *
+ * Bitmaps are read in whatever layout the file used, which is often not the
+ * one a driver uploads fastest.  _BitmapConverter_ makes a copy in the layout
+ * you ask for, so the driver does not have to convert it again on every
+ * upload.  Its properties are set with chained calls.
+ *
+ * ~~~
+ * BitmapConverter converter;
+ * converter.format(GL_RGBA).alignment(1).premultiply(true);
+ * const Bitmap converted = converter.convert(bitmap);
+ * ~~~
+ *
+ * The converter starts out making `GL_BGRA` pixels with rows aligned to four
+ * bytes, leaving the colors alone.  Formats with alpha get opaque pixels when
+ * the original has none.  Converting color components to linear values is
+ * done before premultiplying.  Note that storing linear values in eight bits
+ * loses precision in dark colors.
+ *
+ * The kernels that do the work are public as well, so they can be used on
+ * any pixel data.  They use SSSE3 or AVX2 shuffles when the compiler allows.
+ *
+ * To convert bitmaps as they are loaded, pass a converter to
+ * `BitmapLoader::converter`.
+ */
+class BitmapConverter {
+public:
+// Methods
+    BitmapConverter();
+    virtual ~BitmapConverter();
+    BitmapConverter& alignment(GLint alignment);
+    Bitmap convert(const Bitmap& bitmap) const;
+    BitmapConverter& format(GLenum format);
+    BitmapConverter& linear(bool linear);
+    BitmapConverter& premultiply(bool premultiply);
+    static void addAlpha(const GLubyte* src, size_t count, bool swap, GLubyte* dst);
+    static void premultiplyPixels(GLubyte* pixels, size_t count);
+    static void removeAlpha(const GLubyte* src, size_t count, bool swap, GLubyte* dst);
+    static void swapRedBlue(const GLubyte* src, size_t count, int bytesPerPixel, GLubyte* dst);
+    static void toLinear(GLubyte* pixels, size_t count, int bytesPerPixel);
+    static void toSrgb(GLubyte* pixels, size_t count, int bytesPerPixel);
+private:
+// Types
+    class RowTask;
+// Attributes
+    GLint _alignment;
+    GLenum _format;
+    bool _linear;
+    bool _premultiply;
+// Methods
+    void convertRow(const GLubyte* src, GLsizei width, GLenum format, GLubyte* dst) const;
+    static const GLubyte* getToLinearTable();
+    static const GLubyte* getToSrgbTable();
+    static bool isFormat(GLenum format);
+    static bool isRedFirst(GLenum format);
+};
+
+} /* namespace Glycerin */
+#endif
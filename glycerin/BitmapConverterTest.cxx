@@ -0,0 +1,202 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapConverter.hxx"
+#include "glycerin/BitmapGenerator.hxx"
+
+
+/**
+ * Unit test for `BitmapConverter`.
+ */
+class BitmapConverterTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Returns bytes that differ from each other and from their neighbors.
+     */
+    static std::vector<GLubyte> getBytes(const size_t size) {
+        std::vector<GLubyte> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = (GLubyte) (i * 37 + 11);
+        }
+        return bytes;
+    }
+
+    /**
+     * Ensures `BitmapConverter::addAlpha` matches a plain loop for every length around the vector widths.
+     */
+    void testAddAlpha() {
+        for (size_t count = 0; count < 40; ++count) {
+            const std::vector<GLubyte> src = getBytes(count * 3 + 1);
+            std::vector<GLubyte> dst(count * 4 + 1, 0);
+            Glycerin::BitmapConverter::addAlpha(&src[0], count, true, &dst[0]);
+            for (size_t i = 0; i < count; ++i) {
+                CPPUNIT_ASSERT_EQUAL((int) src[i * 3 + 2], (int) dst[i * 4 + 0]);
+                CPPUNIT_ASSERT_EQUAL((int) src[i * 3 + 1], (int) dst[i * 4 + 1]);
+                CPPUNIT_ASSERT_EQUAL((int) src[i * 3 + 0], (int) dst[i * 4 + 2]);
+                CPPUNIT_ASSERT_EQUAL(255, (int) dst[i * 4 + 3]);
+            }
+            CPPUNIT_ASSERT_EQUAL(0, (int) dst[count * 4]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapConverter::removeAlpha` matches a plain loop for every length around the vector widths.
+     */
+    void testRemoveAlpha() {
+        for (size_t count = 0; count < 40; ++count) {
+            const std::vector<GLubyte> src = getBytes(count * 4 + 1);
+            std::vector<GLubyte> dst(count * 3 + 1, 0);
+            Glycerin::BitmapConverter::removeAlpha(&src[0], count, false, &dst[0]);
+            for (size_t i = 0; i < count; ++i) {
+                for (int c = 0; c < 3; ++c) {
+                    CPPUNIT_ASSERT_EQUAL((int) src[i * 4 + c], (int) dst[i * 3 + c]);
+                }
+            }
+            CPPUNIT_ASSERT_EQUAL(0, (int) dst[count * 3]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapConverter::swapRedBlue` works in place for both pixel sizes.
+     */
+    void testSwapRedBlue() {
+        for (int bytesPerPixel = 3; bytesPerPixel <= 4; ++bytesPerPixel) {
+            for (size_t count = 0; count < 40; ++count) {
+                const std::vector<GLubyte> src = getBytes(count * bytesPerPixel);
+                std::vector<GLubyte> dst = src;
+                Glycerin::BitmapConverter::swapRedBlue(&dst[0], count, bytesPerPixel, &dst[0]);
+                for (size_t i = 0; i < count * bytesPerPixel; ++i) {
+                    const size_t c = i % bytesPerPixel;
+                    const size_t j = (c == 0) ? (i + 2) : ((c == 2) ? (i - 2) : i);
+                    CPPUNIT_ASSERT_EQUAL((int) src[j], (int) dst[i]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapConverter::premultiplyPixels` rounds to the nearest value and keeps alpha.
+     */
+    void testPremultiplyPixels() {
+        for (size_t count = 0; count < 20; ++count) {
+            const std::vector<GLubyte> src = getBytes(count * 4);
+            std::vector<GLubyte> dst = src;
+            Glycerin::BitmapConverter::premultiplyPixels(&dst[0], count);
+            for (size_t i = 0; i < count * 4; ++i) {
+                const int alpha = src[i - (i % 4) + 3];
+                const int expected = ((i % 4) == 3) ? alpha : ((src[i] * alpha + 127) / 255);
+                CPPUNIT_ASSERT_EQUAL(expected, (int) dst[i]);
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapConverter::toLinear` and `BitmapConverter::toSrgb` map the ends and darken midtones.
+     */
+    void testToLinearAndToSrgb() {
+        GLubyte pixels[] = { 0, 128, 255, 7 };
+        Glycerin::BitmapConverter::toLinear(pixels, 1, 4);
+        CPPUNIT_ASSERT_EQUAL(0, (int) pixels[0]);
+        CPPUNIT_ASSERT_EQUAL(55, (int) pixels[1]);
+        CPPUNIT_ASSERT_EQUAL(255, (int) pixels[2]);
+        CPPUNIT_ASSERT_EQUAL(7, (int) pixels[3]);
+        Glycerin::BitmapConverter::toSrgb(pixels, 1, 4);
+        CPPUNIT_ASSERT_EQUAL(0, (int) pixels[0]);
+        CPPUNIT_ASSERT_EQUAL(128, (int) pixels[1]);
+        CPPUNIT_ASSERT_EQUAL(255, (int) pixels[2]);
+    }
+
+    /**
+     * Ensures `BitmapConverter::convert` makes tight `GL_RGB` rows from padded `GL_BGR` rows.
+     */
+    void testConvertToTightRgb() {
+
+        // Convert an odd width so the original rows are padded
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(7, 5).seed(3).generate();
+        Glycerin::BitmapConverter converter;
+        const Glycerin::Bitmap converted = converter.format(GL_RGB).alignment(1).convert(bitmap);
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_RGB, converted.getFormat());
+        CPPUNIT_ASSERT_EQUAL(1, converted.getAlignment());
+        CPPUNIT_ASSERT_EQUAL(7 * 5 * 3, converted.getSize());
+
+        // Compare every pixel
+        const std::vector<GLubyte> expected = getPixels(bitmap);
+        const std::vector<GLubyte> actual = getPixels(converted);
+        for (int y = 0; y < 5; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    CPPUNIT_ASSERT_EQUAL((int) expected[y * 24 + x * 3 + (2 - c)], (int) actual[(y * 7 + x) * 3 + c]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapConverter::convert` can make a bitmap and convert it back.
+     */
+    void testConvertRoundTrip() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(33, 9).seed(5).generate();
+        Glycerin::BitmapConverter converter;
+        const Glycerin::Bitmap rgba = converter.format(GL_RGBA).convert(bitmap);
+        CPPUNIT_ASSERT_EQUAL(33 * 9 * 4, rgba.getSize());
+        const Glycerin::Bitmap bgr = converter.format(GL_BGR).convert(rgba);
+        CPPUNIT_ASSERT(getPixels(bitmap) == getPixels(bgr));
+    }
+
+    /**
+     * Ensures `BitmapConverter` rejects unsupported settings.
+     */
+    void testInvalidSettings() {
+        Glycerin::BitmapConverter converter;
+        CPPUNIT_ASSERT_THROW(converter.format(GL_RED), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(converter.alignment(3), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapConverterTest);
+    CPPUNIT_TEST(testAddAlpha);
+    CPPUNIT_TEST(testRemoveAlpha);
+    CPPUNIT_TEST(testSwapRedBlue);
+    CPPUNIT_TEST(testPremultiplyPixels);
+    CPPUNIT_TEST(testToLinearAndToSrgb);
+    CPPUNIT_TEST(testConvertToTightRgb);
+    CPPUNIT_TEST(testConvertRoundTrip);
+    CPPUNIT_TEST(testInvalidSettings);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapConverterTest::suite());
+    runner.run();
+    return 0;
+}
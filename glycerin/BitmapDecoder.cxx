@@ -0,0 +1,203 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <stdexcept>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "glycerin/BitmapDecoder.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Converts 16-bit or 32-bit pixels whose components are described by masks.
+ *
+ * Each mask selects the bits of one component, in the order red, green,
+ * blue, and alpha.  Components are scaled to eight bits.  If the alpha mask
+ * is zero, alpha is set to 255.
+ *
+ * @param src Little-endian pixels to convert
+ * @param count Number of pixels to convert
+ * @param bitCount Size of each source pixel in bits, either 16 or 32
+ * @param masks Red, green, blue, and alpha masks
+ * @param dst Memory to store `count` 32-bit pixels in
+ */
+void BitmapDecoder::expandBitfields(const GLubyte* src,
+                                    const size_t count,
+                                    const int bitCount,
+                                    const GLuint masks[4],
+                                    GLubyte* dst) {
+
+    // Find where each component starts and how much to scale it by
+    int shifts[4];
+    GLuint scales[4];
+    for (int c = 0; c < 4; ++c) {
+        shifts[c] = 0;
+        scales[c] = 0;
+        if (masks[c] == 0) {
+            continue;
+        }
+        while (((masks[c] >> shifts[c]) & 1) == 0) {
+            ++shifts[c];
+        }
+        GLuint max = masks[c] >> shifts[c];
+        while (max > 0xffff) {
+            ++shifts[c];
+            max >>= 1;
+        }
+        scales[c] = (255 << 16) / max;
+    }
+
+    // Convert each pixel, storing blue, green, red, alpha
+    static const int order[] = { 2, 1, 0, 3 };
+    const int bytesPerPixel = bitCount / 8;
+    for (size_t i = 0; i < count; ++i) {
+        GLuint value = 0;
+        for (int b = bytesPerPixel - 1; b >= 0; --b) {
+            value = (value << 8) | src[b];
+        }
+        for (int j = 0; j < 4; ++j) {
+            const int c = order[j];
+            const GLuint component = ((value & masks[c]) >> shifts[c]) & (masks[c] >> shifts[c]);
+            dst[j] = (masks[c] == 0) ? 255 : (GLubyte) ((component * scales[c] + 0x8000) >> 16);
+        }
+        src += bytesPerPixel;
+        dst += 4;
+    }
+}
+
+/**
+ * Looks up 8-bit indices in a palette.
+ *
+ * @param indices Indices to look up
+ * @param count Number of indices
+ * @param palette 256 entries made with [toPaletteEntry](@ref toPaletteEntry)
+ * @param dst Memory to store `count` 32-bit pixels in
+ */
+void BitmapDecoder::expandPalette(const GLubyte* indices,
+                                  const size_t count,
+                                  const GLuint palette[256],
+                                  GLubyte* dst) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (indices + i)));
+        const __m256i pixels = _mm256_i32gather_epi32((const int*) palette, index, 4);
+        _mm256_storeu_si256((__m256i*) (dst + i * 4), pixels);
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128i pixels = _mm_setr_epi32(
+                palette[indices[i]],
+                palette[indices[i + 1]],
+                palette[indices[i + 2]],
+                palette[indices[i + 3]]);
+        _mm_storeu_si128((__m128i*) (dst + i * 4), pixels);
+    }
+#endif
+    for (; i < count; ++i) {
+        memcpy(dst + i * 4, &palette[indices[i]], 4);
+    }
+}
+
+/**
+ * Decompresses run-length encoded 8-bit indices.
+ *
+ * Pixels skipped over by the encoding are left as index zero.  Runs that
+ * extend past the right edge of the image are clipped.
+ *
+ * @param src Encoded data
+ * @param size Number of bytes of encoded data
+ * @param width Number of pixels in each row
+ * @param height Number of rows
+ * @param indices Memory to store `width` times `height` indices in, from the bottom row up
+ * @throws runtime_error if encoded data ends in the middle of a run
+ */
+void BitmapDecoder::expandRle8(const GLubyte* src,
+                               const size_t size,
+                               const GLsizei width,
+                               const GLsizei height,
+                               GLubyte* indices) {
+
+    memset(indices, 0, ((size_t) width) * height);
+
+    GLsizei x = 0;
+    GLsizei y = 0;
+    size_t p = 0;
+    while ((p + 1 < size) && (y < height)) {
+        const GLubyte count = src[p++];
+        const GLubyte value = src[p++];
+        GLubyte* const row = indices + ((size_t) y) * width;
+        if (count > 0) {
+
+            // Encoded run of one index
+            for (int i = 0; (i < count) && (x < width); ++i) {
+                row[x++] = value;
+            }
+        } else if (value == 0) {
+
+            // End of line
+            x = 0;
+            ++y;
+        } else if (value == 1) {
+
+            // End of bitmap
+            return;
+        } else if (value == 2) {
+
+            // Delta
+            if (p + 2 > size) {
+                throw runtime_error("[BitmapDecoder] Run-length encoded data is truncated!");
+            }
+            x += src[p++];
+            y += src[p++];
+        } else {
+
+            // Absolute run of different indices, padded to an even length
+            if (p + value > size) {
+                throw runtime_error("[BitmapDecoder] Run-length encoded data is truncated!");
+            }
+            for (int i = 0; i < value; ++i) {
+                if (x < width) {
+                    row[x++] = src[p + i];
+                }
+            }
+            p += value + (value & 1);
+        }
+    }
+}
+
+/**
+ * Makes an opaque palette entry for [expandPalette](@ref expandPalette).
+ *
+ * @param blue Blue component of the color
+ * @param green Green component of the color
+ * @param red Red component of the color
+ * @return Palette entry that is stored in memory as blue, green, red, alpha
+ */
+GLuint BitmapDecoder::toPaletteEntry(const GLubyte blue, const GLubyte green, const GLubyte red) {
+    const GLubyte bytes[] = { blue, green, red, 255 };
+    GLuint entry;
+    memcpy(&entry, bytes, 4);
+    return entry;
+}
+
+} /* namespace Glycerin */
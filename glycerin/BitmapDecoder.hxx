@@ -0,0 +1,46 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPDECODER_HXX
+#define GLYCERIN_BITMAPDECODER_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+namespace Glycerin {
+
+
+/**
+ * Utility for converting pixel data stored in bitmap files.
+ *
+ * Every method converts to 32-bit pixels with the components ordered blue,
+ * green, red, and then alpha, which can be uploaded as `GL_BGRA` with type
+ * `GL_UNSIGNED_BYTE`.  That matches how most drivers store textures
+ * internally, making it one of the fastest formats to upload.
+ */
+class BitmapDecoder {
+public:
+// Methods
+    static void expandBitfields(const GLubyte* src, size_t count, int bitCount, const GLuint masks[4], GLubyte* dst);
+    static void expandPalette(const GLubyte* indices, size_t count, const GLuint palette[256], GLubyte* dst);
+    static void expandRle8(const GLubyte* src, size_t size, GLsizei width, GLsizei height, GLubyte* indices);
+    static GLuint toPaletteEntry(GLubyte blue, GLubyte green, GLubyte red);
+private:
+// Methods
+    BitmapDecoder();
+};
+
+} /* namespace Glycerin */
+#endif
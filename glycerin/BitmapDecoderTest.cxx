@@ -0,0 +1,125 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapDecoder.hxx"
+using namespace std;
+using namespace Glycerin;
+
+
+/**
+ * Unit test for `BitmapDecoder`.
+ */
+class BitmapDecoderTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `BitmapDecoder::expandBitfields` works with 5-6-5 pixels.
+     */
+    void testExpandBitfieldsWith565() {
+        const GLuint masks[] = { 0xf800, 0x07e0, 0x001f, 0 };
+        const GLubyte src[] = { 0x00, 0xf8, 0xe0, 0x07, 0x1f, 0x00 }; // red, green, blue
+        GLubyte dst[12];
+        BitmapDecoder::expandBitfields(src, 3, 16, masks, dst);
+        const GLubyte expected[] = { 0, 0, 255, 255, 0, 255, 0, 255, 255, 0, 0, 255 };
+        for (int i = 0; i < 12; ++i) {
+            CPPUNIT_ASSERT_EQUAL((int) expected[i], (int) dst[i]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapDecoder::expandBitfields` keeps alpha when there is an alpha mask.
+     */
+    void testExpandBitfieldsWithAlpha() {
+        const GLuint masks[] = { 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 };
+        const GLubyte src[] = { 10, 20, 30, 40 }; // red, green, blue, alpha
+        GLubyte dst[4];
+        BitmapDecoder::expandBitfields(src, 1, 32, masks, dst);
+        CPPUNIT_ASSERT_EQUAL((int) 30, (int) dst[0]);
+        CPPUNIT_ASSERT_EQUAL((int) 20, (int) dst[1]);
+        CPPUNIT_ASSERT_EQUAL((int) 10, (int) dst[2]);
+        CPPUNIT_ASSERT_EQUAL((int) 40, (int) dst[3]);
+    }
+
+    /**
+     * Ensures `BitmapDecoder::expandPalette` looks up every index, including ones past the vector width.
+     */
+    void testExpandPalette() {
+        GLuint palette[256];
+        for (int i = 0; i < 256; ++i) {
+            palette[i] = BitmapDecoder::toPaletteEntry(i, 255 - i, i / 2);
+        }
+        GLubyte indices[11];
+        for (int i = 0; i < 11; ++i) {
+            indices[i] = i * 23;
+        }
+        GLubyte dst[44];
+        BitmapDecoder::expandPalette(indices, 11, palette, dst);
+        for (int i = 0; i < 11; ++i) {
+            CPPUNIT_ASSERT_EQUAL((int) indices[i], (int) dst[i * 4]);
+            CPPUNIT_ASSERT_EQUAL((int) 255 - indices[i], (int) dst[i * 4 + 1]);
+            CPPUNIT_ASSERT_EQUAL((int) indices[i] / 2, (int) dst[i * 4 + 2]);
+            CPPUNIT_ASSERT_EQUAL((int) 255, (int) dst[i * 4 + 3]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapDecoder::expandRle8` handles encoded runs, absolute runs, and end of line.
+     */
+    void testExpandRle8() {
+        const GLubyte src[] = {
+                3, 7,          // three sevens
+                0, 0,          // end of line
+                0, 3, 1, 2, 3, // absolute run of three
+                0,             // padding
+                0, 1 };        // end of bitmap
+        GLubyte indices[6];
+        BitmapDecoder::expandRle8(src, sizeof(src), 3, 2, indices);
+        const GLubyte expected[] = { 7, 7, 7, 1, 2, 3 };
+        for (int i = 0; i < 6; ++i) {
+            CPPUNIT_ASSERT_EQUAL((int) expected[i], (int) indices[i]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapDecoder::expandRle8` throws if an absolute run is cut short.
+     */
+    void testExpandRle8WithTruncatedData() {
+        const GLubyte src[] = { 0, 5, 1, 2 };
+        GLubyte indices[5];
+        CPPUNIT_ASSERT_THROW(BitmapDecoder::expandRle8(src, sizeof(src), 5, 1, indices), runtime_error);
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapDecoderTest);
+    CPPUNIT_TEST(testExpandBitfieldsWith565);
+    CPPUNIT_TEST(testExpandBitfieldsWithAlpha);
+    CPPUNIT_TEST(testExpandPalette);
+    CPPUNIT_TEST(testExpandRle8);
+    CPPUNIT_TEST(testExpandRle8WithTruncatedData);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapDecoderTest::suite());
+    runner.run();
+    return 0;
+}
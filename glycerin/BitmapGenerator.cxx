@@ -0,0 +1,241 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/BitmapWriter.hxx"
+#include "glycerin/Noise.hxx"
+#include "glycerin/Parallel.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Generates a range of rows into memory.
+ */
+class BitmapGenerator::RowTask : public Parallel::Task {
+public:
+    RowTask(const BitmapGenerator& generator, GLubyte* pixels, size_t stride) :
+            generator(generator), pixels(pixels), stride(stride) { }
+    virtual void run(size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            generator.generateRow(y, pixels + y * stride);
+        }
+    }
+private:
+    const BitmapGenerator& generator;
+    GLubyte* const pixels;
+    const size_t stride;
+};
+
+/**
+ * Constructs a bitmap generator with default settings.
+ */
+BitmapGenerator::BitmapGenerator() :
+        _cellSize(DEFAULT_CELL_SIZE),
+        _height(DEFAULT_SIZE),
+        _pattern(NOISE),
+        _seed(0),
+        _width(DEFAULT_SIZE) {
+    // empty
+}
+
+/**
+ * Destroys the bitmap generator.
+ */
+BitmapGenerator::~BitmapGenerator() {
+    // empty
+}
+
+/**
+ * Changes the size of the squares in the checkerboard pattern.
+ *
+ * @param cellSize Number of pixels along each edge of a square
+ * @return Reference to this generator to support chaining
+ * @throws invalid_argument if cell size is less than one
+ */
+BitmapGenerator& BitmapGenerator::cellSize(const GLsizei cellSize) {
+    if (cellSize < 1) {
+        throw invalid_argument("[BitmapGenerator] Cell size is less than one!");
+    }
+    _cellSize = cellSize;
+    return (*this);
+}
+
+/**
+ * Makes a bitmap in memory using the current settings.
+ *
+ * @return Bitmap that was generated
+ * @throws length_error if bitmap would be too large
+ */
+Bitmap BitmapGenerator::generate() const {
+
+    // Compute the size of each row, padded to the alignment, without overflowing
+    const size_t maximum = numeric_limits<GLsizei>::max();
+    if ((size_t) _width > (maximum - (ALIGNMENT - 1)) / 3) {
+        throw length_error("[BitmapGenerator] Bitmap is too large!");
+    }
+    const size_t stride = (((size_t) _width * 3 + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+    if (stride > maximum / _height) {
+        throw length_error("[BitmapGenerator] Bitmap is too large!");
+    }
+    const size_t size = stride * _height;
+
+    // Make the bitmap
+    Bitmap bitmap;
+    bitmap.setPixels(new GLubyte[size], NULL);
+    bitmap.width = _width;
+    bitmap.height = _height;
+    bitmap.size = size;
+    bitmap.alignment = ALIGNMENT;
+
+    // Fill in the pixels
+    RowTask task(*this, bitmap.pixels, stride);
+    Parallel::forEach(_height, task, 16);
+    return bitmap;
+}
+
+/**
+ * Computes the pixels for one row, including any padding.
+ *
+ * @param y Index of the row, starting from the bottom
+ * @param dst Memory to store the pixels in
+ */
+void BitmapGenerator::generateRow(const GLsizei y, GLubyte* const dst) const {
+
+    GLubyte* p = dst;
+
+    switch (_pattern) {
+    case CHECKERBOARD:
+        for (GLsizei x = 0; x < _width; ++x) {
+            const GLubyte value = (((x / _cellSize) + (y / _cellSize)) % 2) ? 255 : 0;
+            *(p++) = value;
+            *(p++) = value;
+            *(p++) = value;
+        }
+        break;
+    case GRADIENT: {
+        const GLfloat g = (_height > 1) ? (((GLfloat) y) / (_height - 1)) : 0;
+        for (GLsizei x = 0; x < _width; ++x) {
+            const GLfloat r = (_width > 1) ? (((GLfloat) x) / (_width - 1)) : 0;
+            *(p++) = (GLubyte) ((1 - (r + g) / 2) * 255 + 0.5f);
+            *(p++) = (GLubyte) (g * 255 + 0.5f);
+            *(p++) = (GLubyte) (r * 255 + 0.5f);
+        }
+        break;
+    }
+    case NOISE: {
+        const GLuint base = Noise::hash(_seed ^ Noise::hash(y));
+        for (GLsizei x = 0; x < _width * 3; ++x) {
+            *(p++) = (GLubyte) (Noise::hash(base + x) >> 24);
+        }
+        break;
+    }
+    case SPHERES: {
+        const GLfloat smallest = min(_width, _height);
+        fill(p, p + _width * 3, 0);
+        for (int i = 0; i < NUMBER_OF_SPHERES; ++i) {
+
+            // Place and color the disc
+            const GLuint h = Noise::hash(_seed + i);
+            const GLfloat cx = Noise::toUnit(Noise::hash(h + 1)) * _width;
+            const GLfloat cy = Noise::toUnit(Noise::hash(h + 2)) * _height;
+            const GLfloat r = smallest * (1.0f + 3.0f * Noise::toUnit(Noise::hash(h + 3))) / 16;
+            const GLuint color = Noise::hash(h + 4);
+
+            // Find where this row crosses it
+            const GLfloat dy = y - cy;
+            const GLfloat rr = r * r - dy * dy;
+            if (rr <= 0) {
+                continue;
+            }
+            const GLfloat half = sqrt(rr);
+            const GLsizei x1 = max(0, (GLsizei) ceil(cx - half));
+            const GLsizei x2 = min(_width - 1, (GLsizei) floor(cx + half));
+            for (GLsizei x = x1; x <= x2; ++x) {
+                const GLfloat dx = x - cx;
+                const GLfloat shade = sqrt(max(0.0f, 1 - (dx * dx + dy * dy) / (r * r)));
+                for (int c = 0; c < 3; ++c) {
+                    p[x * 3 + c] = (GLubyte) (((color >> (c * 8)) & 0xff) * shade);
+                }
+            }
+        }
+        p += _width * 3;
+        break;
+    }
+    }
+
+    // Clear the padding
+    while ((p - dst) % ALIGNMENT != 0) {
+        *(p++) = 0;
+    }
+}
+
+/**
+ * Changes the kind of pixels to generate.
+ *
+ * @param pattern Kind of pixels to generate
+ * @return Reference to this generator to support chaining
+ */
+BitmapGenerator& BitmapGenerator::pattern(const Pattern pattern) {
+    _pattern = pattern;
+    return (*this);
+}
+
+/**
+ * Changes the seed used for random patterns.
+ *
+ * @param seed Seed used for random patterns
+ * @return Reference to this generator to support chaining
+ */
+BitmapGenerator& BitmapGenerator::seed(const GLuint seed) {
+    _seed = seed;
+    return (*this);
+}
+
+/**
+ * Changes the size of the image.
+ *
+ * @param width Number of pixels in the X direction
+ * @param height Number of pixels in the Y direction
+ * @return Reference to this generator to support chaining
+ * @throws invalid_argument if width or height is less than one
+ */
+BitmapGenerator& BitmapGenerator::size(const GLsizei width, const GLsizei height) {
+    if ((width < 1) || (height < 1)) {
+        throw invalid_argument("[BitmapGenerator] Width or height is less than one!");
+    }
+    _width = width;
+    _height = height;
+    return (*this);
+}
+
+/**
+ * Writes a bitmap file using the current settings.
+ *
+ * @param filename Path to the file to write
+ * @throws runtime_error if file cannot be opened or written
+ */
+void BitmapGenerator::write(const string& filename) const {
+    BitmapWriter writer;
+    writer.write(generate(), filename);
+}
+
+} /* namespace Glycerin */
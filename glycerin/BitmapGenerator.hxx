@@ -0,0 +1,87 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPGENERATOR_HXX
+#define GLYCERIN_BITMAPGENERATOR_HXX
+#include "glycerin/common.h"
+#include <string>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for making bitmap images procedurally.
+ *
+ * _BitmapGenerator_ makes reproducible bitmaps of any size, which is useful
+ * for measuring how loading and uploading scale.  Its properties are set with
+ * chained calls, the same way as _VolumeGenerator_.
+ *
+ * ~~~
+ * BitmapGenerator generator;
+ * const Bitmap bitmap = generator.size(1024, 1024).pattern(BitmapGenerator::CHECKERBOARD).generate();
+ * ~~~
+ *
+ * The generator starts out making a 256x256 image filled with
+ * [noise](@ref NOISE), using a seed of zero and a checkerboard cell size of
+ * eight pixels.  Images are made in the same 24-bit format that _BitmapReader_
+ * produces.  To write one straight to a file, use [write].
+ *
+ * ~~~
+ * generator.size(4096, 4096).write("large.bmp");
+ * ~~~
+ *
+ * [write]: @ref write(const std::string&) const "write(const std::string&)"
+ */
+class BitmapGenerator {
+public:
+// Types
+    /// Kind of pixels to generate
+    enum Pattern {
+        CHECKERBOARD, ///< Alternating black and white squares
+        GRADIENT,     ///< Red increasing to the right, green increasing upwards, and blue decreasing diagonally
+        NOISE,        ///< Independent random value for every component of every pixel
+        SPHERES       ///< Randomly placed and colored discs, shaded like spheres
+    };
+// Methods
+    BitmapGenerator();
+    virtual ~BitmapGenerator();
+    BitmapGenerator& cellSize(GLsizei cellSize);
+    Bitmap generate() const;
+    BitmapGenerator& pattern(Pattern pattern);
+    BitmapGenerator& seed(GLuint seed);
+    BitmapGenerator& size(GLsizei width, GLsizei height);
+    void write(const std::string& filename) const;
+private:
+// Types
+    class RowTask;
+// Constants
+    static const GLsizei DEFAULT_CELL_SIZE = 8;
+    static const GLsizei DEFAULT_SIZE = 256;
+    static const GLint ALIGNMENT = 4;
+    static const int NUMBER_OF_SPHERES = 8;
+// Attributes
+    GLsizei _cellSize;
+    GLsizei _height;
+    Pattern _pattern;
+    GLuint _seed;
+    GLsizei _width;
+// Methods
+    void generateRow(GLsizei y, GLubyte* dst) const;
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/BitmapReader.hxx"
+
+
+/**
+ * Unit test for `BitmapGenerator`.
+ */
+class BitmapGeneratorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Ensures `BitmapGenerator::generate` pads rows to the alignment.
+     */
+    void testGenerateWithSize() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(5, 3).generate();
+        CPPUNIT_ASSERT_EQUAL(5, bitmap.getWidth());
+        CPPUNIT_ASSERT_EQUAL(3, bitmap.getHeight());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_BGR, bitmap.getFormat());
+        CPPUNIT_ASSERT_EQUAL(4, bitmap.getAlignment());
+        CPPUNIT_ASSERT_EQUAL(16 * 3, bitmap.getSize());
+    }
+
+    /**
+     * Ensures `BitmapGenerator::generate` makes a checkerboard correctly.
+     */
+    void testGenerateCheckerboard() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator()
+                .size(4, 4)
+                .cellSize(2)
+                .pattern(Glycerin::BitmapGenerator::CHECKERBOARD)
+                .generate();
+        const std::vector<GLubyte> pixels = getPixels(bitmap);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 0, pixels[0]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, pixels[6]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, pixels[12 * 2]);
+    }
+
+    /**
+     * Ensures `BitmapGenerator::generate` makes the same noise for the same seed.
+     */
+    void testGenerateNoiseIsReproducible() {
+        Glycerin::BitmapGenerator generator;
+        generator.size(16, 16).pattern(Glycerin::BitmapGenerator::NOISE);
+        const std::vector<GLubyte> first = getPixels(generator.seed(1).generate());
+        const std::vector<GLubyte> second = getPixels(generator.seed(1).generate());
+        const std::vector<GLubyte> third = getPixels(generator.seed(2).generate());
+        CPPUNIT_ASSERT(first == second);
+        CPPUNIT_ASSERT(first != third);
+    }
+
+    /**
+     * Ensures `BitmapGenerator::generate` throws if the bitmap would be too large.
+     */
+    void testGenerateWithHugeSize() {
+        Glycerin::BitmapGenerator generator;
+        generator.size(std::numeric_limits<GLsizei>::max() / 2, 1);
+        CPPUNIT_ASSERT_THROW(generator.generate(), std::length_error);
+        generator.size(65536, 65536);
+        CPPUNIT_ASSERT_THROW(generator.generate(), std::length_error);
+    }
+
+    /**
+     * Ensures `BitmapGenerator::size` throws if passed zero.
+     */
+    void testSizeWithZero() {
+        Glycerin::BitmapGenerator generator;
+        CPPUNIT_ASSERT_THROW(generator.size(0, 1), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `BitmapGenerator::write` makes a file that can be read back in.
+     */
+    void testWrite() {
+        Glycerin::BitmapGenerator generator;
+        generator.size(7, 5).pattern(Glycerin::BitmapGenerator::GRADIENT);
+        generator.write("BitmapGeneratorTest.bmp");
+        Glycerin::BitmapReader reader;
+        const Glycerin::Bitmap bitmap = reader.read("BitmapGeneratorTest.bmp");
+        remove("BitmapGeneratorTest.bmp");
+        CPPUNIT_ASSERT(getPixels(generator.generate()) == getPixels(bitmap));
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapGeneratorTest);
+    CPPUNIT_TEST(testGenerateWithSize);
+    CPPUNIT_TEST(testGenerateCheckerboard);
+    CPPUNIT_TEST(testGenerateNoiseIsReproducible);
+    CPPUNIT_TEST(testGenerateWithHugeSize);
+    CPPUNIT_TEST(testSizeWithZero);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapGeneratorTest::suite());
+    runner.run();
+    return 0;
+}
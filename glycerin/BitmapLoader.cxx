@@ -0,0 +1,306 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include "glycerin/BitmapLoader.hxx"
+#include "glycerin/BitmapReader.hxx"
+#include "glycerin/Parallel.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a bitmap loader with default settings.
+ */
+BitmapLoader::BitmapLoader() :
+        _converting(false),
+        _mapped(false),
+        _next(0),
+        _remaining(0),
+        _threads(Parallel::getConcurrency()) {
+    pthread_mutex_init(&_mutex, NULL);
+}
+
+/**
+ * Destroys the bitmap loader, first waiting for any files still being read.
+ */
+BitmapLoader::~BitmapLoader() {
+    wait();
+    pthread_mutex_destroy(&_mutex);
+}
+
+/**
+ * Changes how each bitmap is converted after it is read.
+ *
+ * Converting on the workers keeps the cost of changing formats off the thread
+ * that uploads the textures.  The converter is copied.
+ *
+ * @param converter Settings to convert each bitmap with
+ * @return Reference to this loader to support chaining
+ */
+BitmapLoader& BitmapLoader::converter(const BitmapConverter& converter) {
+    _converter = converter;
+    _converting = true;
+    return (*this);
+}
+
+/**
+ * Checks if every file passed to [start](@ref start) has been read.
+ *
+ * @return `true` if no files are left to read
+ */
+bool BitmapLoader::done() {
+    pthread_mutex_lock(&_mutex);
+    const bool done = (_remaining == 0);
+    pthread_mutex_unlock(&_mutex);
+    return done;
+}
+
+/**
+ * Checks if one result comes before another.
+ *
+ * @param a First result
+ * @param b Second result
+ * @return `true` if the first result's file was listed before the second's
+ */
+bool BitmapLoader::isEarlier(const Result& a, const Result& b) {
+    return a._index < b._index;
+}
+
+/**
+ * Reads files in parallel and waits for all of them.
+ *
+ * @param filenames Paths to the files to read
+ * @return One result per file, in the same order as the paths
+ * @throws logic_error if files passed to [start](@ref start) are still being read
+ */
+vector<BitmapLoader::Result> BitmapLoader::load(const vector<string>& filenames) {
+    start(filenames);
+    wait();
+    vector<Result> results = poll();
+    stable_sort(results.begin(), results.end(), &isEarlier);
+    return results;
+}
+
+/**
+ * Changes whether files are mapped into memory instead of read.
+ *
+ * @param mapped `true` to use `BitmapReader::readMapped`, `false` to use `BitmapReader::read`
+ * @return Reference to this loader to support chaining
+ */
+BitmapLoader& BitmapLoader::mapped(const bool mapped) {
+    _mapped = mapped;
+    return (*this);
+}
+
+/**
+ * Takes the results of files that finished since the last call.
+ *
+ * Results are in the order the files finished, not the order they were
+ * listed in; use [index](@ref Result::index) to match them up.
+ *
+ * @return Results that have not been taken yet, which may be empty
+ */
+vector<BitmapLoader::Result> BitmapLoader::poll() {
+    vector<Result> results;
+    pthread_mutex_lock(&_mutex);
+    results.swap(_finished);
+    pthread_mutex_unlock(&_mutex);
+    return results;
+}
+
+/**
+ * Reads one file, catching any error.
+ *
+ * @param index Position of the file in the list
+ * @return Result for the file
+ */
+BitmapLoader::Result BitmapLoader::read(const size_t index) const {
+    const string& filename = _filenames[index];
+    try {
+        BitmapReader reader;
+        Bitmap bitmap = _mapped ? reader.readMapped(filename) : reader.read(filename);
+        if (_converting) {
+            bitmap = _converter.convert(bitmap);
+        }
+        return Result(index, filename, bitmap, "", true);
+    } catch (exception& e) {
+        return Result(index, filename, Bitmap(), e.what(), false);
+    }
+}
+
+/**
+ * Runs a worker on a new thread.
+ *
+ * @param loader Pointer to the loader the worker belongs to
+ * @return `NULL` always
+ */
+void* BitmapLoader::runWorker(void* const loader) {
+    ((BitmapLoader*) loader)->work();
+    return NULL;
+}
+
+/**
+ * Starts reading files in the background and returns immediately.
+ *
+ * Results of files read earlier that have not been taken with
+ * [poll](@ref poll) are kept.
+ *
+ * @param filenames Paths to the files to read
+ * @throws logic_error if files from an earlier call are still being read
+ */
+void BitmapLoader::start(const vector<string>& filenames) {
+
+    if (!_workers.empty()) {
+        if (!done()) {
+            throw logic_error("[BitmapLoader] Still reading files from last call!");
+        }
+        wait();
+    }
+
+    // Reset the list
+    _filenames = filenames;
+    _next = 0;
+    _remaining = filenames.size();
+
+    // Start the workers
+    const size_t n = min(_threads, filenames.size());
+    for (size_t i = 0; i < n; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &runWorker, this) != 0) {
+            break;
+        }
+        _workers.push_back(thread);
+    }
+
+    // Read everything here if no workers could be started
+    if (_workers.empty()) {
+        work();
+    }
+}
+
+/**
+ * Changes the number of worker threads.
+ *
+ * Reading is often limited by the disk rather than the processors, so using
+ * more threads than processors can help.
+ *
+ * @param threads Number of files to read at the same time
+ * @return Reference to this loader to support chaining
+ * @throws invalid_argument if threads is zero
+ */
+BitmapLoader& BitmapLoader::threads(const size_t threads) {
+    if (threads == 0) {
+        throw invalid_argument("[BitmapLoader] Number of threads is zero!");
+    }
+    _threads = threads;
+    return (*this);
+}
+
+/**
+ * Blocks until every file passed to [start](@ref start) has been read.
+ */
+void BitmapLoader::wait() {
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        pthread_join(_workers[i], NULL);
+    }
+    _workers.clear();
+}
+
+/**
+ * Reads files until none are left.
+ */
+void BitmapLoader::work() {
+    while (true) {
+
+        // Claim the next file
+        pthread_mutex_lock(&_mutex);
+        const size_t index = _next++;
+        pthread_mutex_unlock(&_mutex);
+        if (index >= _filenames.size()) {
+            return;
+        }
+
+        // Read it and hand over the result
+        const Result result = read(index);
+        pthread_mutex_lock(&_mutex);
+        _finished.push_back(result);
+        --_remaining;
+        pthread_mutex_unlock(&_mutex);
+    }
+}
+
+// RESULT
+
+/**
+ * Constructs a result.
+ */
+BitmapLoader::Result::Result(const size_t index,
+                             const string& filename,
+                             const Bitmap& bitmap,
+                             const string& error,
+                             const bool succeeded) :
+        _bitmap(bitmap),
+        _error(error),
+        _filename(filename),
+        _index(index),
+        _succeeded(succeeded) {
+    // empty
+}
+
+/**
+ * Returns the bitmap that was read.
+ *
+ * @throws runtime_error with the error message if the file could not be read
+ */
+const Bitmap& BitmapLoader::Result::bitmap() const {
+    if (!_succeeded) {
+        throw runtime_error(_error);
+    }
+    return _bitmap;
+}
+
+/**
+ * Returns why the file could not be read, or an empty string if it was.
+ */
+const string& BitmapLoader::Result::error() const {
+    return _error;
+}
+
+/**
+ * Returns the path to the file.
+ */
+const string& BitmapLoader::Result::filename() const {
+    return _filename;
+}
+
+/**
+ * Returns the position of the file in the list it was passed in.
+ */
+size_t BitmapLoader::Result::index() const {
+    return _index;
+}
+
+/**
+ * Returns whether the file was read.
+ */
+bool BitmapLoader::Result::succeeded() const {
+    return _succeeded;
+}
+
+} /* namespace Glycerin */
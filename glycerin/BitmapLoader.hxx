@@ -0,0 +1,126 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPLOADER_HXX
+#define GLYCERIN_BITMAPLOADER_HXX
+#include "glycerin/common.h"
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "glycerin/Bitmap.hxx"
+#include "glycerin/BitmapConverter.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for reading many bitmap files at once.
+ *
+ * _BitmapLoader_ reads files on a pool of worker threads, so the time spent
+ * waiting on the disk and decoding overlaps.  The simplest way to use it is
+ * to pass every path to [load], which returns one [result] per path in the
+ * same order.  A file that cannot be read does not stop the others; its
+ * result holds the error instead.
+ *
+ * ~~~
+ * BitmapLoader loader;
+ * const std::vector<BitmapLoader::Result> results = loader.load(filenames);
+ * for (size_t i = 0; i < results.size(); ++i) {
+ *     if (results[i].succeeded()) {
+ *         textures.push_back(results[i].bitmap().createTexture());
+ *     }
+ * }
+ * ~~~
+ *
+ * Workers never touch OpenGL, so textures must still be made on the thread
+ * that owns the context.  To keep that thread busy while files are being
+ * read, call [start] instead, and then call [poll] once a frame to get the
+ * files finished since the last call.
+ *
+ * ~~~
+ * loader.start(filenames);
+ * while (!loader.done()) {
+ *     const std::vector<BitmapLoader::Result> finished = loader.poll();
+ *     ...
+ * }
+ * ~~~
+ *
+ * By default the pool has one worker per processor and files are read
+ * rather than mapped.  Both can be changed with [threads] and [mapped].  Use
+ * [converter] to have the workers convert each bitmap too.
+ *
+ * [converter]: @ref converter(const BitmapConverter&) "converter(const BitmapConverter&)"
+ * [load]: @ref load(const std::vector<std::string>&) "load(const std::vector<std::string>&)"
+ * [mapped]: @ref mapped(bool) "mapped(bool)"
+ * [poll]: @ref poll() "poll()"
+ * [result]: @ref BitmapLoader::Result "Result"
+ * [start]: @ref start(const std::vector<std::string>&) "start(const std::vector<std::string>&)"
+ * [threads]: @ref threads(size_t) "threads(size_t)"
+ */
+class BitmapLoader {
+public:
+// Types
+    /// Outcome of reading one file
+    class Result {
+    public:
+        const Bitmap& bitmap() const;
+        const std::string& error() const;
+        const std::string& filename() const;
+        size_t index() const;
+        bool succeeded() const;
+    private:
+        Bitmap _bitmap;
+        std::string _error;
+        std::string _filename;
+        size_t _index;
+        bool _succeeded;
+        Result(size_t index, const std::string& filename, const Bitmap& bitmap, const std::string& error, bool succeeded);
+        friend class BitmapLoader;
+    };
+// Methods
+    BitmapLoader();
+    virtual ~BitmapLoader();
+    BitmapLoader& converter(const BitmapConverter& converter);
+    bool done();
+    std::vector<Result> load(const std::vector<std::string>& filenames);
+    BitmapLoader& mapped(bool mapped);
+    std::vector<Result> poll();
+    void start(const std::vector<std::string>& filenames);
+    BitmapLoader& threads(size_t threads);
+    void wait();
+private:
+// Attributes
+    BitmapConverter _converter;
+    bool _converting;
+    std::vector<std::string> _filenames;
+    std::vector<Result> _finished;
+    bool _mapped;
+    pthread_mutex_t _mutex;
+    size_t _next;
+    size_t _remaining;
+    size_t _threads;
+    std::vector<pthread_t> _workers;
+// Methods
+    BitmapLoader(const BitmapLoader&);
+    BitmapLoader& operator=(const BitmapLoader&);
+    static bool isEarlier(const Result& a, const Result& b);
+    Result read(size_t index) const;
+    static void* runWorker(void* loader);
+    void work();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapLoader.hxx"
+
+
+/**
+ * Unit test for `BitmapLoader`.
+ */
+class BitmapLoaderTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns a list of files, with a missing one in the middle.
+     */
+    static std::vector<std::string> getFilenames() {
+        std::vector<std::string> filenames;
+        for (int i = 0; i < 8; ++i) {
+            filenames.push_back((i % 2 == 0) ? "glycerin/rgbw.bmp" : "glycerin/crate.bmp");
+        }
+        filenames[5] = "glycerin/missing.bmp";
+        return filenames;
+    }
+
+    /**
+     * Ensures `BitmapLoader::load` returns results in order, with errors for missing files.
+     */
+    void testLoad() {
+        Glycerin::BitmapLoader loader;
+        const std::vector<Glycerin::BitmapLoader::Result> results = loader.threads(3).load(getFilenames());
+        CPPUNIT_ASSERT_EQUAL((size_t) 8, results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(i, results[i].index());
+            if (i == 5) {
+                CPPUNIT_ASSERT(!results[i].succeeded());
+                CPPUNIT_ASSERT(!results[i].error().empty());
+                CPPUNIT_ASSERT_THROW(results[i].bitmap(), std::runtime_error);
+            } else {
+                CPPUNIT_ASSERT(results[i].succeeded());
+                CPPUNIT_ASSERT_EQUAL((i % 2 == 0) ? 2 : results[1].bitmap().getWidth(), results[i].bitmap().getWidth());
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapLoader::load` converts each bitmap when given a converter.
+     */
+    void testLoadWithConverter() {
+        Glycerin::BitmapConverter converter;
+        converter.format(GL_RGBA).alignment(1);
+        Glycerin::BitmapLoader loader;
+        const std::vector<Glycerin::BitmapLoader::Result> results = loader.converter(converter).load(getFilenames());
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].succeeded()) {
+                const Glycerin::Bitmap& bitmap = results[i].bitmap();
+                CPPUNIT_ASSERT_EQUAL((GLenum) GL_RGBA, bitmap.getFormat());
+                CPPUNIT_ASSERT_EQUAL(1, bitmap.getAlignment());
+                CPPUNIT_ASSERT_EQUAL(bitmap.getWidth() * bitmap.getHeight() * 4, bitmap.getSize());
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapLoader::start` and `BitmapLoader::poll` hand over every file exactly once.
+     */
+    void testStartAndPoll() {
+        Glycerin::BitmapLoader loader;
+        loader.mapped(true).start(getFilenames());
+        std::vector<bool> seen(8, false);
+        size_t count = 0;
+        while (count < 8) {
+            const std::vector<Glycerin::BitmapLoader::Result> finished = loader.poll();
+            for (size_t i = 0; i < finished.size(); ++i) {
+                CPPUNIT_ASSERT(!seen[finished[i].index()]);
+                seen[finished[i].index()] = true;
+                ++count;
+            }
+        }
+        CPPUNIT_ASSERT(loader.done());
+        CPPUNIT_ASSERT(loader.poll().empty());
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapLoaderTest);
+    CPPUNIT_TEST(testLoad);
+    CPPUNIT_TEST(testLoadWithConverter);
+    CPPUNIT_TEST(testStartAndPoll);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapLoaderTest::suite());
+    runner.run();
+    return 0;
+}
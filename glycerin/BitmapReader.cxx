@@ -16,8 +16,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "config.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
 #include <stdexcept>
+#include "glycerin/BitmapDecoder.hxx"
 #include "glycerin/BitmapReader.hxx"
+#include "glycerin/MappedFile.hxx"
 using namespace std;
 namespace Glycerin {
 
@@ -36,25 +43,241 @@ BitmapReader::~BitmapReader() {
 }
 
 /**
- * Checks if any info header fields indicate the data is compressed.
+ * Computes the number of bytes of pixel data stored in the file.
+ *
+ * @param infoHeader Info header describing the image
+ * @return Number of bytes of pixel data, including padding at the end of each row
+ */
+size_t BitmapReader::computeSize(const InfoHeader& infoHeader) {
+    if (infoHeader.biCompression == BI_RLE8) {
+        return infoHeader.biSizeImage;
+    }
+    return computeStride(infoHeader) * abs(infoHeader.biHeight);
+}
+
+/**
+ * Computes the number of bytes in each row stored in the file for uncompressed images.
+ *
+ * @param infoHeader Info header describing the image
+ * @return Number of bytes in each row, including padding to a multiple of four
+ */
+size_t BitmapReader::computeStride(const InfoHeader& infoHeader) {
+    return ((((size_t) infoHeader.biWidth) * infoHeader.biBitCount + 31) / 32) * 4;
+}
+
+/**
+ * Makes a bitmap from an info header and its pixels.
+ *
+ * @param infoHeader Info header describing the image
+ * @param format Format of the pixels, either `GL_BGR` or `GL_BGRA`
+ * @param pixels Pixel data of the image, ordered from the bottom row up
+ * @param mapping Mapped file containing the pixels, or `NULL` if they were allocated with `new`
+ * @return Bitmap owning the pixels, or the mapping if there is one
+ */
+Bitmap BitmapReader::createBitmap(const InfoHeader& infoHeader,
+                                  const GLenum format,
+                                  GLubyte* const pixels,
+                                  MappedFile* const mapping) {
+    const size_t bytesPerPixel = (format == GL_BGRA) ? 4 : 3;
+    const size_t stride = ((((size_t) infoHeader.biWidth) * bytesPerPixel + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+    Bitmap bitmap;
+    bitmap.setPixels(pixels, mapping);
+    bitmap.format = format;
+    bitmap.width = infoHeader.biWidth;
+    bitmap.height = abs(infoHeader.biHeight);
+    bitmap.size = (GLsizei) (stride * bitmap.height);
+    bitmap.alignment = ALIGNMENT;
+    return bitmap;
+}
+
+/**
+ * Converts pixel data that cannot be used as it is stored in the file.
+ *
+ * @param infoHeader Info header describing the image
+ * @param palette Colors for paletted images, made with `BitmapDecoder::toPaletteEntry`
+ * @param data Pixel data as stored in the file
+ * @param size Number of bytes of pixel data
+ * @return Bitmap with converted pixels, ordered from the bottom row up
+ * @throws runtime_error if there are fewer bytes than the rows need, or run-length encoded data is truncated
+ */
+Bitmap BitmapReader::decode(const InfoHeader& infoHeader,
+                            const vector<GLuint>& palette,
+                            const GLubyte* const data,
+                            const size_t size) {
+
+    const GLsizei width = infoHeader.biWidth;
+    const GLsizei height = abs(infoHeader.biHeight);
+    const size_t stride = computeStride(infoHeader);
+    const bool bottomUp = isBottomUp(infoHeader);
+
+    // Make sure every row is there before reading any of them
+    if ((infoHeader.biCompression != BI_RLE8) && (size < stride * height)) {
+        throw runtime_error("[BitmapReader] All pixels could not be read!");
+    }
+
+    // Keep 24-bit and plain 32-bit pixels as they are, just reordering the rows
+    if (isDirect(infoHeader)) {
+        const size_t total = stride * height;
+        GLubyte* const pixels = new GLubyte[total];
+        for (GLsizei y = 0; y < height; ++y) {
+            const GLsizei row = bottomUp ? y : (height - 1 - y);
+            memcpy(pixels + y * stride, data + row * stride, stride);
+        }
+        fixAlpha(infoHeader, pixels, total);
+        return createBitmap(infoHeader, getFormat(infoHeader), pixels, NULL);
+    }
+
+    // Convert everything else to 32-bit
+    const size_t total = ((size_t) width) * height * 4;
+    GLubyte* const pixels = new GLubyte[total];
+    try {
+        if (infoHeader.biCompression == BI_RLE8) {
+            vector<GLubyte> indices(((size_t) width) * height);
+            BitmapDecoder::expandRle8(data, size, width, height, &indices[0]);
+            BitmapDecoder::expandPalette(&indices[0], indices.size(), &palette[0], pixels);
+        } else {
+            for (GLsizei y = 0; y < height; ++y) {
+                const GLsizei row = bottomUp ? y : (height - 1 - y);
+                const GLubyte* const src = data + row * stride;
+                GLubyte* const dst = pixels + ((size_t) y) * width * 4;
+                if (infoHeader.biBitCount == 8) {
+                    BitmapDecoder::expandPalette(src, width, &palette[0], dst);
+                } else {
+                    BitmapDecoder::expandBitfields(src, width, infoHeader.biBitCount, infoHeader.masks, dst);
+                }
+            }
+        }
+    } catch (...) {
+        delete[] pixels;
+        throw;
+    }
+    return createBitmap(infoHeader, GL_BGRA, pixels, NULL);
+}
+
+/**
+ * Makes sure 32-bit pixels without real alpha values are opaque.
+ *
+ * @param infoHeader Info header describing the image
+ * @param pixels 32-bit pixels to fix, which must not be in a mapping
+ * @param size Number of bytes of pixels
+ */
+void BitmapReader::fixAlpha(const InfoHeader& infoHeader, GLubyte* const pixels, const size_t size) {
+    if (isMissingAlpha(infoHeader, pixels, size)) {
+        for (size_t i = 3; i < size; i += 4) {
+            pixels[i] = 255;
+        }
+    }
+}
+
+/**
+ * Determines the format of pixels that are used as they are stored in the file.
+ *
+ * @param infoHeader Info header describing the image
+ * @return `GL_BGR` for 24-bit images, otherwise `GL_BGRA`
+ */
+GLenum BitmapReader::getFormat(const InfoHeader& infoHeader) {
+    return (infoHeader.biBitCount == 24) ? GL_BGR : GL_BGRA;
+}
+
+/**
+ * Checks if the rows of an image are stored from the bottom up.
+ *
+ * @param infoHeader Info header to check
+ * @return `true` if the first row in the file is the bottom row of the image
+ */
+bool BitmapReader::isBottomUp(const InfoHeader& infoHeader) {
+    return infoHeader.biHeight > 0;
+}
+
+/**
+ * Checks if a 32-bit image leaves the fourth byte of every pixel unused.
+ *
+ * Uncompressed 32-bit images usually leave it zero, which would make the
+ * whole image transparent.  Images that say they have alpha with a mask, or
+ * that set any alpha byte, use it.
+ *
+ * @param infoHeader Info header describing the image
+ * @param pixels Pixels as stored in the file
+ * @param size Number of bytes of pixels
+ * @return `true` if the pixels should be made opaque
+ */
+bool BitmapReader::isMissingAlpha(const InfoHeader& infoHeader, const GLubyte* const pixels, const size_t size) {
+    if (infoHeader.biBitCount != 32) {
+        return false;
+    } else if (infoHeader.biCompression == BI_BITFIELDS) {
+        return infoHeader.masks[3] == 0;
+    }
+    for (size_t i = 3; i < size; i += 4) {
+        if (pixels[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if the pixels of an image can be used as they are stored in the file.
  *
  * @param infoHeader Info header to check
- * @return `true` if any info header fields indicate the data is compressed
+ * @return `true` if the image is 24-bit, or 32-bit with blue, green, red, and alpha bytes
  */
-bool BitmapReader::isCompressed(const InfoHeader& infoHeader) {
-    return infoHeader.biCompression != 0;
+bool BitmapReader::isDirect(const InfoHeader& infoHeader) {
+    if (infoHeader.biCompression == BI_RGB) {
+        return (infoHeader.biBitCount == 24) || (infoHeader.biBitCount == 32);
+    }
+    return infoHeader.biCompression == BI_BITFIELDS
+            && infoHeader.biBitCount == 32
+            && infoHeader.masks[0] == 0x00ff0000
+            && infoHeader.masks[1] == 0x0000ff00
+            && infoHeader.masks[2] == 0x000000ff
+            && (infoHeader.masks[3] == 0 || infoHeader.masks[3] == 0xff000000);
+}
+
+/**
+ * Checks if the rows in the file and in the bitmap made from it fit in a `GLsizei`.
+ *
+ * @param infoHeader Info header to check
+ * @return `true` if neither the file's pixels nor the bitmap's are larger than `INT_MAX` bytes
+ */
+bool BitmapReader::isRepresentable(const InfoHeader& infoHeader) {
+
+    // Keep strides well inside size_t even where it is 32 bits
+    const size_t width = infoHeader.biWidth;
+    if (width > INT_MAX / 32) {
+        return false;
+    }
+
+    // Check the pixels as stored and as converted to 32-bit
+    if ((infoHeader.biCompression == BI_RLE8) && (infoHeader.biSizeImage > INT_MAX)) {
+        return false;
+    }
+    const size_t height = abs(infoHeader.biHeight);
+    const size_t limit = INT_MAX / height;
+    return (computeStride(infoHeader) <= limit) && (width * 4 <= limit);
 }
 
 /**
- * Checks if info header fields indicate the data is 24-bit.
+ * Checks if the combination of bit count and compression can be read.
  *
  * @param infoHeader Info header to check
- * @return `true` if info header fields indicate the data is 24-bit
+ * @return `true` if the image can be read
  */
-bool BitmapReader::isTwentyFourBit(const InfoHeader& infoHeader) {
-    return infoHeader.biBitCount == 24
-            && infoHeader.biClrUsed == 0
-            && infoHeader.biClrImportant == 0;
+bool BitmapReader::isSupported(const InfoHeader& infoHeader) {
+    switch (infoHeader.biCompression) {
+    case BI_RGB:
+        return infoHeader.biBitCount == 8
+                || infoHeader.biBitCount == 16
+                || infoHeader.biBitCount == 24
+                || infoHeader.biBitCount == 32;
+    case BI_RLE8:
+        return infoHeader.biBitCount == 8
+                && infoHeader.biSizeImage > 0
+                && isBottomUp(infoHeader);
+    case BI_BITFIELDS:
+        return infoHeader.biBitCount == 16 || infoHeader.biBitCount == 32;
+    default:
+        return false;
+    }
 }
 
 /**
@@ -77,9 +300,14 @@ bool BitmapReader::isValidFileHeader(const FileHeader& fileHeader) {
  * @return `true` if the info header is valid
  */
 bool BitmapReader::isValidInfoHeader(const InfoHeader& infoHeader) {
-    return infoHeader.biSize == 40
+    return (infoHeader.biSize == INFO_HEADER_SIZE
+                    || infoHeader.biSize == INFO_HEADER_SIZE + 12
+                    || infoHeader.biSize == INFO_HEADER_SIZE + 16
+                    || infoHeader.biSize == V4_HEADER_SIZE
+                    || infoHeader.biSize == V5_HEADER_SIZE)
             && infoHeader.biWidth > 0
-            && infoHeader.biHeight > 0
+            && infoHeader.biHeight != 0
+            && infoHeader.biHeight != INT_MIN
             && infoHeader.biPlanes == 1;
 }
 
@@ -89,7 +317,7 @@ bool BitmapReader::isValidInfoHeader(const InfoHeader& infoHeader) {
  * @param filename Path to the file to read
  * @return Bitmap containing pixels of and information about the image
  * @throws invalid_argument if file cannot be opened
- * @throws runtime_error if file is not valid, is compressed, is not 24-bit, or cannot be read
+ * @throws runtime_error if file is not valid, is not supported, or cannot be read
  */
 Bitmap BitmapReader::read(const string &filename) {
 
@@ -99,20 +327,50 @@ Bitmap BitmapReader::read(const string &filename) {
         throw invalid_argument("[BitmapReader] File does not exist!");
     }
 
-    // Read in the file
-    const FileHeader fileHeader = readFileHeader(file);
-    const InfoHeader infoHeader = readInfoHeader(file);
-    const GLubyte* pixels = readPixels(file, infoHeader.biSizeImage);
+    // Read the image from it
+    return readStream(file);
+}
 
-    // Make the bitmap
-    Bitmap bitmap;
-    bitmap.pixels = (GLubyte*) pixels;
-    bitmap.format = FORMAT;
-    bitmap.width = infoHeader.biWidth;
-    bitmap.height = infoHeader.biHeight;
-    bitmap.size = infoHeader.biSizeImage;
-    bitmap.alignment = ALIGNMENT;
-    return bitmap;
+/**
+ * Maps an image into memory without copying its pixels.
+ *
+ * The file stays mapped until the returned bitmap and any copies made of it
+ * are destroyed.  Images that need to be converted, including 32-bit images
+ * whose unused alpha must be made opaque, are decoded from the mapping into
+ * memory instead, so the mapping is never written to.
+ *
+ * @param filename Path to the file to map
+ * @return Bitmap referring to the pixels of the image inside the mapping
+ * @throws invalid_argument if file cannot be opened
+ * @throws runtime_error if file is not valid, is not supported, or is too short
+ */
+Bitmap BitmapReader::readMapped(const string& filename) {
+
+    // Map the file
+    auto_ptr<MappedFile> mapping(new MappedFile(filename));
+
+    // Read in the headers and palette
+    MemoryBuffer buffer(mapping->data(), mapping->size());
+    istream stream(&buffer);
+    const FileHeader fileHeader = readFileHeader(stream);
+    const InfoHeader infoHeader = readInfoHeader(stream);
+    const vector<GLuint> palette = readPalette(stream, infoHeader);
+
+    // Find the pixels
+    const size_t size = computeSize(infoHeader);
+    if ((fileHeader.bfOffBits > mapping->size()) || (mapping->size() - fileHeader.bfOffBits < size)) {
+        throw runtime_error("[BitmapReader] All pixels could not be read!");
+    }
+    GLubyte* const data = mapping->data() + fileHeader.bfOffBits;
+
+    // Convert the pixels if they cannot be used directly, fixing alpha in a copy rather than in the mapping
+    if (!isDirect(infoHeader) || !isBottomUp(infoHeader) || isMissingAlpha(infoHeader, data, size)) {
+        return decode(infoHeader, palette, data, size);
+    }
+
+    // Make the bitmap, handing it the mapping
+    MappedFile* const owner = mapping.release();
+    return createBitmap(infoHeader, getFormat(infoHeader), data, owner);
 }
 
 /**
@@ -122,7 +380,7 @@ Bitmap BitmapReader::read(const string &filename) {
  * @return File header that was read
  * @throws runtime_error if not a valid file header
  */
-BitmapReader::FileHeader BitmapReader::readFileHeader(ifstream& file) {
+BitmapReader::FileHeader BitmapReader::readFileHeader(istream& file) {
 
     FileHeader fileHeader;
 
@@ -140,13 +398,13 @@ BitmapReader::FileHeader BitmapReader::readFileHeader(ifstream& file) {
 }
 
 /**
- * Reads just the info header section.
+ * Reads just the info header section, including any color masks.
  *
  * @param file File to read from
  * @return InfoHeader that was read
- * @throws runtime_error if not a valid info header, is compressed, or is not 24-bit
+ * @throws runtime_error if not a valid info header or not supported
  */
-BitmapReader::InfoHeader BitmapReader::readInfoHeader(ifstream& file) {
+BitmapReader::InfoHeader BitmapReader::readInfoHeader(istream& file) {
 
     InfoHeader infoHeader;
 
@@ -162,21 +420,105 @@ BitmapReader::InfoHeader BitmapReader::readInfoHeader(ifstream& file) {
     file.read((char*) &infoHeader.biClrUsed, 4);
     file.read((char*) &infoHeader.biClrImportant, 4);
 
-    if (!isValidInfoHeader(infoHeader)) {
+    if (!file || !isValidInfoHeader(infoHeader)) {
         throw runtime_error("[BitmapReader] Not a valid bitmap info header!");
     }
 
-    if (isCompressed(infoHeader)) {
-        throw runtime_error("[BitmapReader] Only supports uncompressed data.");
+    if (!isSupported(infoHeader)) {
+        throw runtime_error("[BitmapReader] Unsupported bit count or compression.");
+    }
+
+    if (!isRepresentable(infoHeader)) {
+        throw runtime_error("[BitmapReader] Image is too large!");
     }
 
-    if (!isTwentyFourBit(infoHeader)) {
-        throw runtime_error("[BitmapReader] Only supports 24-bit data.");
+    // Read the masks, which follow a plain info header or are part of a larger one
+    GLuint masks[4] = { 0, 0, 0, 0 };
+    if (infoHeader.biSize > INFO_HEADER_SIZE) {
+        const int count = (infoHeader.biSize == INFO_HEADER_SIZE + 12) ? 3 : 4;
+        file.read((char*) masks, count * 4);
+        file.ignore(infoHeader.biSize - INFO_HEADER_SIZE - count * 4);
+    } else if (infoHeader.biCompression == BI_BITFIELDS) {
+        file.read((char*) masks, 12);
+    }
+
+    // Use the masks only if the compression says to
+    if (infoHeader.biCompression == BI_BITFIELDS) {
+        memcpy(infoHeader.masks, masks, sizeof(masks));
+    } else if (infoHeader.biBitCount == 16) {
+        infoHeader.masks[0] = 0x7c00;
+        infoHeader.masks[1] = 0x03e0;
+        infoHeader.masks[2] = 0x001f;
+        infoHeader.masks[3] = 0;
+    } else {
+        infoHeader.masks[0] = 0x00ff0000;
+        infoHeader.masks[1] = 0x0000ff00;
+        infoHeader.masks[2] = 0x000000ff;
+        infoHeader.masks[3] = 0;
     }
 
     return infoHeader;
 }
 
+/**
+ * Reads an image that is already in memory, such as one compiled into the program.
+ *
+ * The pixels are copied, so the memory does not need to outlive the bitmap.
+ *
+ * @param data Contents of a bitmap file
+ * @param size Number of bytes in the contents
+ * @return Bitmap containing pixels of and information about the image
+ * @throws invalid_argument if data is `NULL`
+ * @throws runtime_error if contents are not valid, are not supported, or are too short
+ */
+Bitmap BitmapReader::readMemory(const GLubyte* const data, const size_t size) {
+
+    if (data == NULL) {
+        throw invalid_argument("[BitmapReader] Data is NULL!");
+    }
+
+    // Read the image through a stream over the memory
+    MemoryBuffer buffer(data, size);
+    istream stream(&buffer);
+    return readStream(stream);
+}
+
+/**
+ * Reads the color table of a paletted image.
+ *
+ * @param file File to read from, positioned just after the info header
+ * @param infoHeader Info header describing the image
+ * @return 256 palette entries, or no entries if the image is not paletted
+ * @throws runtime_error if the color table is too large or cannot be read
+ */
+vector<GLuint> BitmapReader::readPalette(istream& file, const InfoHeader& infoHeader) {
+
+    vector<GLuint> palette;
+    if (infoHeader.biBitCount != 8) {
+        return palette;
+    }
+
+    // Check the number of colors
+    const GLuint count = (infoHeader.biClrUsed == 0) ? 256 : infoHeader.biClrUsed;
+    if (count > 256) {
+        throw runtime_error("[BitmapReader] Too many colors in palette!");
+    }
+
+    // Read the colors, which are stored as blue, green, red, and an unused byte
+    GLubyte entries[256 * 4];
+    file.read((char*) entries, count * 4);
+    if (file.gcount() != count * 4) {
+        throw runtime_error("[BitmapReader] Palette could not be read!");
+    }
+
+    // Convert them, leaving any unused entries black
+    palette.resize(256, BitmapDecoder::toPaletteEntry(0, 0, 0));
+    for (GLuint i = 0; i < count; ++i) {
+        palette[i] = BitmapDecoder::toPaletteEntry(entries[i * 4], entries[i * 4 + 1], entries[i * 4 + 2]);
+    }
+    return palette;
+}
+
 /**
  * Reads the pixel data into memory.
  *
@@ -185,14 +527,72 @@ BitmapReader::InfoHeader BitmapReader::readInfoHeader(ifstream& file) {
  * @return Pointer to a byte array containing the pixels
  * @throws runtime_error if improper amount of pixels were read
  */
-GLubyte* BitmapReader::readPixels(ifstream& file, const size_t size) {
+GLubyte* BitmapReader::readPixels(istream& file, const size_t size) {
     GLubyte* const pixels = new GLubyte[size];
     file.read((char*) pixels, size);
-    if (file.gcount() != size) {
+    if (((size_t) file.gcount()) != size) {
+        delete[] pixels;
         throw runtime_error("[BitmapReader] All pixels could not be read!");
     }
     return pixels;
 }
 
+/**
+ * Reads an image from a stream.
+ *
+ * @param stream Stream positioned at the start of the image
+ * @return Bitmap containing pixels of and information about the image
+ * @throws runtime_error if image is not valid, is not supported, or cannot be read
+ */
+Bitmap BitmapReader::readStream(istream& stream) {
+
+    // Read in the headers and palette
+    const FileHeader fileHeader = readFileHeader(stream);
+    const InfoHeader infoHeader = readInfoHeader(stream);
+    const vector<GLuint> palette = readPalette(stream, infoHeader);
+
+    // Read in the pixels, which may not directly follow the headers
+    stream.seekg(fileHeader.bfOffBits);
+    const size_t size = computeSize(infoHeader);
+
+    // Use the pixels directly if possible
+    if (isDirect(infoHeader) && isBottomUp(infoHeader)) {
+        GLubyte* const pixels = readPixels(stream, size);
+        fixAlpha(infoHeader, pixels, size);
+        return createBitmap(infoHeader, getFormat(infoHeader), pixels, NULL);
+    }
+
+    // Otherwise read them into temporary memory and convert them
+    vector<GLubyte> data(size);
+    stream.read((char*) &data[0], size);
+    if (((size_t) stream.gcount()) != size) {
+        throw runtime_error("[BitmapReader] All pixels could not be read!");
+    }
+    return decode(infoHeader, palette, &data[0], size);
+}
+
+// HELPERS
+
+BitmapReader::MemoryBuffer::MemoryBuffer(const GLubyte* const data, const size_t size) {
+    char* const begin = (char*) data;
+    setg(begin, begin, begin + size);
+}
+
+BitmapReader::MemoryBuffer::pos_type BitmapReader::MemoryBuffer::seekoff(off_type off,
+                                                                         ios_base::seekdir dir,
+                                                                         ios_base::openmode) {
+    char* const base = (dir == ios_base::beg) ? eback() : ((dir == ios_base::cur) ? gptr() : egptr());
+    if ((base + off < eback()) || (base + off > egptr())) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), base + off, egptr());
+    return pos_type(gptr() - eback());
+}
+
+BitmapReader::MemoryBuffer::pos_type BitmapReader::MemoryBuffer::seekpos(pos_type pos,
+                                                                         ios_base::openmode which) {
+    return seekoff(off_type(pos), ios_base::beg, which);
+}
+
 
 } /* namespace Glycerin */
@@ -18,9 +18,11 @@
 #ifndef GLYCERIN_BITMAPREADER_HPP
 #define GLYCERIN_BITMAPREADER_HPP
 #include "glycerin/common.h"
-#include <fstream>
 #include <cstring>
+#include <istream>
+#include <streambuf>
 #include <string>
+#include <vector>
 #include "glycerin/Bitmap.hxx"
 namespace Glycerin {
 
@@ -36,10 +38,32 @@ namespace Glycerin {
  * Bitmap bitmap = reader.read("image.bmp");
  * ~~~
  *
+ * To avoid copying the pixels out of the file, use [read-mapped] instead.
+ * The file is mapped into memory and the bitmap refers to the pixels in the
+ * mapping directly, so they are only loaded from the page cache when they
+ * are used, for example by `glTexImage2D`.
+ *
+ * ~~~
+ * Bitmap bitmap = reader.readMapped("image.bmp");
+ * ~~~
+ *
+ * Images that are already in memory, such as ones compiled into the program,
+ * can be read with [read-memory].
+ *
+ * Uncompressed 24-bit and 32-bit images are supported, as well as 16-bit and
+ * 32-bit images using `BI_BITFIELDS`, 8-bit paletted images, and 8-bit
+ * run-length encoded images.  Rows may be stored from the bottom up or from
+ * the top down.  Bottom-up images that are 24-bit or plain 32-bit keep their
+ * pixels as they are in the file, with `GL_BGR` or `GL_BGRA` as the format.
+ * Everything else is converted to 32-bit `GL_BGRA` pixels ordered from the
+ * bottom up, so any bitmap can be passed directly to `glTexImage2D`.
+ *
  * To use the resulting bitmap, see [bitmap].
  *
  * [bitmap]: @ref Bitmap "Bitmap"
  * [read]: @ref read(const std::string&) "read(const std::string&)"
+ * [read-mapped]: @ref readMapped(const std::string&) "readMapped(const std::string&)"
+ * [read-memory]: @ref readMemory(const GLubyte*, size_t) "readMemory(const GLubyte*, size_t)"
  */
 class BitmapReader {
 public:
@@ -47,8 +71,11 @@ public:
     BitmapReader();
     virtual ~BitmapReader();
     Bitmap read(const std::string& filename);
+    Bitmap readMapped(const std::string& filename);
+    Bitmap readMemory(const GLubyte* data, size_t size);
 private:
 // Types
+    class MemoryBuffer;
     struct FileHeader {
         char bfType[2];
         GLuint bfSize;
@@ -58,8 +85,8 @@ private:
     };
     struct InfoHeader {
         GLuint biSize;
-        GLuint biWidth;
-        GLuint biHeight;
+        GLint biWidth;
+        GLint biHeight;
         GLushort biPlanes;
         GLushort biBitCount;
         GLuint biCompression;
@@ -68,18 +95,47 @@ private:
         GLuint biYPelsPerMeter;
         GLuint biClrUsed;
         GLuint biClrImportant;
+        GLuint masks[4];
     };
 // Constants
     static const GLint ALIGNMENT = 4;
-    static const GLenum FORMAT = GL_BGR;
+    static const GLuint BI_RGB = 0;
+    static const GLuint BI_RLE8 = 1;
+    static const GLuint BI_BITFIELDS = 3;
+    static const GLuint INFO_HEADER_SIZE = 40;
+    static const GLuint V4_HEADER_SIZE = 108;
+    static const GLuint V5_HEADER_SIZE = 124;
 // Methods
-    static bool isCompressed(const InfoHeader& infoHeader);
-    static bool isTwentyFourBit(const InfoHeader& infoHeader);
+    static size_t computeSize(const InfoHeader& infoHeader);
+    static size_t computeStride(const InfoHeader& infoHeader);
+    static Bitmap createBitmap(const InfoHeader& infoHeader, GLenum format, GLubyte* pixels, MappedFile* mapping);
+    static Bitmap decode(const InfoHeader& infoHeader, const std::vector<GLuint>& palette, const GLubyte* data, size_t size);
+    static void fixAlpha(const InfoHeader& infoHeader, GLubyte* pixels, size_t size);
+    static GLenum getFormat(const InfoHeader& infoHeader);
+    static bool isBottomUp(const InfoHeader& infoHeader);
+    static bool isDirect(const InfoHeader& infoHeader);
+    static bool isMissingAlpha(const InfoHeader& infoHeader, const GLubyte* pixels, size_t size);
+    static bool isRepresentable(const InfoHeader& infoHeader);
+    static bool isSupported(const InfoHeader& infoHeader);
     static bool isValidFileHeader(const FileHeader& fileHeader);
     static bool isValidInfoHeader(const InfoHeader& infoHeader);
-    static FileHeader readFileHeader(std::ifstream& file);
-    static InfoHeader readInfoHeader(std::ifstream& file);
-    static GLubyte* readPixels(std::ifstream& file, size_t size);
+    static FileHeader readFileHeader(std::istream& stream);
+    static InfoHeader readInfoHeader(std::istream& stream);
+    static std::vector<GLuint> readPalette(std::istream& stream, const InfoHeader& infoHeader);
+    static GLubyte* readPixels(std::istream& stream, size_t size);
+    static Bitmap readStream(std::istream& stream);
+};
+
+
+/**
+ * Stream buffer reading from a block of memory.
+ */
+class BitmapReader::MemoryBuffer : public std::streambuf {
+public:
+    MemoryBuffer(const GLubyte* data, size_t size);
+protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
 };
 
 } /* namespace Glycerin */
@@ -20,7 +20,12 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 #include "glycerin/BitmapReader.hxx"
 using namespace std;
 namespace Glycerin {
@@ -70,11 +75,358 @@ public:
         CPPUNIT_ASSERT_EQUAL((GLubyte) 0, arr[13]); // R
     }
 
+    /**
+     * Ensures readMapped gives the same results as read.
+     */
+    void testReadMapped() {
+
+        // Read in the file both ways
+        BitmapReader reader;
+        const Bitmap expected = reader.read("glycerin/crate.bmp");
+        const Bitmap actual = reader.readMapped("glycerin/crate.bmp");
+
+        // Check width, height, format, and size
+        CPPUNIT_ASSERT_EQUAL(expected.getWidth(), actual.getWidth());
+        CPPUNIT_ASSERT_EQUAL(expected.getHeight(), actual.getHeight());
+        CPPUNIT_ASSERT_EQUAL(expected.getFormat(), actual.getFormat());
+        CPPUNIT_ASSERT_EQUAL(expected.getSize(), actual.getSize());
+
+        // Check pixel data
+        const GLsizei size = expected.getSize();
+        GLubyte* const e = new GLubyte[size];
+        GLubyte* const a = new GLubyte[size];
+        expected.getPixels(e, size);
+        actual.getPixels(a, size);
+        CPPUNIT_ASSERT(memcmp(e, a, size) == 0);
+        delete[] e;
+        delete[] a;
+    }
+
+    /**
+     * Ensures readMemory gives the same results as read.
+     */
+    void testReadMemory() {
+
+        // Read in the file both ways
+        BitmapReader reader;
+        const Bitmap expected = reader.read("glycerin/crate.bmp");
+        const vector<GLubyte> contents = readContents("glycerin/crate.bmp");
+        const Bitmap actual = reader.readMemory(&contents[0], contents.size());
+
+        // Check format, size, and pixel data
+        CPPUNIT_ASSERT_EQUAL(expected.getWidth(), actual.getWidth());
+        CPPUNIT_ASSERT_EQUAL(expected.getFormat(), actual.getFormat());
+        CPPUNIT_ASSERT_EQUAL(expected.getSize(), actual.getSize());
+        vector<GLubyte> e(expected.getSize());
+        vector<GLubyte> a(actual.getSize());
+        expected.getPixels(&e[0], e.size());
+        actual.getPixels(&a[0], a.size());
+        CPPUNIT_ASSERT(e == a);
+    }
+
+    /**
+     * Ensures readMemory throws if the contents are cut short.
+     */
+    void testReadMemoryWithTruncatedData() {
+        BitmapReader reader;
+        const vector<GLubyte> contents = readContents("glycerin/crate.bmp");
+        CPPUNIT_ASSERT_THROW(reader.readMemory(&contents[0], contents.size() / 2), runtime_error);
+    }
+
+    /**
+     * Ensures readMapped throws if the file does not exist.
+     */
+    void testReadMappedWithMissingFile() {
+        BitmapReader reader;
+        CPPUNIT_ASSERT_THROW(reader.readMapped("glycerin/missing.bmp"), invalid_argument);
+    }
+
+    /**
+     * Ensures copies of a bitmap share its pixels and outlive it.
+     */
+    void testCopy() {
+        BitmapReader reader;
+        Bitmap* const original = new Bitmap(reader.read("glycerin/rgbw.bmp"));
+        const Bitmap copy(*original);
+        delete original;
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 16, copy.getSize());
+        GLubyte arr[16];
+        copy.getPixels(arr, 16);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, arr[2]);
+    }
+
+    /**
+     * Ensures assigning a bitmap releases the old pixels and handles self-assignment.
+     */
+    void testAssign() {
+        BitmapReader reader;
+        Bitmap bitmap = reader.readMapped("glycerin/rgbw.bmp");
+        const Bitmap other = reader.read("glycerin/crate.bmp");
+        Bitmap& self = bitmap;
+        bitmap = self;
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 16, bitmap.getSize());
+        bitmap = other;
+        CPPUNIT_ASSERT_EQUAL(other.getSize(), bitmap.getSize());
+        CPPUNIT_ASSERT_EQUAL(other.getWidth(), bitmap.getWidth());
+    }
+
+    /**
+     * Ensures swap exchanges the contents of two bitmaps.
+     */
+    void testSwap() {
+        BitmapReader reader;
+        Bitmap small = reader.read("glycerin/rgbw.bmp");
+        Bitmap large = reader.read("glycerin/crate.bmp");
+        const GLsizei size = large.getSize();
+        small.swap(large);
+        CPPUNIT_ASSERT_EQUAL(size, small.getSize());
+        CPPUNIT_ASSERT_EQUAL((GLsizei) 16, large.getSize());
+        GLubyte arr[16];
+        large.getPixels(arr, 16);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, arr[2]);
+    }
+
+    /**
+     * Ensures read converts 8-bit paletted images.
+     */
+    void testReadWithPalette() {
+
+        // Make a 2x1 image using the second and third colors
+        vector<GLubyte> extra;
+        appendColor(extra, 0, 0, 0);
+        appendColor(extra, 10, 20, 30);
+        appendColor(extra, 40, 50, 60);
+        const GLubyte data[] = { 1, 2, 0, 0 };
+        writeFile(2, 1, 8, 0, 3, extra, data, sizeof(data));
+
+        // Read it and check the colors
+        const vector<GLubyte> pixels = readFile(GL_BGRA, 8);
+        const GLubyte expected[] = { 10, 20, 30, 255, 40, 50, 60, 255 };
+        CPPUNIT_ASSERT(memcmp(expected, &pixels[0], 8) == 0);
+    }
+
+    /**
+     * Ensures read and readMapped decompress 8-bit run-length encoded images.
+     */
+    void testReadWithRle8() {
+
+        // Make a 2x2 image with one color in the bottom row and another in the top
+        vector<GLubyte> extra;
+        appendColor(extra, 1, 2, 3);
+        appendColor(extra, 4, 5, 6);
+        const GLubyte data[] = { 2, 0, 0, 0, 2, 1, 0, 1 };
+        writeFile(2, 2, 8, 1, 2, extra, data, sizeof(data));
+
+        // Read it and check the colors
+        const vector<GLubyte> pixels = readFile(GL_BGRA, 16);
+        const GLubyte expected[] = { 1, 2, 3, 255, 1, 2, 3, 255, 4, 5, 6, 255, 4, 5, 6, 255 };
+        CPPUNIT_ASSERT(memcmp(expected, &pixels[0], 16) == 0);
+    }
+
+    /**
+     * Ensures read makes 32-bit images opaque when none of their alpha values are set.
+     */
+    void testReadWithThirtyTwoBit() {
+        const GLubyte data[] = { 1, 2, 3, 0, 4, 5, 6, 0 };
+        writeFile(2, 1, 32, 0, 0, vector<GLubyte>(), data, sizeof(data));
+        const vector<GLubyte> pixels = readFile(GL_BGRA, 8);
+        const GLubyte expected[] = { 1, 2, 3, 255, 4, 5, 6, 255 };
+        CPPUNIT_ASSERT(memcmp(expected, &pixels[0], 8) == 0);
+    }
+
+    /**
+     * Ensures readMapped makes alpha opaque in a copy instead of in the file.
+     */
+    void testReadMappedWithThirtyTwoBit() {
+        const GLubyte data[] = { 1, 2, 3, 0, 4, 5, 6, 0 };
+        writeFile(2, 1, 32, 0, 0, vector<GLubyte>(), data, sizeof(data));
+        const vector<GLubyte> before = readContents(FILENAME);
+        {
+            BitmapReader reader;
+            const Bitmap bitmap = reader.readMapped(FILENAME);
+            GLubyte pixels[8];
+            bitmap.getPixels(pixels, 8);
+            CPPUNIT_ASSERT_EQUAL((GLubyte) 255, pixels[3]);
+        }
+        const vector<GLubyte> after = readContents(FILENAME);
+        remove(FILENAME);
+        CPPUNIT_ASSERT(before == after);
+    }
+
+    /**
+     * Ensures read rejects images whose rows would not fit in a bitmap.
+     */
+    void testReadWithHugeWidth() {
+        const GLubyte data[] = { 0, 0, 0, 0 };
+        writeFile(0x08000001, 1, 32, 0, 0, vector<GLubyte>(), data, sizeof(data));
+        BitmapReader reader;
+        CPPUNIT_ASSERT_THROW(reader.read(FILENAME), runtime_error);
+        CPPUNIT_ASSERT_THROW(reader.readMapped(FILENAME), runtime_error);
+        writeFile(0x10000, 0x10000, 24, 0, 0, vector<GLubyte>(), data, sizeof(data));
+        CPPUNIT_ASSERT_THROW(reader.read(FILENAME), runtime_error);
+        remove(FILENAME);
+    }
+
+    /**
+     * Ensures read converts 16-bit images with 5-6-5 bitfields.
+     */
+    void testReadWithBitfields() {
+
+        // Make a 2x1 image with red and blue pixels
+        vector<GLubyte> extra;
+        appendInt(extra, 0xf800);
+        appendInt(extra, 0x07e0);
+        appendInt(extra, 0x001f);
+        const GLubyte data[] = { 0x00, 0xf8, 0x1f, 0x00 };
+        writeFile(2, 1, 16, 3, 0, extra, data, sizeof(data));
+
+        // Read it and check the colors
+        const vector<GLubyte> pixels = readFile(GL_BGRA, 8);
+        const GLubyte expected[] = { 0, 0, 255, 255, 255, 0, 0, 255 };
+        CPPUNIT_ASSERT(memcmp(expected, &pixels[0], 8) == 0);
+    }
+
+    /**
+     * Ensures read flips images stored from the top down.
+     */
+    void testReadWithTopDown() {
+        const GLubyte data[] = { 1, 2, 3, 0, 4, 5, 6, 0 };
+        writeFile(1, -2, 24, 0, 0, vector<GLubyte>(), data, sizeof(data));
+        const vector<GLubyte> pixels = readFile(GL_BGR, 8);
+        const GLubyte expected[] = { 4, 5, 6, 0, 1, 2, 3, 0 };
+        CPPUNIT_ASSERT(memcmp(expected, &pixels[0], 8) == 0);
+    }
+
+    /**
+     * Ensures read throws for compression it does not support.
+     */
+    void testReadWithUnsupportedCompression() {
+        const GLubyte data[] = { 0, 0, 0, 0 };
+        writeFile(1, 1, 4, 2, 0, vector<GLubyte>(), data, sizeof(data));
+        BitmapReader reader;
+        CPPUNIT_ASSERT_THROW(reader.read(FILENAME), runtime_error);
+        remove(FILENAME);
+    }
+
     CPPUNIT_TEST_SUITE(BitmapReaderTest);
     CPPUNIT_TEST(testRead);
+    CPPUNIT_TEST(testReadMapped);
+    CPPUNIT_TEST(testReadMappedWithMissingFile);
+    CPPUNIT_TEST(testReadMemory);
+    CPPUNIT_TEST(testReadMemoryWithTruncatedData);
+    CPPUNIT_TEST(testReadWithPalette);
+    CPPUNIT_TEST(testReadWithRle8);
+    CPPUNIT_TEST(testReadWithThirtyTwoBit);
+    CPPUNIT_TEST(testReadMappedWithThirtyTwoBit);
+    CPPUNIT_TEST(testReadWithHugeWidth);
+    CPPUNIT_TEST(testReadWithBitfields);
+    CPPUNIT_TEST(testReadWithTopDown);
+    CPPUNIT_TEST(testReadWithUnsupportedCompression);
+    CPPUNIT_TEST(testCopy);
+    CPPUNIT_TEST(testAssign);
+    CPPUNIT_TEST(testSwap);
     CPPUNIT_TEST_SUITE_END();
+private:
+    static const char* FILENAME;
+
+    /**
+     * Adds a palette entry to a byte array.
+     */
+    static void appendColor(vector<GLubyte>& bytes, GLubyte blue, GLubyte green, GLubyte red) {
+        bytes.push_back(blue);
+        bytes.push_back(green);
+        bytes.push_back(red);
+        bytes.push_back(0);
+    }
+
+    /**
+     * Adds a little-endian four-byte value to a byte array.
+     */
+    static void appendInt(vector<GLubyte>& bytes, GLuint value) {
+        for (int i = 0; i < 4; ++i) {
+            bytes.push_back((value >> (i * 8)) & 0xff);
+        }
+    }
+
+    /**
+     * Adds a little-endian two-byte value to a byte array.
+     */
+    static void appendShort(vector<GLubyte>& bytes, GLushort value) {
+        bytes.push_back(value & 0xff);
+        bytes.push_back(value >> 8);
+    }
+
+    /**
+     * Returns every byte of a file.
+     */
+    static vector<GLubyte> readContents(const char* filename) {
+        ifstream file(filename, ios_base::binary);
+        return vector<GLubyte>((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    }
+
+    /**
+     * Reads the test file every way, checks they match, and returns its pixels.
+     */
+    static vector<GLubyte> readFile(GLenum format, GLsizei size) {
+        BitmapReader reader;
+        const Bitmap bitmap = reader.read(FILENAME);
+        const Bitmap mapped = reader.readMapped(FILENAME);
+        const vector<GLubyte> contents = readContents(FILENAME);
+        const Bitmap memory = reader.readMemory(&contents[0], contents.size());
+        remove(FILENAME);
+        CPPUNIT_ASSERT_EQUAL(format, bitmap.getFormat());
+        CPPUNIT_ASSERT_EQUAL(size, bitmap.getSize());
+        CPPUNIT_ASSERT_EQUAL(format, mapped.getFormat());
+        CPPUNIT_ASSERT_EQUAL(size, mapped.getSize());
+        vector<GLubyte> pixels(size);
+        vector<GLubyte> other(size);
+        bitmap.getPixels(&pixels[0], size);
+        mapped.getPixels(&other[0], size);
+        CPPUNIT_ASSERT(pixels == other);
+        CPPUNIT_ASSERT_EQUAL(format, memory.getFormat());
+        memory.getPixels(&other[0], size);
+        CPPUNIT_ASSERT(pixels == other);
+        return pixels;
+    }
+
+    /**
+     * Writes a bitmap file with a plain info header to the test file.
+     */
+    static void writeFile(GLint width,
+                          GLint height,
+                          GLushort bitCount,
+                          GLuint compression,
+                          GLuint colorsUsed,
+                          const vector<GLubyte>& extra,
+                          const GLubyte* data,
+                          size_t size) {
+        vector<GLubyte> bytes;
+        bytes.push_back('B');
+        bytes.push_back('M');
+        appendInt(bytes, 54 + extra.size() + size);
+        appendShort(bytes, 0);
+        appendShort(bytes, 0);
+        appendInt(bytes, 54 + extra.size());
+        appendInt(bytes, 40);
+        appendInt(bytes, width);
+        appendInt(bytes, height);
+        appendShort(bytes, 1);
+        appendShort(bytes, bitCount);
+        appendInt(bytes, compression);
+        appendInt(bytes, size);
+        appendInt(bytes, 2835);
+        appendInt(bytes, 2835);
+        appendInt(bytes, colorsUsed);
+        appendInt(bytes, 0);
+        bytes.insert(bytes.end(), extra.begin(), extra.end());
+        bytes.insert(bytes.end(), data, data + size);
+        ofstream file(FILENAME, ios_base::binary);
+        file.write((const char*) &bytes[0], bytes.size());
+    }
 };
 
+const char* BitmapReaderTest::FILENAME = "BitmapReaderTest.bmp";
+
 } /* namespace Glycerin */
 
 int main(int argc, char* argv[]) {
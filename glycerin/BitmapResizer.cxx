@@ -0,0 +1,375 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "glycerin/BitmapResizer.hxx"
+#include "glycerin/Parallel.hxx"
+#include "glycerin/Simd.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Source samples and their weights for each sample along one axis.
+ */
+struct BitmapResizer::Weights {
+    GLsizei srcSize;
+    int taps;
+    vector<GLint> first;
+    vector<GLfloat> values;
+};
+
+/**
+ * Filters a range of rows horizontally into floats.
+ */
+class BitmapResizer::RowTask : public Parallel::Task {
+public:
+    RowTask(const Bitmap& bitmap, const Weights& weights, GLsizei width, vector<GLfloat>& dst) :
+            bitmap(bitmap), weights(weights), width(width), dst(dst) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Bitmap& bitmap;
+    const Weights& weights;
+    const GLsizei width;
+    vector<GLfloat>& dst;
+};
+
+/**
+ * Filters a range of rows vertically and stores them in a bitmap.
+ */
+class BitmapResizer::ColumnTask : public Parallel::Task {
+public:
+    ColumnTask(const vector<GLfloat>& src, const Weights& weights, Bitmap& bitmap) :
+            src(src), weights(weights), bitmap(bitmap) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const vector<GLfloat>& src;
+    const Weights& weights;
+    Bitmap& bitmap;
+};
+
+/**
+ * Constructs a bitmap resizer with default settings.
+ */
+BitmapResizer::BitmapResizer() :
+        _filter(BILINEAR) {
+    // empty
+}
+
+/**
+ * Destroys the bitmap resizer.
+ */
+BitmapResizer::~BitmapResizer() {
+    // empty
+}
+
+/**
+ * Computes the weights for resizing one axis.
+ *
+ * When shrinking, the filter is stretched to cover every source sample that
+ * falls inside each destination sample.
+ *
+ * @param filter Filter to use
+ * @param srcSize Number of samples along the axis in the original
+ * @param dstSize Number of samples along the axis in the result
+ * @return Weights for each sample in the result, summing to one
+ */
+BitmapResizer::Weights BitmapResizer::createWeights(const Filter filter,
+                                                    const GLsizei srcSize,
+                                                    const GLsizei dstSize) {
+
+    const double ratio = ((double) srcSize) / dstSize;
+    const double scale = max(ratio, 1.0);
+    const double support = getSupport(filter) * scale;
+
+    Weights weights;
+    weights.srcSize = srcSize;
+    weights.taps = (int) ceil(2 * support) + 1;
+    weights.first.resize(dstSize);
+    weights.values.resize(((size_t) dstSize) * weights.taps);
+
+    for (GLsizei x = 0; x < dstSize; ++x) {
+        const double center = (x + 0.5) * ratio - 0.5;
+        const GLint first = (GLint) floor(center - support);
+        GLfloat* const values = &weights.values[((size_t) x) * weights.taps];
+        double sum = 0;
+        for (int k = 0; k < weights.taps; ++k) {
+            const double value = evaluate(filter, (first + k - center) / scale);
+            values[k] = (GLfloat) value;
+            sum += value;
+        }
+        for (int k = 0; k < weights.taps; ++k) {
+            values[k] = (GLfloat) (values[k] / sum);
+        }
+        weights.first[x] = first;
+    }
+    return weights;
+}
+
+/**
+ * Evaluates a filter.
+ *
+ * @param filter Filter to evaluate
+ * @param x Distance from the center of the filter, in source pixels when enlarging
+ * @return Unnormalized weight of the filter at that distance
+ */
+double BitmapResizer::evaluate(const Filter filter, const double x) {
+    const double d = fabs(x);
+    switch (filter) {
+    case BOX:
+        return (d < 0.5) ? 1.0 : ((d == 0.5) ? 0.5 : 0.0);
+    case BILINEAR:
+        return (d < 1.0) ? (1.0 - d) : 0.0;
+    default:
+        if (d < 1e-6) {
+            return 1.0;
+        } else if (d >= 3.0) {
+            return 0.0;
+        }
+        return (3.0 * sin(M_PI * d) * sin(M_PI * d / 3.0)) / (M_PI * M_PI * d * d);
+    }
+}
+
+/**
+ * Changes the filter used to compute each pixel.
+ *
+ * @param filter Filter to use
+ * @return Reference to this resizer to support chaining
+ */
+BitmapResizer& BitmapResizer::filter(const Filter filter) {
+    _filter = filter;
+    return (*this);
+}
+
+/**
+ * Determines how far from its center a filter reaches.
+ *
+ * @param filter Filter to check
+ * @return Radius of the filter in source pixels when enlarging
+ */
+double BitmapResizer::getSupport(const Filter filter) {
+    switch (filter) {
+    case BOX:
+        return 0.5;
+    case BILINEAR:
+        return 1.0;
+    default:
+        return 3.0;
+    }
+}
+
+/**
+ * Makes a copy of a bitmap at another size.
+ *
+ * @param bitmap Bitmap to resize
+ * @param width Size of the result in the X direction
+ * @param height Size of the result in the Y direction
+ * @return Resized copy of the bitmap
+ * @throws invalid_argument if the bitmap is empty, or width or height is less than one
+ */
+Bitmap BitmapResizer::resize(const Bitmap& bitmap, const GLsizei width, const GLsizei height) const {
+
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[BitmapResizer] Bitmap is empty!");
+    } else if ((width < 1) || (height < 1)) {
+        throw invalid_argument("[BitmapResizer] Width and height must be positive!");
+    }
+
+    // Filter horizontally into floats
+    const Weights weightsX = createWeights(_filter, bitmap.width, width);
+    const size_t bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    vector<GLfloat> narrow(((size_t) width) * bitmap.height * bytesPerPixel);
+    RowTask rowTask(bitmap, weightsX, width, narrow);
+    Parallel::forEach(bitmap.height, rowTask, 16);
+
+    // Filter vertically into a new bitmap
+    const GLsizei stride = ((width * bytesPerPixel + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+    Bitmap result;
+    result.setPixels(new GLubyte[((size_t) stride) * height], NULL);
+    result.format = bitmap.format;
+    result.width = width;
+    result.height = height;
+    result.size = stride * height;
+    result.alignment = ALIGNMENT;
+    const Weights weightsY = createWeights(_filter, bitmap.height, height);
+    ColumnTask columnTask(narrow, weightsY, result);
+    Parallel::forEach(height, columnTask, 4);
+    return result;
+}
+
+/**
+ * Makes a copy of a bitmap shrunk to fit inside a size, keeping its proportions.
+ *
+ * Bitmaps that already fit are returned as they are.
+ *
+ * @param bitmap Bitmap to resize
+ * @param maxWidth Largest size of the result in the X direction
+ * @param maxHeight Largest size of the result in the Y direction
+ * @return Bitmap no larger than the size, at least one pixel in each direction
+ * @throws invalid_argument if the bitmap is empty, or maxWidth or maxHeight is less than one
+ */
+Bitmap BitmapResizer::resizeToFit(const Bitmap& bitmap, const GLsizei maxWidth, const GLsizei maxHeight) const {
+
+    if ((maxWidth < 1) || (maxHeight < 1)) {
+        throw invalid_argument("[BitmapResizer] Width and height must be positive!");
+    } else if ((bitmap.width <= maxWidth) && (bitmap.height <= maxHeight)) {
+        return bitmap;
+    }
+
+    const double scale = min(((double) maxWidth) / bitmap.width, ((double) maxHeight) / bitmap.height);
+    const GLsizei width = max(1, min(maxWidth, (GLsizei) (bitmap.width * scale + 0.5)));
+    const GLsizei height = max(1, min(maxHeight, (GLsizei) (bitmap.height * scale + 0.5)));
+    return resize(bitmap, width, height);
+}
+
+/**
+ * Makes a copy of a bitmap enlarged so each side is a power of two.
+ *
+ * Bitmaps that already are are returned as they are.
+ *
+ * @param bitmap Bitmap to resize
+ * @return Bitmap whose width and height are the smallest powers of two not less than the original's
+ * @throws invalid_argument if the bitmap is empty
+ */
+Bitmap BitmapResizer::resizeToPowerOfTwo(const Bitmap& bitmap) const {
+
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[BitmapResizer] Bitmap is empty!");
+    }
+
+    GLsizei width = 1;
+    while (width < bitmap.width) {
+        width *= 2;
+    }
+    GLsizei height = 1;
+    while (height < bitmap.height) {
+        height *= 2;
+    }
+    if ((width == bitmap.width) && (height == bitmap.height)) {
+        return bitmap;
+    }
+    return resize(bitmap, width, height);
+}
+
+/**
+ * Rounds floats to bytes, clamping them to the range of a byte.
+ *
+ * @param src Values to store
+ * @param n Number of values
+ * @param dst Bytes to store them in
+ */
+void BitmapResizer::store(const GLfloat* src, const size_t n, GLubyte* dst) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        const __m128i a = _mm_cvtps_epi32(_mm_loadu_ps(src + i));
+        const __m128i b = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 4));
+        const __m128i c = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 8));
+        const __m128i d = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 12));
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128((__m128i*) (dst + i), packed);
+    }
+#endif
+    for (; i < n; ++i) {
+        const GLfloat value = min(max(src[i], 0.0f), 255.0f);
+        dst[i] = (GLubyte) (value + 0.5f);
+    }
+}
+
+// HELPERS
+
+void BitmapResizer::RowTask::run(const size_t begin, const size_t end) {
+
+    const int taps = weights.taps;
+    const GLint last = weights.srcSize - 1;
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    const size_t stride = ((bitmap.width * bytesPerPixel + (bitmap.alignment - 1)) / bitmap.alignment) * bitmap.alignment;
+    vector<GLfloat> row(((size_t) bitmap.width) * 4 + 4);
+
+    for (size_t y = begin; y < end; ++y) {
+
+        // Widen the row to four floats per pixel
+        const GLubyte* src = bitmap.pixels + y * stride;
+        for (GLsizei x = 0; x < bitmap.width; ++x) {
+            for (int c = 0; c < bytesPerPixel; ++c) {
+                row[x * 4 + c] = src[c];
+            }
+            src += bytesPerPixel;
+        }
+
+        // Filter each pixel, keeping only the components the format has
+        GLfloat* out = &dst[y * width * bytesPerPixel];
+        for (GLsizei x = 0; x < width; ++x) {
+            const GLint first = weights.first[x];
+            const GLfloat* const values = &weights.values[((size_t) x) * taps];
+#ifdef __SSE2__
+            __m128 sum = _mm_setzero_ps();
+            for (int k = 0; k < taps; ++k) {
+                const GLint i = min(max(first + k, 0), last);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(values[k]), _mm_loadu_ps(&row[i * 4])));
+            }
+            GLfloat pixel[4];
+            _mm_storeu_ps(pixel, sum);
+#else
+            GLfloat pixel[4] = { 0, 0, 0, 0 };
+            for (int k = 0; k < taps; ++k) {
+                const GLint i = min(max(first + k, 0), last);
+                for (int c = 0; c < 4; ++c) {
+                    pixel[c] += values[k] * row[i * 4 + c];
+                }
+            }
+#endif
+            for (int c = 0; c < bytesPerPixel; ++c) {
+                out[c] = pixel[c];
+            }
+            out += bytesPerPixel;
+        }
+    }
+}
+
+void BitmapResizer::ColumnTask::run(const size_t begin, const size_t end) {
+
+    const int taps = weights.taps;
+    const GLint last = weights.srcSize - 1;
+    const size_t n = ((size_t) bitmap.width) * Bitmap::sizeOf(bitmap.format);
+    const size_t stride = bitmap.size / bitmap.height;
+    vector<GLfloat> row(n);
+
+    for (size_t y = begin; y < end; ++y) {
+
+        // Filter the rows
+        fill(row.begin(), row.end(), 0.0f);
+        const GLfloat* const values = &weights.values[y * taps];
+        for (int k = 0; k < taps; ++k) {
+            const GLint i = min(max(weights.first[y] + k, 0), last);
+            Simd::accumulate(n, values[k], &src[i * n], &row[0]);
+        }
+
+        // Store the row, including padding
+        GLubyte* const out = bitmap.pixels + y * stride;
+        store(&row[0], n, out);
+        memset(out + n, 0, stride - n);
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,78 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPRESIZER_HXX
+#define GLYCERIN_BITMAPRESIZER_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <vector>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for scaling bitmaps to other sizes.
+ *
+ * _BitmapResizer_ filters each row and then each column, splitting both
+ * passes across all available processors and using SSE when the compiler
+ * allows.  Its properties are set with chained calls.
+ *
+ * ~~~
+ * BitmapResizer resizer;
+ * const Bitmap thumbnail = resizer.filter(BitmapResizer::LANCZOS3).resizeToFit(bitmap, 128, 128);
+ * ~~~
+ *
+ * By default the [bilinear](@ref BILINEAR) filter is used.  Resized bitmaps
+ * keep the format of the original, with rows aligned to four bytes.  Color
+ * components are filtered as they are, so bitmaps with alpha should be
+ * premultiplied first to keep transparent pixels from bleeding into their
+ * neighbors.
+ */
+class BitmapResizer {
+public:
+// Types
+    /// Filter used to compute each pixel
+    enum Filter {
+        BOX,      ///< Average of the pixels covered, or nearest pixel when enlarging
+        BILINEAR, ///< Triangle filter, which blends neighbors smoothly
+        LANCZOS3  ///< Three-lobed windowed sinc, which keeps edges sharp but may ring
+    };
+// Methods
+    BitmapResizer();
+    virtual ~BitmapResizer();
+    BitmapResizer& filter(Filter filter);
+    Bitmap resize(const Bitmap& bitmap, GLsizei width, GLsizei height) const;
+    Bitmap resizeToFit(const Bitmap& bitmap, GLsizei maxWidth, GLsizei maxHeight) const;
+    Bitmap resizeToPowerOfTwo(const Bitmap& bitmap) const;
+private:
+// Types
+    struct Weights;
+    class RowTask;
+    class ColumnTask;
+// Constants
+    static const GLint ALIGNMENT = 4;
+// Attributes
+    Filter _filter;
+// Methods
+    static Weights createWeights(Filter filter, GLsizei srcSize, GLsizei dstSize);
+    static double evaluate(Filter filter, double x);
+    static double getSupport(Filter filter);
+    static void store(const GLfloat* src, size_t n, GLubyte* dst);
+};
+
+} /* namespace Glycerin */
+#endif
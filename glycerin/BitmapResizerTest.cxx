@@ -0,0 +1,165 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/BitmapResizer.hxx"
+
+
+/**
+ * Unit test for `BitmapResizer`.
+ */
+class BitmapResizerTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Ensures `BitmapResizer::resize` keeps pixels when the size does not change.
+     */
+    void testResizeToSameSize() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(37, 11).seed(2).generate();
+        const Glycerin::BitmapResizer::Filter filters[] = {
+                Glycerin::BitmapResizer::BOX,
+                Glycerin::BitmapResizer::BILINEAR,
+                Glycerin::BitmapResizer::LANCZOS3 };
+        for (int i = 0; i < 3; ++i) {
+            const Glycerin::Bitmap resized = Glycerin::BitmapResizer().filter(filters[i]).resize(bitmap, 37, 11);
+            CPPUNIT_ASSERT(getPixels(bitmap) == getPixels(resized));
+        }
+    }
+
+    /**
+     * Ensures `BitmapResizer::resize` averages pixels with the box filter.
+     */
+    void testResizeWithBox() {
+        Glycerin::BitmapGenerator generator;
+        generator.pattern(Glycerin::BitmapGenerator::CHECKERBOARD).cellSize(1).size(16, 16);
+        const Glycerin::Bitmap bitmap = generator.generate();
+        const Glycerin::Bitmap resized = Glycerin::BitmapResizer().filter(Glycerin::BitmapResizer::BOX).resize(bitmap, 8, 8);
+        CPPUNIT_ASSERT_EQUAL(8, resized.getWidth());
+        CPPUNIT_ASSERT_EQUAL(8, resized.getHeight());
+        CPPUNIT_ASSERT_EQUAL(bitmap.getFormat(), resized.getFormat());
+        const std::vector<GLubyte> pixels = getPixels(resized);
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(128, (int) pixels[i]);
+        }
+    }
+
+    /**
+     * Ensures `BitmapResizer::resize` keeps flat areas flat in every direction with every filter.
+     */
+    void testResizeFlat() {
+        Glycerin::BitmapGenerator generator;
+        generator.pattern(Glycerin::BitmapGenerator::CHECKERBOARD).cellSize(64).size(20, 30);
+        const Glycerin::Bitmap bitmap = generator.generate();
+        const GLubyte expected = getPixels(bitmap)[0];
+        const Glycerin::BitmapResizer::Filter filters[] = {
+                Glycerin::BitmapResizer::BOX,
+                Glycerin::BitmapResizer::BILINEAR,
+                Glycerin::BitmapResizer::LANCZOS3 };
+        for (int i = 0; i < 3; ++i) {
+            const Glycerin::Bitmap resized = Glycerin::BitmapResizer().filter(filters[i]).resize(bitmap, 45, 7);
+            const std::vector<GLubyte> pixels = getPixels(resized);
+            const size_t stride = resized.getSize() / resized.getHeight();
+            for (size_t y = 0; y < 7; ++y) {
+                for (size_t x = 0; x < 45 * 3; ++x) {
+                    CPPUNIT_ASSERT_EQUAL((int) expected, (int) pixels[y * stride + x]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Ensures `BitmapResizer::resize` changes a gradient smoothly when enlarging.
+     */
+    void testResizeWithBilinear() {
+        Glycerin::BitmapGenerator generator;
+        generator.pattern(Glycerin::BitmapGenerator::GRADIENT).size(64, 64);
+        const Glycerin::Bitmap bitmap = generator.generate();
+        const Glycerin::Bitmap resized = Glycerin::BitmapResizer().resize(bitmap, 128, 64);
+        const std::vector<GLubyte> pixels = getPixels(resized);
+        for (int x = 1; x < 128; ++x) {
+            const int red = pixels[x * 3 + 2];
+            const int previous = pixels[(x - 1) * 3 + 2];
+            CPPUNIT_ASSERT(red >= previous);
+            CPPUNIT_ASSERT(red - previous <= 3);
+        }
+    }
+
+    /**
+     * Ensures `BitmapResizer::resizeToFit` keeps proportions and leaves small bitmaps alone.
+     */
+    void testResizeToFit() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(300, 100).generate();
+        const Glycerin::BitmapResizer resizer;
+        const Glycerin::Bitmap thumbnail = resizer.resizeToFit(bitmap, 64, 64);
+        CPPUNIT_ASSERT_EQUAL(64, thumbnail.getWidth());
+        CPPUNIT_ASSERT_EQUAL(21, thumbnail.getHeight());
+        const Glycerin::Bitmap same = resizer.resizeToFit(bitmap, 512, 512);
+        CPPUNIT_ASSERT_EQUAL(300, same.getWidth());
+        CPPUNIT_ASSERT_EQUAL(100, same.getHeight());
+    }
+
+    /**
+     * Ensures `BitmapResizer::resizeToPowerOfTwo` rounds each side up.
+     */
+    void testResizeToPowerOfTwo() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(100, 64).generate();
+        const Glycerin::Bitmap resized = Glycerin::BitmapResizer().resizeToPowerOfTwo(bitmap);
+        CPPUNIT_ASSERT_EQUAL(128, resized.getWidth());
+        CPPUNIT_ASSERT_EQUAL(64, resized.getHeight());
+    }
+
+    /**
+     * Ensures `BitmapResizer::resize` rejects sizes less than one.
+     */
+    void testResizeWithInvalidSize() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(4, 4).generate();
+        CPPUNIT_ASSERT_THROW(Glycerin::BitmapResizer().resize(bitmap, 0, 4), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapResizerTest);
+    CPPUNIT_TEST(testResizeToSameSize);
+    CPPUNIT_TEST(testResizeWithBox);
+    CPPUNIT_TEST(testResizeFlat);
+    CPPUNIT_TEST(testResizeWithBilinear);
+    CPPUNIT_TEST(testResizeToFit);
+    CPPUNIT_TEST(testResizeToPowerOfTwo);
+    CPPUNIT_TEST(testResizeWithInvalidSize);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapResizerTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <fstream>
+#include <stdexcept>
+#include "glycerin/BitmapWriter.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a new image writer.
+ */
+BitmapWriter::BitmapWriter() {
+    // empty
+}
+
+/**
+ * Destroys the image writer.
+ */
+BitmapWriter::~BitmapWriter() {
+    // empty
+}
+
+/**
+ * Writes an image to a file.
+ *
+ * @param bitmap Bitmap to write
+ * @param filename Path to the file to write
+ * @throws invalid_argument if bitmap is not in `GL_BGR` or `GL_BGRA` format with an alignment of four
+ * @throws runtime_error if file cannot be opened or written
+ */
+void BitmapWriter::write(const Bitmap& bitmap, const string& filename) {
+
+    // Check the bitmap
+    if (((bitmap.format != GL_BGR) && (bitmap.format != GL_BGRA)) || (bitmap.alignment != 4)) {
+        throw invalid_argument("[BitmapWriter] Only supports 24-bit or 32-bit data with rows aligned to four bytes.");
+    }
+
+    // Open the file
+    ofstream file(filename.c_str(), ios_base::binary);
+    if (!file) {
+        throw runtime_error("[BitmapWriter] File could not be opened!");
+    }
+
+    // Write out the file
+    writeFileHeader(file, getHeaderSize(bitmap), bitmap.size);
+    writeInfoHeader(file, bitmap);
+    file.write((const char*) bitmap.pixels, bitmap.size);
+    if (!file) {
+        throw runtime_error("[BitmapWriter] All pixels could not be written!");
+    }
+}
+
+/**
+ * Determines the size of the info header for a bitmap.
+ *
+ * @param bitmap Bitmap being written
+ * @return Size of a version 4 header for 32-bit bitmaps, otherwise of a plain info header
+ */
+GLuint BitmapWriter::getHeaderSize(const Bitmap& bitmap) {
+    return (bitmap.format == GL_BGRA) ? V4_HEADER_SIZE : INFO_HEADER_SIZE;
+}
+
+/**
+ * Writes just the file header section.
+ *
+ * @param stream Stream to write to
+ * @param headerSize Number of bytes in the info header that will follow
+ * @param size Number of bytes of pixel data that will follow the headers
+ */
+void BitmapWriter::writeFileHeader(ostream& stream, const GLuint headerSize, const GLuint size) {
+    stream.write("BM", 2);
+    writeInt(stream, FILE_HEADER_SIZE + headerSize + size);
+    writeShort(stream, 0);
+    writeShort(stream, 0);
+    writeInt(stream, FILE_HEADER_SIZE + headerSize);
+}
+
+/**
+ * Writes just the info header section.
+ *
+ * @param stream Stream to write to
+ * @param bitmap Bitmap being written
+ */
+void BitmapWriter::writeInfoHeader(ostream& stream, const Bitmap& bitmap) {
+
+    const bool alpha = (bitmap.format == GL_BGRA);
+
+    // Write the plain info header
+    writeInt(stream, getHeaderSize(bitmap));
+    writeInt(stream, bitmap.width);
+    writeInt(stream, bitmap.height);
+    writeShort(stream, 1);
+    writeShort(stream, alpha ? 32 : 24);
+    writeInt(stream, alpha ? BI_BITFIELDS : BI_RGB);
+    writeInt(stream, bitmap.size);
+    writeInt(stream, PIXELS_PER_METER);
+    writeInt(stream, PIXELS_PER_METER);
+    writeInt(stream, 0);
+    writeInt(stream, 0);
+    if (!alpha) {
+        return;
+    }
+
+    // Add red, green, blue and alpha masks and an sRGB color space
+    writeInt(stream, 0x00ff0000);
+    writeInt(stream, 0x0000ff00);
+    writeInt(stream, 0x000000ff);
+    writeInt(stream, 0xff000000);
+    writeInt(stream, LCS_SRGB);
+    for (int i = 0; i < 12; ++i) {
+        writeInt(stream, 0);
+    }
+}
+
+/**
+ * Writes a two-byte value in little-endian order.
+ *
+ * @param stream Stream to write to
+ * @param value Value to write
+ */
+void BitmapWriter::writeShort(ostream& stream, const GLushort value) {
+    const char bytes[] = { (char) (value & 0xff), (char) (value >> 8) };
+    stream.write(bytes, 2);
+}
+
+/**
+ * Writes a four-byte value in little-endian order.
+ *
+ * @param stream Stream to write to
+ * @param value Value to write
+ */
+void BitmapWriter::writeInt(ostream& stream, const GLuint value) {
+    const char bytes[] = {
+            (char) (value & 0xff),
+            (char) ((value >> 8) & 0xff),
+            (char) ((value >> 16) & 0xff),
+            (char) (value >> 24) };
+    stream.write(bytes, 4);
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,70 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_BITMAPWRITER_HXX
+#define GLYCERIN_BITMAPWRITER_HXX
+#include "glycerin/common.h"
+#include <ostream>
+#include <string>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Writes a bitmap image to a file.
+ *
+ * To use _BitmapWriter_, create one and then pass a bitmap and the path to
+ * write it to to [write].
+ *
+ * ~~~
+ * BitmapWriter writer;
+ * writer.write(bitmap, "image.bmp");
+ * ~~~
+ *
+ * Files are written as uncompressed 24-bit or 32-bit images, depending on
+ * whether the bitmap is `GL_BGR` or `GL_BGRA`, that [read] can load.  32-bit
+ * images are written with a version 4 header whose masks include alpha, so
+ * alpha values read back as they were, even if they are all zero.
+ *
+ * [read]: @ref BitmapReader::read(const std::string&) "BitmapReader::read(const std::string&)"
+ * [write]: @ref write(const Bitmap&, const std::string&) "write(const Bitmap&, const std::string&)"
+ */
+class BitmapWriter {
+public:
+// Methods
+    BitmapWriter();
+    virtual ~BitmapWriter();
+    void write(const Bitmap& bitmap, const std::string& filename);
+private:
+// Constants
+    static const GLuint FILE_HEADER_SIZE = 14;
+    static const GLuint INFO_HEADER_SIZE = 40;
+    static const GLuint V4_HEADER_SIZE = 108;
+    static const GLuint BI_RGB = 0;
+    static const GLuint BI_BITFIELDS = 3;
+    static const GLuint LCS_SRGB = 0x73524742;
+    static const GLuint PIXELS_PER_METER = 2835;
+// Methods
+    static GLuint getHeaderSize(const Bitmap& bitmap);
+    static void writeFileHeader(std::ostream& stream, GLuint headerSize, GLuint size);
+    static void writeInfoHeader(std::ostream& stream, const Bitmap& bitmap);
+    static void writeShort(std::ostream& stream, GLushort value);
+    static void writeInt(std::ostream& stream, GLuint value);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapReader.hxx"
+#include "glycerin/BitmapWriter.hxx"
+
+
+/**
+ * Unit test for `BitmapWriter`.
+ */
+class BitmapWriterTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures a bitmap written by `BitmapWriter::write` can be read back in.
+     */
+    void testWrite() {
+
+        // Read a bitmap and write it back out
+        Glycerin::BitmapReader reader;
+        const Glycerin::Bitmap expected = reader.read("glycerin/rgbw.bmp");
+        Glycerin::BitmapWriter writer;
+        writer.write(expected, "BitmapWriterTest.bmp");
+
+        // Read it back in
+        const Glycerin::Bitmap actual = reader.read("BitmapWriterTest.bmp");
+        remove("BitmapWriterTest.bmp");
+
+        // Compare
+        CPPUNIT_ASSERT_EQUAL(expected.getWidth(), actual.getWidth());
+        CPPUNIT_ASSERT_EQUAL(expected.getHeight(), actual.getHeight());
+        CPPUNIT_ASSERT_EQUAL(expected.getSize(), actual.getSize());
+        std::vector<GLubyte> e(expected.getSize());
+        std::vector<GLubyte> a(actual.getSize());
+        expected.getPixels(&e[0], e.size());
+        actual.getPixels(&a[0], a.size());
+        CPPUNIT_ASSERT(e == a);
+    }
+
+    /**
+     * Ensures transparent 32-bit pixels written by `BitmapWriter::write` stay transparent.
+     */
+    void testWriteWithTransparentPixels() {
+
+        // Make a 2x1 image with alpha masked but zero
+        const GLuint header[] = {
+                78, 0, 70,              // file size, reserved and offset, after "BM"
+                56, 2, 1, 0x00200001,   // header size, width, height, planes and bit count
+                3, 8, 2835, 2835, 0, 0, // bitfields, image size, resolution and colors
+                0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 };
+        std::vector<GLubyte> bytes(2 + sizeof(header));
+        bytes[0] = 'B';
+        bytes[1] = 'M';
+        memcpy(&bytes[2], header, sizeof(header));
+        const GLubyte data[] = { 1, 2, 3, 0, 4, 5, 6, 0 };
+        bytes.insert(bytes.end(), data, data + sizeof(data));
+        {
+            std::ofstream file("BitmapWriterTest.bmp", std::ios_base::binary);
+            file.write((const char*) &bytes[0], bytes.size());
+        }
+
+        // Read it, write it and read it back
+        Glycerin::BitmapReader reader;
+        Glycerin::BitmapWriter writer;
+        writer.write(reader.read("BitmapWriterTest.bmp"), "BitmapWriterTest.bmp");
+        const Glycerin::Bitmap actual = reader.read("BitmapWriterTest.bmp");
+        remove("BitmapWriterTest.bmp");
+
+        // Compare
+        GLubyte pixels[8];
+        actual.getPixels(pixels, 8);
+        CPPUNIT_ASSERT(memcmp(data, pixels, 8) == 0);
+    }
+
+    CPPUNIT_TEST_SUITE(BitmapWriterTest);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST(testWriteWithTransparentPixels);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(BitmapWriterTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <gloop/TextureTarget.hxx>
+#include "glycerin/CompressedBitmap.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a compressed bitmap with room for every block.
+ *
+ * @param format Compressed format of the blocks
+ * @param width Size of the image in the X direction
+ * @param height Size of the image in the Y direction
+ */
+CompressedBitmap::CompressedBitmap(const GLenum format, const GLsizei width, const GLsizei height) :
+        _data(((size_t) (width + 3) / 4) * ((height + 3) / 4) * 8),
+        _format(format),
+        _height(height),
+        _width(width) {
+    // empty
+}
+
+/**
+ * Creates a new OpenGL texture on the current texture unit from this bitmap.
+ *
+ * The texture only has one level, so its minification filter is set to
+ * `GL_LINEAR`.  After this method returns, the texture will still be bound
+ * to the texture unit.
+ *
+ * @return Handle for the new OpenGL texture
+ */
+Gloop::TextureObject CompressedBitmap::createTexture() const {
+    return createTexture(vector<CompressedBitmap>(1, *this));
+}
+
+/**
+ * Creates a new OpenGL texture on the current texture unit from a compressed mipmap chain.
+ *
+ * Compressed levels cannot be made by `glGenerateMipmap`, so compress each
+ * level of a chain from `MipmapGenerator` instead.  `GL_TEXTURE_MAX_LEVEL`
+ * is set so the texture is complete, and the texture is left bound.
+ *
+ * @param levels Compressed levels, starting with the largest
+ * @return Handle for the new OpenGL texture
+ * @throws invalid_argument if there are no levels
+ */
+Gloop::TextureObject CompressedBitmap::createTexture(const vector<CompressedBitmap>& levels) {
+
+    if (levels.empty()) {
+        throw invalid_argument("[CompressedBitmap] No levels to upload!");
+    }
+
+    // Generate and bind a new texture
+    const Gloop::TextureObject texture = Gloop::TextureObject::generate();
+    const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
+    StateCache::current().bindTexture(GL_TEXTURE_2D, texture.id());
+
+    // Load each level as it is
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const CompressedBitmap& level = levels[i];
+        glCompressedTexImage2D(
+                GL_TEXTURE_2D,      // target
+                i,                  // level
+                level._format,      // internal format
+                level._width,       // width
+                level._height,      // height
+                0,                  // border
+                level.size(),       // image size
+                &level._data[0]);   // data
+    }
+
+    // Only use the levels that were loaded
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels.size() - 1);
+    if (levels.size() == 1) {
+        target.minFilter(GL_LINEAR);
+    }
+    return texture;
+}
+
+/**
+ * Returns the compressed blocks.
+ */
+const GLubyte* CompressedBitmap::data() const {
+    return &_data[0];
+}
+
+/**
+ * Returns the compressed format of the blocks.
+ *
+ * @return Either `GL_COMPRESSED_RGB_S3TC_DXT1_EXT` or `GL_COMPRESSED_RED_RGTC1`
+ */
+GLenum CompressedBitmap::format() const {
+    return _format;
+}
+
+/**
+ * Returns the size of the image in the Y direction.
+ */
+GLsizei CompressedBitmap::height() const {
+    return _height;
+}
+
+/**
+ * Returns the number of bytes taken by the compressed blocks.
+ */
+GLsizei CompressedBitmap::size() const {
+    return _data.size();
+}
+
+/**
+ * Returns the size of the image in the X direction.
+ */
+GLsizei CompressedBitmap::width() const {
+    return _width;
+}
+
+} /* namespace Glycerin */
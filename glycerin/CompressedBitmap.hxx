@@ -0,0 +1,75 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_COMPRESSEDBITMAP_HXX
+#define GLYCERIN_COMPRESSEDBITMAP_HXX
+#include "glycerin/common.h"
+#include <vector>
+#include <gloop/TextureObject.hxx>
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#endif
+namespace Glycerin {
+
+
+/**
+ * Image stored in a block-compressed format.
+ *
+ * To get a _CompressedBitmap_, pass a bitmap to a [bitmap compressor].  Then
+ * upload it with [create-texture], which hands the blocks to the driver as
+ * they are, without decompressing them.
+ *
+ * ~~~
+ * const CompressedBitmap compressed = BitmapCompressor().compress(bitmap);
+ * const Gloop::TextureObject texture = compressed.createTexture();
+ * ~~~
+ *
+ * The format is either `GL_COMPRESSED_RGB_S3TC_DXT1_EXT` for BC1 or
+ * `GL_COMPRESSED_RED_RGTC1` for BC4.  Both use eight bytes per block of four
+ * by four pixels, and rows of blocks go from the bottom of the image up, just
+ * like the rows of a bitmap.
+ *
+ * [bitmap compressor]: @ref BitmapCompressor "BitmapCompressor"
+ * [create-texture]: @ref createTexture() const "createTexture()"
+ */
+class CompressedBitmap {
+public:
+// Methods
+    Gloop::TextureObject createTexture() const;
+    const GLubyte* data() const;
+    GLenum format() const;
+    GLsizei height() const;
+    GLsizei size() const;
+    GLsizei width() const;
+    static Gloop::TextureObject createTexture(const std::vector<CompressedBitmap>& levels);
+private:
+// Attributes
+    std::vector<GLubyte> _data;
+    GLenum _format;
+    GLsizei _height;
+    GLsizei _width;
+// Methods
+    CompressedBitmap(GLenum format, GLsizei width, GLsizei height);
+// Friends
+    friend class BitmapCompressor;
+};
+
+} /* namespace Glycerin */
+#endif
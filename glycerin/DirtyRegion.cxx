@@ -0,0 +1,198 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include "glycerin/DirtyRegion.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs an empty dirty region for an image.
+ *
+ * @param width Size of the image in the X direction
+ * @param height Size of the image in the Y direction
+ * @throws invalid_argument if width or height is negative
+ */
+DirtyRegion::DirtyRegion(const GLsizei width, const GLsizei height) :
+        _height(height),
+        _maxRectangles(DEFAULT_MAX_RECTANGLES),
+        _overhead(DEFAULT_OVERHEAD),
+        _width(width) {
+    if ((width < 0) || (height < 0)) {
+        throw invalid_argument("[DirtyRegion] Width and height must not be negative!");
+    }
+}
+
+/**
+ * Destroys the dirty region.
+ */
+DirtyRegion::~DirtyRegion() {
+    // empty
+}
+
+/**
+ * Marks a rectangle of the image as changed.
+ *
+ * @param x Position of the left edge of the rectangle
+ * @param y Position of the bottom edge of the rectangle
+ * @param width Size of the rectangle in the X direction
+ * @param height Size of the rectangle in the Y direction
+ * @return Reference to this region to support chaining
+ */
+DirtyRegion& DirtyRegion::add(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
+
+    // Clip to the image
+    const GLint left = max(x, 0);
+    const GLint bottom = max(y, 0);
+    const GLint right = min(x + width, _width);
+    const GLint top = min(y + height, _height);
+    if ((right <= left) || (top <= bottom)) {
+        return (*this);
+    }
+    Rectangle rectangle = { left, bottom, right - left, top - bottom };
+
+    // Merge with any rectangle it is cheaper to upload together with, repeating since the result grew
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < _rectangles.size(); ++i) {
+            const Rectangle combined = unionOf(rectangle, _rectangles[i]);
+            const size_t separate = areaOf(rectangle) + areaOf(_rectangles[i]) - overlapOf(rectangle, _rectangles[i]);
+            if (areaOf(combined) <= separate + _overhead) {
+                rectangle = combined;
+                _rectangles.erase(_rectangles.begin() + i);
+                merged = true;
+                break;
+            }
+        }
+    }
+    _rectangles.push_back(rectangle);
+
+    // Collapse everything if there are too many
+    if (_rectangles.size() > _maxRectangles) {
+        Rectangle bounds = _rectangles[0];
+        for (size_t i = 1; i < _rectangles.size(); ++i) {
+            bounds = unionOf(bounds, _rectangles[i]);
+        }
+        _rectangles.assign(1, bounds);
+    }
+    return (*this);
+}
+
+/**
+ * Returns the total number of pixels in all the rectangles.
+ */
+size_t DirtyRegion::area() const {
+    size_t total = 0;
+    for (size_t i = 0; i < _rectangles.size(); ++i) {
+        total += areaOf(_rectangles[i]);
+    }
+    return total;
+}
+
+/**
+ * Computes the number of pixels in a rectangle.
+ */
+size_t DirtyRegion::areaOf(const Rectangle& rectangle) {
+    return ((size_t) rectangle.width) * rectangle.height;
+}
+
+/**
+ * Marks the whole image as unchanged.
+ */
+void DirtyRegion::clear() {
+    _rectangles.clear();
+}
+
+/**
+ * Checks if nothing has changed.
+ */
+bool DirtyRegion::empty() const {
+    return _rectangles.empty();
+}
+
+/**
+ * Changes the largest number of rectangles kept before they are collapsed into one.
+ *
+ * @param maxRectangles Largest number of rectangles, by default sixteen
+ * @return Reference to this region to support chaining
+ * @throws invalid_argument if maxRectangles is zero
+ */
+DirtyRegion& DirtyRegion::maxRectangles(const size_t maxRectangles) {
+    if (maxRectangles == 0) {
+        throw invalid_argument("[DirtyRegion] Maximum number of rectangles is zero!");
+    }
+    _maxRectangles = maxRectangles;
+    return (*this);
+}
+
+/**
+ * Changes how many extra pixels a merge may add and still be worth it.
+ *
+ * @param overhead Cost of one extra upload, in pixels, by default 4096
+ * @return Reference to this region to support chaining
+ */
+DirtyRegion& DirtyRegion::overhead(const size_t overhead) {
+    _overhead = overhead;
+    return (*this);
+}
+
+/**
+ * Computes the number of pixels two rectangles share.
+ */
+size_t DirtyRegion::overlapOf(const Rectangle& a, const Rectangle& b) {
+    const GLint width = min(a.x + a.width, b.x + b.width) - max(a.x, b.x);
+    const GLint height = min(a.y + a.height, b.y + b.height) - max(a.y, b.y);
+    return ((width > 0) && (height > 0)) ? ((size_t) width) * height : 0;
+}
+
+/**
+ * Returns one of the rectangles.
+ *
+ * @param index Position of the rectangle
+ * @return Reference to the rectangle
+ * @throws out_of_range if index is not less than the number of rectangles
+ */
+const DirtyRegion::Rectangle& DirtyRegion::rectangle(const size_t index) const {
+    if (index >= _rectangles.size()) {
+        throw out_of_range("[DirtyRegion] Index is out of range!");
+    }
+    return _rectangles[index];
+}
+
+/**
+ * Returns the number of rectangles.
+ */
+size_t DirtyRegion::size() const {
+    return _rectangles.size();
+}
+
+/**
+ * Computes the smallest rectangle containing two rectangles.
+ */
+DirtyRegion::Rectangle DirtyRegion::unionOf(const Rectangle& a, const Rectangle& b) {
+    const GLint left = min(a.x, b.x);
+    const GLint bottom = min(a.y, b.y);
+    const GLint right = max(a.x + a.width, b.x + b.width);
+    const GLint top = max(a.y + a.height, b.y + b.height);
+    const Rectangle rectangle = { left, bottom, right - left, top - bottom };
+    return rectangle;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,86 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_DIRTYREGION_HXX
+#define GLYCERIN_DIRTYREGION_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Set of rectangles of an image that have changed.
+ *
+ * Every upload to a texture has a fixed cost on top of the pixels it copies,
+ * so uploading many tiny rectangles can be slower than uploading a few larger
+ * ones.  _DirtyRegion_ merges rectangles as they are added whenever the
+ * pixels the merged rectangle adds are cheaper than an extra upload, and
+ * collapses everything into one bounding rectangle when there would be too
+ * many.  Rectangles are clipped to the bounds of the image.
+ *
+ * ~~~
+ * DirtyRegion region(width, height);
+ * region.add(10, 10, 4, 4).add(12, 12, 4, 4);
+ * for (size_t i = 0; i < region.size(); ++i) {
+ *     const DirtyRegion::Rectangle& rectangle = region.rectangle(i);
+ *     ...
+ * }
+ * region.clear();
+ * ~~~
+ */
+class DirtyRegion {
+public:
+// Types
+    /**
+     * Area of the image, in pixels from its bottom-left corner.
+     */
+    struct Rectangle {
+        GLint x;
+        GLint y;
+        GLsizei width;
+        GLsizei height;
+    };
+// Constants
+    static const size_t DEFAULT_MAX_RECTANGLES = 16;
+    static const size_t DEFAULT_OVERHEAD = 4096;
+// Methods
+    DirtyRegion(GLsizei width, GLsizei height);
+    virtual ~DirtyRegion();
+    DirtyRegion& add(GLint x, GLint y, GLsizei width, GLsizei height);
+    size_t area() const;
+    void clear();
+    bool empty() const;
+    DirtyRegion& maxRectangles(size_t maxRectangles);
+    DirtyRegion& overhead(size_t overhead);
+    const Rectangle& rectangle(size_t index) const;
+    size_t size() const;
+private:
+// Attributes
+    GLsizei _height;
+    size_t _maxRectangles;
+    size_t _overhead;
+    std::vector<Rectangle> _rectangles;
+    GLsizei _width;
+// Methods
+    static size_t areaOf(const Rectangle& rectangle);
+    static size_t overlapOf(const Rectangle& a, const Rectangle& b);
+    static Rectangle unionOf(const Rectangle& a, const Rectangle& b);
+};
+
+} /* namespace Glycerin */
+#endif
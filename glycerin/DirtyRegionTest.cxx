@@ -0,0 +1,116 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/DirtyRegion.hxx"
+
+
+/**
+ * Unit test for `DirtyRegion`.
+ */
+class DirtyRegionTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `DirtyRegion::add` clips rectangles and ignores ones outside the image.
+     */
+    void testAddWithClipping() {
+        Glycerin::DirtyRegion region(100, 50);
+        region.add(-10, 40, 20, 20).add(200, 0, 5, 5).add(0, 0, 0, 10);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, region.size());
+        const Glycerin::DirtyRegion::Rectangle& rectangle = region.rectangle(0);
+        CPPUNIT_ASSERT_EQUAL(0, rectangle.x);
+        CPPUNIT_ASSERT_EQUAL(40, rectangle.y);
+        CPPUNIT_ASSERT_EQUAL(10, rectangle.width);
+        CPPUNIT_ASSERT_EQUAL(10, rectangle.height);
+    }
+
+    /**
+     * Ensures `DirtyRegion::add` merges nearby rectangles but keeps distant ones apart.
+     */
+    void testAddWithMerging() {
+        Glycerin::DirtyRegion region(1024, 1024);
+        region.overhead(64);
+        region.add(0, 0, 8, 8).add(8, 0, 8, 8);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, region.size());
+        CPPUNIT_ASSERT_EQUAL((size_t) 128, region.area());
+        region.add(500, 500, 8, 8);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, region.size());
+        CPPUNIT_ASSERT_EQUAL((size_t) 192, region.area());
+    }
+
+    /**
+     * Ensures `DirtyRegion::add` keeps merging when a merged rectangle reaches another one.
+     */
+    void testAddWithChainedMerging() {
+        Glycerin::DirtyRegion region(1024, 1024);
+        region.overhead(0);
+        region.add(0, 0, 4, 4).add(8, 0, 4, 4);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, region.size());
+        region.add(4, 0, 4, 4);
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, region.size());
+        CPPUNIT_ASSERT_EQUAL(12, region.rectangle(0).width);
+    }
+
+    /**
+     * Ensures `DirtyRegion::add` collapses everything into one rectangle when there are too many.
+     */
+    void testAddWithTooManyRectangles() {
+        Glycerin::DirtyRegion region(1024, 1024);
+        region.overhead(0).maxRectangles(3);
+        for (int i = 0; i < 4; ++i) {
+            region.add(i * 100, i * 100, 1, 1);
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, region.size());
+        const Glycerin::DirtyRegion::Rectangle& rectangle = region.rectangle(0);
+        CPPUNIT_ASSERT_EQUAL(0, rectangle.x);
+        CPPUNIT_ASSERT_EQUAL(0, rectangle.y);
+        CPPUNIT_ASSERT_EQUAL(301, rectangle.width);
+        CPPUNIT_ASSERT_EQUAL(301, rectangle.height);
+    }
+
+    /**
+     * Ensures `DirtyRegion::clear` removes every rectangle.
+     */
+    void testClear() {
+        Glycerin::DirtyRegion region(16, 16);
+        region.add(0, 0, 4, 4);
+        CPPUNIT_ASSERT(!region.empty());
+        region.clear();
+        CPPUNIT_ASSERT(region.empty());
+        CPPUNIT_ASSERT_THROW(region.rectangle(0), std::out_of_range);
+    }
+
+    CPPUNIT_TEST_SUITE(DirtyRegionTest);
+    CPPUNIT_TEST(testAddWithClipping);
+    CPPUNIT_TEST(testAddWithMerging);
+    CPPUNIT_TEST(testAddWithChainedMerging);
+    CPPUNIT_TEST(testAddWithTooManyRectangles);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(DirtyRegionTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "glycerin/DistanceFieldGenerator.hxx"
+#include "glycerin/Parallel.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Finds squared distances to the nearest inside and outside pixels within a range of columns.
+ */
+class DistanceFieldGenerator::ColumnTask : public Parallel::Task {
+public:
+    ColumnTask(const Bitmap& bitmap, GLubyte threshold, vector<GLfloat>& inside, vector<GLfloat>& outside) :
+            bitmap(bitmap), threshold(threshold), inside(inside), outside(outside) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Bitmap& bitmap;
+    const GLubyte threshold;
+    vector<GLfloat>& inside;
+    vector<GLfloat>& outside;
+};
+
+/**
+ * Finishes the distances within a range of rows and stores them in a bitmap.
+ */
+class DistanceFieldGenerator::RowTask : public Parallel::Task {
+public:
+    RowTask(const vector<GLfloat>& inside, const vector<GLfloat>& outside, GLfloat spread, Bitmap& bitmap) :
+            inside(inside), outside(outside), spread(spread), bitmap(bitmap) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const vector<GLfloat>& inside;
+    const vector<GLfloat>& outside;
+    const GLfloat spread;
+    Bitmap& bitmap;
+};
+
+/**
+ * Constructs a distance field generator with default settings.
+ */
+DistanceFieldGenerator::DistanceFieldGenerator() :
+        _spread(DEFAULT_SPREAD),
+        _threshold(DEFAULT_THRESHOLD) {
+    // empty
+}
+
+/**
+ * Destroys the distance field generator.
+ */
+DistanceFieldGenerator::~DistanceFieldGenerator() {
+    // empty
+}
+
+/**
+ * Makes the signed distance field of a bitmap using the current settings.
+ *
+ * @param bitmap Bitmap whose red components mark the shape
+ * @return Bitmap of the same size holding the distance field
+ * @throws invalid_argument if the bitmap is empty
+ */
+Bitmap DistanceFieldGenerator::generate(const Bitmap& bitmap) const {
+
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[DistanceFieldGenerator] Bitmap is empty!");
+    }
+
+    // Transform columns
+    const size_t count = ((size_t) bitmap.width) * bitmap.height;
+    vector<GLfloat> inside(count);
+    vector<GLfloat> outside(count);
+    ColumnTask columnTask(bitmap, _threshold, inside, outside);
+    Parallel::forEach(bitmap.width, columnTask, 16);
+
+    // Transform rows into a new bitmap
+    const GLsizei stride = ((bitmap.width * 3 + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+    Bitmap field;
+    field.setPixels(new GLubyte[((size_t) stride) * bitmap.height], NULL);
+    field.format = GL_BGR;
+    field.width = bitmap.width;
+    field.height = bitmap.height;
+    field.size = stride * bitmap.height;
+    field.alignment = ALIGNMENT;
+    RowTask rowTask(inside, outside, _spread, field);
+    Parallel::forEach(bitmap.height, rowTask, 16);
+    return field;
+}
+
+/**
+ * Changes how far from an edge the values in the field reach zero or 255.
+ *
+ * @param spread Distance in pixels, by default four
+ * @return Reference to this generator to support chaining
+ * @throws invalid_argument if spread is not positive
+ */
+DistanceFieldGenerator& DistanceFieldGenerator::spread(const GLfloat spread) {
+    if (!(spread > 0)) {
+        throw invalid_argument("[DistanceFieldGenerator] Spread must be positive!");
+    }
+    _spread = spread;
+    return (*this);
+}
+
+/**
+ * Changes the smallest red component of a pixel inside the shape.
+ *
+ * @param threshold Smallest red component inside the shape, by default 128
+ * @return Reference to this generator to support chaining
+ */
+DistanceFieldGenerator& DistanceFieldGenerator::threshold(const GLubyte threshold) {
+    _threshold = threshold;
+    return (*this);
+}
+
+/**
+ * Computes the exact squared distance transform of a row of samples.
+ *
+ * Uses the lower envelope of parabolas from Felzenszwalb and Huttenlocher,
+ * which takes linear time.
+ *
+ * @param f Squared distance of each sample before this pass, zero for samples in the set
+ * @param n Number of samples
+ * @param d Squared distance of each sample after this pass
+ * @param v Scratch space for `n` parabola locations
+ * @param z Scratch space for `n + 1` boundaries between parabolas
+ * @see http://cs.brown.edu/~pff/papers/dt-final.pdf
+ */
+void DistanceFieldGenerator::transform(const GLfloat* f, const GLsizei n, GLfloat* d, GLint* v, GLfloat* z) {
+
+    // Find the lower envelope
+    GLint k = 0;
+    v[0] = 0;
+    z[0] = -INFINITY_SQUARED;
+    z[1] = INFINITY_SQUARED;
+    for (GLint q = 1; q < n; ++q) {
+        GLfloat s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INFINITY_SQUARED;
+    }
+
+    // Evaluate it
+    k = 0;
+    for (GLint q = 0; q < n; ++q) {
+        while (z[k + 1] < q) {
+            ++k;
+        }
+        const GLint p = v[k];
+        d[q] = (q - p) * (q - p) + f[p];
+    }
+}
+
+// HELPERS
+
+void DistanceFieldGenerator::ColumnTask::run(const size_t begin, const size_t end) {
+
+    const GLsizei width = bitmap.width;
+    const GLsizei height = bitmap.height;
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    const GLsizei red = ((bitmap.format == GL_RGB) || (bitmap.format == GL_RGBA)) ? 0 : 2;
+    const size_t stride = ((width * bytesPerPixel + (bitmap.alignment - 1)) / bitmap.alignment) * bitmap.alignment;
+    vector<GLfloat> toInside(height), toOutside(height), d(height), z(height + 1);
+    vector<GLint> v(height);
+
+    for (size_t x = begin; x < end; ++x) {
+
+        // Mark pixels in each set
+        for (GLsizei y = 0; y < height; ++y) {
+            const bool in = bitmap.pixels[y * stride + x * bytesPerPixel + red] >= threshold;
+            toInside[y] = in ? 0 : INFINITY_SQUARED;
+            toOutside[y] = in ? INFINITY_SQUARED : 0;
+        }
+
+        // Transform the column for both sets
+        transform(&toInside[0], height, &d[0], &v[0], &z[0]);
+        for (GLsizei y = 0; y < height; ++y) {
+            inside[y * width + x] = d[y];
+        }
+        transform(&toOutside[0], height, &d[0], &v[0], &z[0]);
+        for (GLsizei y = 0; y < height; ++y) {
+            outside[y * width + x] = d[y];
+        }
+    }
+}
+
+void DistanceFieldGenerator::RowTask::run(const size_t begin, const size_t end) {
+
+    const GLsizei width = bitmap.width;
+    const size_t stride = bitmap.size / bitmap.height;
+    vector<GLfloat> toInside(width), toOutside(width), z(width + 1);
+    vector<GLint> v(width);
+
+    for (size_t y = begin; y < end; ++y) {
+
+        // Transform the row for both sets
+        transform(&inside[y * width], width, &toInside[0], &v[0], &z[0]);
+        transform(&outside[y * width], width, &toOutside[0], &v[0], &z[0]);
+
+        // Store signed distances, measuring from the edge halfway between pixels
+        GLubyte* const out = bitmap.pixels + y * stride;
+        memset(out, 0, stride);
+        for (GLsizei x = 0; x < width; ++x) {
+            const GLfloat distance = (toInside[x] == 0)
+                    ? (sqrt(toOutside[x]) - 0.5f)
+                    : (0.5f - sqrt(toInside[x]));
+            const GLfloat value = min(max(0.5f + distance / (2 * spread), 0.0f), 1.0f);
+            const GLubyte byte = (GLubyte) (value * 255 + 0.5f);
+            out[x * 3 + 0] = byte;
+            out[x * 3 + 1] = byte;
+            out[x * 3 + 2] = byte;
+        }
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,76 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_DISTANCEFIELDGENERATOR_HXX
+#define GLYCERIN_DISTANCEFIELDGENERATOR_HXX
+#include "glycerin/common.h"
+#include <vector>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for making signed distance fields out of bitmaps.
+ *
+ * A signed distance field stores how far each pixel is from the nearest edge
+ * of a shape instead of whether it is covered.  Since distances interpolate
+ * smoothly, a small field can be drawn crisply at any scale by thresholding
+ * it in a shader.  _DistanceFieldGenerator_ computes exact Euclidean
+ * distances by transforming every column and then every row, splitting both
+ * passes across all available processors.  Its properties are set with
+ * chained calls.
+ *
+ * ~~~
+ * DistanceFieldGenerator generator;
+ * const Bitmap field = generator.spread(4).generate(font);
+ * ~~~
+ *
+ * A pixel is inside the shape when its red component is at least the
+ * threshold, by default 128.  In the result, edges are at 128, values rise
+ * towards 255 inside the shape, and fall towards zero outside it, reaching
+ * the ends at [spread] pixels from the edge, by default four.  Every
+ * component of the result holds the same value, in the same 24-bit format
+ * that _BitmapReader_ produces.
+ *
+ * [spread]: @ref spread(GLfloat) "spread(GLfloat)"
+ */
+class DistanceFieldGenerator {
+public:
+// Methods
+    DistanceFieldGenerator();
+    virtual ~DistanceFieldGenerator();
+    Bitmap generate(const Bitmap& bitmap) const;
+    DistanceFieldGenerator& spread(GLfloat spread);
+    DistanceFieldGenerator& threshold(GLubyte threshold);
+private:
+// Types
+    class ColumnTask;
+    class RowTask;
+// Constants
+    static const GLint ALIGNMENT = 4;
+    static const GLfloat DEFAULT_SPREAD = 4;
+    static const GLubyte DEFAULT_THRESHOLD = 128;
+    static const GLfloat INFINITY_SQUARED = 1e20f;
+// Attributes
+    GLfloat _spread;
+    GLubyte _threshold;
+// Methods
+    static void transform(const GLfloat* f, GLsizei n, GLfloat* d, GLint* v, GLfloat* z);
+};
+
+} /* namespace Glycerin */
+#endif
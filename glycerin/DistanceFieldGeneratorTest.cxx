@@ -0,0 +1,130 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/DistanceFieldGenerator.hxx"
+
+
+/**
+ * Unit test for `DistanceFieldGenerator`.
+ */
+class DistanceFieldGeneratorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Ensures `DistanceFieldGenerator::generate` matches distances found by checking every pair of pixels.
+     */
+    void testGenerateMatchesBruteForce() {
+
+        // Make a shape and its field
+        Glycerin::BitmapGenerator generator;
+        generator.pattern(Glycerin::BitmapGenerator::SPHERES).size(41, 23).seed(9);
+        const Glycerin::Bitmap bitmap = generator.generate();
+        const GLfloat spread = 6;
+        const Glycerin::Bitmap field = Glycerin::DistanceFieldGenerator().spread(spread).generate(bitmap);
+        CPPUNIT_ASSERT_EQUAL(41, field.getWidth());
+        CPPUNIT_ASSERT_EQUAL(23, field.getHeight());
+
+        // Find which pixels are inside
+        const std::vector<GLubyte> pixels = getPixels(bitmap);
+        const size_t stride = bitmap.getSize() / bitmap.getHeight();
+        std::vector<bool> inside(41 * 23);
+        for (int y = 0; y < 23; ++y) {
+            for (int x = 0; x < 41; ++x) {
+                inside[y * 41 + x] = pixels[y * stride + x * 3 + 2] >= 128;
+            }
+        }
+
+        // Compare every pixel with the nearest pixel in the other set
+        const std::vector<GLubyte> values = getPixels(field);
+        const size_t fieldStride = field.getSize() / field.getHeight();
+        for (int y = 0; y < 23; ++y) {
+            for (int x = 0; x < 41; ++x) {
+                double nearest = 1e10;
+                for (int j = 0; j < 23; ++j) {
+                    for (int i = 0; i < 41; ++i) {
+                        if (inside[j * 41 + i] != inside[y * 41 + x]) {
+                            nearest = std::min(nearest, (double) ((i - x) * (i - x) + (j - y) * (j - y)));
+                        }
+                    }
+                }
+                const double distance = inside[y * 41 + x] ? (sqrt(nearest) - 0.5) : (0.5 - sqrt(nearest));
+                const double value = std::min(std::max(0.5 + distance / (2 * spread), 0.0), 1.0);
+                const int expected = (int) (value * 255 + 0.5);
+                const int actual = values[y * fieldStride + x * 3];
+                CPPUNIT_ASSERT(abs(expected - actual) <= 1);
+            }
+        }
+    }
+
+    /**
+     * Ensures `DistanceFieldGenerator::generate` puts values above the middle inside and below it outside.
+     */
+    void testGenerateSides() {
+        Glycerin::BitmapGenerator generator;
+        generator.pattern(Glycerin::BitmapGenerator::CHECKERBOARD).cellSize(8).size(32, 32);
+        const Glycerin::Bitmap bitmap = generator.generate();
+        const Glycerin::Bitmap field = Glycerin::DistanceFieldGenerator().generate(bitmap);
+        const std::vector<GLubyte> pixels = getPixels(bitmap);
+        const std::vector<GLubyte> values = getPixels(field);
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            if (pixels[i] >= 128) {
+                CPPUNIT_ASSERT(values[i] > 128);
+            } else {
+                CPPUNIT_ASSERT(values[i] < 128);
+            }
+        }
+    }
+
+    /**
+     * Ensures `DistanceFieldGenerator::spread` rejects distances that are not positive.
+     */
+    void testSpreadWithInvalidValue() {
+        CPPUNIT_ASSERT_THROW(Glycerin::DistanceFieldGenerator().spread(0), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(DistanceFieldGeneratorTest);
+    CPPUNIT_TEST(testGenerateMatchesBruteForce);
+    CPPUNIT_TEST(testGenerateSides);
+    CPPUNIT_TEST(testSpreadWithInvalidValue);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(DistanceFieldGeneratorTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <stdexcept>
+#include <gloop/TextureTarget.hxx>
+#include "glycerin/DynamicTexture.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a dynamic texture, uploading a copy of a bitmap to a new texture on the current texture unit.
+ *
+ * After this returns the texture is still bound to the texture unit.
+ *
+ * @param bitmap Bitmap with the starting pixels
+ * @param mipmaps Whether to generate mipmaps after every update, by default `false`
+ */
+DynamicTexture::DynamicTexture(const Bitmap& bitmap, const bool mipmaps) :
+        _bitmap(copy(bitmap)),
+        _dirty(bitmap.getWidth(), bitmap.getHeight()),
+        _mipmaps(mipmaps),
+        _stride(bitmap.getHeight() > 0 ? bitmap.getSize() / bitmap.getHeight() : 0),
+        _texture(_bitmap.createTexture(mipmaps)) {
+    if (!mipmaps) {
+        Gloop::TextureTarget::texture2d().minFilter(GL_LINEAR);
+    }
+}
+
+/**
+ * Destroys the dynamic texture, deleting its texture.
+ */
+DynamicTexture::~DynamicTexture() {
+    const GLuint id = _texture.id();
+    StateCache::current().forgetTexture(id);
+    glDeleteTextures(1, &id);
+}
+
+/**
+ * Returns the number of bytes that rows are multiples of.
+ */
+GLint DynamicTexture::alignment() const {
+    return _bitmap.alignment;
+}
+
+/**
+ * Copies the pixels of a bitmap so they can be changed.
+ *
+ * @param bitmap Bitmap to copy
+ * @return Bitmap that is the only owner of its pixels
+ */
+Bitmap DynamicTexture::copy(const Bitmap& bitmap) {
+    Bitmap result;
+    result.setPixels(new GLubyte[bitmap.size], NULL);
+    memcpy(result.pixels, bitmap.pixels, bitmap.size);
+    result.format = bitmap.format;
+    result.width = bitmap.width;
+    result.height = bitmap.height;
+    result.size = bitmap.size;
+    result.alignment = bitmap.alignment;
+    return result;
+}
+
+/**
+ * Returns the pixels so they can be changed directly.
+ *
+ * Pass every changed rectangle to [invalidate] afterwards.
+ *
+ * [invalidate]: @ref invalidate(GLint, GLint, GLsizei, GLsizei) "invalidate(GLint, GLint, GLsizei, GLsizei)"
+ */
+GLubyte* DynamicTexture::data() {
+    return _bitmap.pixels;
+}
+
+/**
+ * Returns the rectangles changed since the last update.
+ */
+const DirtyRegion& DynamicTexture::dirty() const {
+    return _dirty;
+}
+
+/**
+ * Returns the format of the pixels.
+ */
+GLenum DynamicTexture::format() const {
+    return _bitmap.format;
+}
+
+/**
+ * Returns the size of the texture in the Y direction.
+ */
+GLsizei DynamicTexture::height() const {
+    return _bitmap.height;
+}
+
+/**
+ * Marks a rectangle as changed so it is uploaded by the next update.
+ *
+ * @param x Position of the left edge of the rectangle
+ * @param y Position of the bottom edge of the rectangle
+ * @param width Size of the rectangle in the X direction
+ * @param height Size of the rectangle in the Y direction
+ * @return Reference to this texture to support chaining
+ */
+DynamicTexture& DynamicTexture::invalidate(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
+    _dirty.add(x, y, width, height);
+    return (*this);
+}
+
+/**
+ * Returns the number of bytes between the starts of two rows.
+ */
+GLsizei DynamicTexture::stride() const {
+    return _stride;
+}
+
+/**
+ * Returns the texture holding the pixels as of the last update.
+ */
+const Gloop::TextureObject& DynamicTexture::texture() const {
+    return _texture;
+}
+
+/**
+ * Uploads the changed rectangles to the texture on the current texture unit.
+ *
+ * Unpack settings are restored afterwards, without asking OpenGL for them
+ * once the state cache knows them.  No pixel unpack buffer is left bound,
+ * and the texture is still bound to the texture unit.
+ *
+ * @return Number of bytes uploaded
+ */
+size_t DynamicTexture::update() {
+
+    if (_dirty.empty()) {
+        return 0;
+    }
+
+    // Bind texture
+    StateCache& state = StateCache::current();
+    const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
+    state.bindTexture(GL_TEXTURE_2D, _texture.id());
+
+    // Store unpack settings
+    const GLint lastAlignment = state.pixelStore(GL_UNPACK_ALIGNMENT);
+    const GLint lastRowLength = state.pixelStore(GL_UNPACK_ROW_LENGTH);
+    const GLint lastSkipPixels = state.pixelStore(GL_UNPACK_SKIP_PIXELS);
+    const GLint lastSkipRows = state.pixelStore(GL_UNPACK_SKIP_ROWS);
+
+    // Read rows straight out of the pixels
+    state.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    state.pixelStore(GL_UNPACK_ALIGNMENT, _bitmap.alignment);
+    state.pixelStore(GL_UNPACK_ROW_LENGTH, _bitmap.width);
+    state.pixelStore(GL_UNPACK_SKIP_PIXELS, 0);
+    state.pixelStore(GL_UNPACK_SKIP_ROWS, 0);
+
+    // Upload everything at once if most of it changed, otherwise each rectangle
+    const size_t bytesPerPixel = Bitmap::sizeOf(_bitmap.format);
+    size_t uploaded = 0;
+    if (_dirty.area() * 2 >= ((size_t) _bitmap.width) * _bitmap.height) {
+        glTexSubImage2D(
+                GL_TEXTURE_2D,    // target
+                0,                // level
+                0,                // x offset
+                0,                // y offset
+                _bitmap.width,    // width
+                _bitmap.height,   // height
+                _bitmap.format,   // format
+                GL_UNSIGNED_BYTE, // type
+                _bitmap.pixels);  // data
+        uploaded = ((size_t) _bitmap.width) * _bitmap.height * bytesPerPixel;
+    } else {
+        for (size_t i = 0; i < _dirty.size(); ++i) {
+            const DirtyRegion::Rectangle& rectangle = _dirty.rectangle(i);
+            glTexSubImage2D(
+                    GL_TEXTURE_2D,
+                    0,
+                    rectangle.x,
+                    rectangle.y,
+                    rectangle.width,
+                    rectangle.height,
+                    _bitmap.format,
+                    GL_UNSIGNED_BYTE,
+                    _bitmap.pixels + rectangle.y * _stride + rectangle.x * bytesPerPixel);
+            uploaded += ((size_t) rectangle.width) * rectangle.height * bytesPerPixel;
+        }
+    }
+
+    // Restore unpack settings
+    state.pixelStore(GL_UNPACK_ALIGNMENT, lastAlignment);
+    state.pixelStore(GL_UNPACK_ROW_LENGTH, lastRowLength);
+    state.pixelStore(GL_UNPACK_SKIP_PIXELS, lastSkipPixels);
+    state.pixelStore(GL_UNPACK_SKIP_ROWS, lastSkipRows);
+
+    // Regenerate mipmaps
+    if (_mipmaps) {
+        target.generateMipmap();
+    }
+
+    _dirty.clear();
+    return uploaded;
+}
+
+/**
+ * Returns the size of the texture in the X direction.
+ */
+GLsizei DynamicTexture::width() const {
+    return _bitmap.width;
+}
+
+/**
+ * Copies pixels into a rectangle and marks it as changed.
+ *
+ * @param x Position of the left edge of the rectangle
+ * @param y Position of the bottom edge of the rectangle
+ * @param width Size of the rectangle in the X direction
+ * @param height Size of the rectangle in the Y direction
+ * @param pixels Rows of the rectangle from the bottom up, in the format of the texture with no padding
+ * @return Reference to this texture to support chaining
+ * @throws invalid_argument if pixels is `NULL` or the rectangle is not inside the texture
+ */
+DynamicTexture& DynamicTexture::write(const GLint x,
+                                      const GLint y,
+                                      const GLsizei width,
+                                      const GLsizei height,
+                                      const GLubyte* const pixels) {
+
+    if (pixels == NULL) {
+        throw invalid_argument("[DynamicTexture] Pixels are NULL!");
+    } else if ((x < 0) || (y < 0) || (width < 0) || (height < 0)
+            || (x + width > _bitmap.width) || (y + height > _bitmap.height)) {
+        throw invalid_argument("[DynamicTexture] Rectangle is not inside the texture!");
+    }
+
+    // Copy each row
+    const size_t bytesPerPixel = Bitmap::sizeOf(_bitmap.format);
+    const size_t rowSize = width * bytesPerPixel;
+    for (GLsizei row = 0; row < height; ++row) {
+        memcpy(_bitmap.pixels + (y + row) * _stride + x * bytesPerPixel, pixels + row * rowSize, rowSize);
+    }
+
+    _dirty.add(x, y, width, height);
+    return (*this);
+}
+
+} /* namespace Glycerin */
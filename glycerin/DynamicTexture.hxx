@@ -0,0 +1,91 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_DYNAMICTEXTURE_HXX
+#define GLYCERIN_DYNAMICTEXTURE_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <gloop/TextureObject.hxx>
+#include "glycerin/Bitmap.hxx"
+#include "glycerin/DirtyRegion.hxx"
+namespace Glycerin {
+
+
+/**
+ * Texture whose pixels can be changed a little at a time.
+ *
+ * Making a new texture from a bitmap uploads every pixel again, even when
+ * only a few of them changed.  _DynamicTexture_ keeps its own copy of the
+ * pixels, remembers which rectangles were changed in a [dirty region], and
+ * only uploads those rectangles with `glTexSubImage2D` when [update] is
+ * called.  Rows are read straight out of the copy using the alignment of the
+ * original bitmap, so nothing is repacked before uploading.
+ *
+ * ~~~
+ * DynamicTexture texture(bitmap);
+ * while (running) {
+ *     texture.write(x, y, 8, 8, cell);
+ *     texture.update();
+ *     draw();
+ * }
+ * ~~~
+ *
+ * Pixels can also be changed directly through [data], in which case the
+ * changed rectangle must be passed to [invalidate].  Rows are [stride] bytes
+ * apart and start from the bottom of the image.  When most of the image has
+ * changed, [update] simply uploads all of it at once.
+ *
+ * The OpenGL context must be current whenever the texture is made, updated,
+ * or destroyed.
+ *
+ * [data]: @ref data() "data()"
+ * [dirty region]: @ref DirtyRegion "DirtyRegion"
+ * [invalidate]: @ref invalidate(GLint, GLint, GLsizei, GLsizei) "invalidate(GLint, GLint, GLsizei, GLsizei)"
+ * [stride]: @ref stride() const "stride()"
+ * [update]: @ref update() "update()"
+ */
+class DynamicTexture {
+public:
+// Methods
+    explicit DynamicTexture(const Bitmap& bitmap, bool mipmaps = false);
+    virtual ~DynamicTexture();
+    GLint alignment() const;
+    GLubyte* data();
+    const DirtyRegion& dirty() const;
+    GLenum format() const;
+    GLsizei height() const;
+    DynamicTexture& invalidate(GLint x, GLint y, GLsizei width, GLsizei height);
+    GLsizei stride() const;
+    const Gloop::TextureObject& texture() const;
+    size_t update();
+    GLsizei width() const;
+    DynamicTexture& write(GLint x, GLint y, GLsizei width, GLsizei height, const GLubyte* pixels);
+private:
+// Attributes
+    Bitmap _bitmap;
+    DirtyRegion _dirty;
+    bool _mipmaps;
+    GLsizei _stride;
+    Gloop::TextureObject _texture;
+// Methods
+    DynamicTexture(const DynamicTexture&);
+    DynamicTexture& operator=(const DynamicTexture&);
+    static Bitmap copy(const Bitmap& bitmap);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/DynamicTexture.hxx"
+
+
+/**
+ * Test for `DynamicTexture`.
+ */
+class DynamicTextureTest {
+public:
+
+    /**
+     * Tests `DynamicTexture::update` after writing to a rectangle.
+     */
+    void testUpdate() {
+
+        // Make a texture with padded rows
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(37, 21).seed(7).generate();
+        Glycerin::DynamicTexture texture(bitmap);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, texture.update());
+
+        // Change a small rectangle
+        const GLubyte cell[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+        texture.write(5, 3, 2, 2, cell);
+        CPPUNIT_ASSERT(texture.update() == sizeof(cell));
+        CPPUNIT_ASSERT(texture.dirty().empty());
+
+        // Read the texture back and compare it to the copy
+        const GLsizei stride = texture.stride();
+        std::vector<GLubyte> actual(stride * texture.height());
+        glPixelStorei(GL_PACK_ALIGNMENT, texture.alignment());
+        glGetTexImage(GL_TEXTURE_2D, 0, texture.format(), GL_UNSIGNED_BYTE, &actual[0]);
+        for (GLsizei y = 0; y < texture.height(); ++y) {
+            for (GLsizei x = 0; x < texture.width() * 3; ++x) {
+                CPPUNIT_ASSERT(actual[y * stride + x] == texture.data()[y * stride + x]);
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(12, (int) actual[4 * stride + 6 * 3 + 2]);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        DynamicTextureTest test;
+        test.testUpdate();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,436 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "glycerin/BitmapWriter.hxx"
+#include "glycerin/FrameCapture.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a frame capture for a framebuffer of a certain size.
+ *
+ * No OpenGL objects are made until the first capture.
+ *
+ * @param width Size of the frames in the X direction
+ * @param height Size of the frames in the Y direction
+ * @throws invalid_argument if width or height is less than one
+ */
+FrameCapture::FrameCapture(const GLsizei width, const GLsizei height) :
+        _dropped(0),
+        _frameNumber(0),
+        _height(height),
+        _next(0),
+        _prefix("capture-"),
+        _queueDepth(DEFAULT_QUEUE_DEPTH),
+        _slots(DEFAULT_BUFFERS),
+        _started(false),
+        _stopping(false),
+        _width(width),
+        _written(0) {
+    if ((width < 1) || (height < 1)) {
+        throw invalid_argument("[FrameCapture] Width and height must be positive!");
+    }
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_condition, NULL);
+}
+
+/**
+ * Destroys the frame capture, first writing any frames still in flight.
+ */
+FrameCapture::~FrameCapture() {
+    finish();
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_mutex);
+}
+
+/**
+ * Changes the number of pixel pack buffers frames are read into.
+ *
+ * More buffers let the GPU fall further behind before frames are dropped, at
+ * the cost of one frame of memory each.
+ *
+ * @param buffers Number of buffers in the ring
+ * @return Reference to this capture to support chaining
+ * @throws invalid_argument if buffers is zero
+ * @throws logic_error if frames have already been captured
+ */
+FrameCapture& FrameCapture::buffers(const size_t buffers) {
+    if (buffers == 0) {
+        throw invalid_argument("[FrameCapture] Number of buffers is zero!");
+    } else if (_started) {
+        throw logic_error("[FrameCapture] Already capturing!");
+    }
+    _slots.resize(buffers);
+    return (*this);
+}
+
+/**
+ * Starts reading the current framebuffer into the next free buffer.
+ *
+ * Call this after drawing a frame and before swapping buffers.  Frames read
+ * earlier whose fences have passed are handed to the background thread
+ * first.  Frames are numbered in the order this method is called, including
+ * dropped ones.
+ *
+ * @return `true` if the frame is being read, `false` if it was dropped because every buffer is busy
+ * @throws runtime_error if the background thread could not be started
+ */
+bool FrameCapture::capture() {
+
+    if (!_started) {
+        start();
+    }
+
+    // Recycle buffers the worker is done with, then hand over finished reads
+    release();
+    collect(false);
+
+    // Drop the frame if the next buffer is still busy
+    Slot& slot = _slots[_next];
+    pthread_mutex_lock(&_mutex);
+    const bool busy = (slot.state != IDLE);
+    if (busy) {
+        ++_dropped;
+    }
+    pthread_mutex_unlock(&_mutex);
+    const size_t number = _frameNumber++;
+    if (busy) {
+        return false;
+    }
+
+    // Read into the buffer and mark when the read is done
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glReadPixels(0, 0, _width, _height, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = number;
+    slot.state = READING;
+    _next = (_next + 1) % _slots.size();
+    return true;
+}
+
+/**
+ * Maps buffers whose reads have finished and hands them to the worker.
+ *
+ * @param wait `true` to block until every read has finished, `false` to only take finished ones
+ */
+void FrameCapture::collect(const bool wait) {
+    const size_t size = ((size_t) _width) * _height * 4;
+    for (size_t k = 0; k < _slots.size(); ++k) {
+        const size_t i = (_next + k) % _slots.size();
+        Slot& slot = _slots[i];
+        if (slot.state != READING) {
+            continue;
+        }
+
+        // Check the fence
+        const GLenum status = wait
+                ? glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FINISH_TIMEOUT)
+                : glClientWaitSync(slot.fence, 0, 0);
+        const bool done = (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+        if (!done && !wait) {
+            continue;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = NULL;
+
+        // Map the buffer
+        slot.data = NULL;
+        if (done) {
+            StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            slot.data = (const GLubyte*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+            StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        // Hand it over
+        pthread_mutex_lock(&_mutex);
+        if (slot.data == NULL) {
+            slot.state = IDLE;
+            ++_dropped;
+        } else {
+            slot.state = MAPPED;
+            _copies.push_back(i);
+            pthread_cond_broadcast(&_condition);
+        }
+        pthread_mutex_unlock(&_mutex);
+    }
+}
+
+/**
+ * Copies the pixels out of a mapped buffer.
+ *
+ * @param slot Buffer holding a finished read
+ * @return Bitmap with the pixels of the frame
+ */
+Bitmap FrameCapture::copy(const Slot& slot) const {
+    const GLsizei size = _width * _height * 4;
+    Bitmap bitmap;
+    bitmap.setPixels(new GLubyte[size], NULL);
+    memcpy(bitmap.pixels, slot.data, size);
+    bitmap.format = GL_BGRA;
+    bitmap.width = _width;
+    bitmap.height = _height;
+    bitmap.size = size;
+    bitmap.alignment = 4;
+    return bitmap;
+}
+
+/**
+ * Returns the number of frames dropped so far.
+ *
+ * Frames are dropped when every buffer is busy, when too many frames are
+ * waiting to be written, or when a buffer could not be read.
+ */
+size_t FrameCapture::dropped() {
+    pthread_mutex_lock(&_mutex);
+    const size_t dropped = _dropped;
+    pthread_mutex_unlock(&_mutex);
+    return dropped;
+}
+
+/**
+ * Waits for every frame in flight to be written, then frees the buffers and stops the background thread.
+ *
+ * Capturing again afterwards starts over with new buffers, continuing the
+ * frame numbers.
+ */
+void FrameCapture::finish() {
+
+    if (!_started) {
+        return;
+    }
+
+    // Hand over every read, and wait for the worker to copy them
+    collect(true);
+    pthread_mutex_lock(&_mutex);
+    while (!_copies.empty()) {
+        pthread_cond_wait(&_condition, &_mutex);
+    }
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        while (_slots[i].state == MAPPED) {
+            pthread_cond_wait(&_condition, &_mutex);
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+    release();
+
+    // Let the worker write the rest and stop
+    pthread_mutex_lock(&_mutex);
+    _stopping = true;
+    pthread_cond_broadcast(&_condition);
+    pthread_mutex_unlock(&_mutex);
+    pthread_join(_worker, NULL);
+
+    // Free the buffers
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        glDeleteBuffers(1, &_slots[i].buffer);
+    }
+    _stopping = false;
+    _started = false;
+}
+
+/**
+ * Determines the name of the file a frame is written to.
+ *
+ * @param number Number of the frame
+ * @return Path to the file for the frame
+ */
+string FrameCapture::getFilename(const size_t number) const {
+    stringstream stream;
+    stream << _prefix << setw(6) << setfill('0') << number << ".bmp";
+    return stream.str();
+}
+
+/**
+ * Changes the start of the path for each file.
+ *
+ * @param prefix Start of the path for each file, by default `capture-`
+ * @return Reference to this capture to support chaining
+ * @throws logic_error if frames have already been captured
+ */
+FrameCapture& FrameCapture::prefix(const string& prefix) {
+    if (_started) {
+        throw logic_error("[FrameCapture] Already capturing!");
+    }
+    _prefix = prefix;
+    return (*this);
+}
+
+/**
+ * Returns the number of frames read back but not yet written.
+ */
+size_t FrameCapture::queued() {
+    pthread_mutex_lock(&_mutex);
+    const size_t queued = _copies.size() + _frames.size();
+    pthread_mutex_unlock(&_mutex);
+    return queued;
+}
+
+/**
+ * Changes the number of frames that may wait to be written before new ones are dropped.
+ *
+ * @param queueDepth Largest number of frames waiting to be written
+ * @return Reference to this capture to support chaining
+ * @throws invalid_argument if queueDepth is zero
+ * @throws logic_error if frames have already been captured
+ */
+FrameCapture& FrameCapture::queueDepth(const size_t queueDepth) {
+    if (queueDepth == 0) {
+        throw invalid_argument("[FrameCapture] Queue depth is zero!");
+    } else if (_started) {
+        throw logic_error("[FrameCapture] Already capturing!");
+    }
+    _queueDepth = queueDepth;
+    return (*this);
+}
+
+/**
+ * Unmaps buffers the worker has finished copying so they can be read into again.
+ */
+void FrameCapture::release() {
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        Slot& slot = _slots[i];
+        pthread_mutex_lock(&_mutex);
+        const bool copied = (slot.state == COPIED);
+        pthread_mutex_unlock(&_mutex);
+        if (copied) {
+            StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.data = NULL;
+            slot.state = IDLE;
+        }
+    }
+}
+
+/**
+ * Runs the worker on the background thread.
+ *
+ * @param capture Pointer to the frame capture
+ * @return `NULL` always
+ */
+void* FrameCapture::runWorker(void* const capture) {
+    ((FrameCapture*) capture)->work();
+    return NULL;
+}
+
+/**
+ * Makes the buffers and starts the background thread.
+ *
+ * @throws runtime_error if the background thread could not be started
+ */
+void FrameCapture::start() {
+
+    // Make the buffers
+    const size_t size = ((size_t) _width) * _height * 4;
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        Slot& slot = _slots[i];
+        glGenBuffers(1, &slot.buffer);
+        StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        slot.fence = NULL;
+        slot.data = NULL;
+        slot.frame = 0;
+        slot.state = IDLE;
+    }
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _next = 0;
+
+    // Start the worker
+    if (pthread_create(&_worker, NULL, &runWorker, this) != 0) {
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            glDeleteBuffers(1, &_slots[i].buffer);
+        }
+        throw runtime_error("[FrameCapture] Could not start worker thread!");
+    }
+    _started = true;
+}
+
+/**
+ * Copies and writes frames until told to stop.
+ */
+void FrameCapture::work() {
+    BitmapWriter writer;
+    pthread_mutex_lock(&_mutex);
+    while (true) {
+
+        // Wait for something to do
+        while (_copies.empty() && _frames.empty() && !_stopping) {
+            pthread_cond_wait(&_condition, &_mutex);
+        }
+
+        // Copy mapped buffers first so they can be reused soon
+        if (!_copies.empty()) {
+            const size_t index = _copies.front();
+            _copies.pop_front();
+            const Slot slot = _slots[index];
+            pthread_mutex_unlock(&_mutex);
+            const Frame frame = { slot.frame, copy(slot) };
+            pthread_mutex_lock(&_mutex);
+            _slots[index].state = COPIED;
+            if (_frames.size() < _queueDepth) {
+                _frames.push_back(frame);
+            } else {
+                ++_dropped;
+            }
+            pthread_cond_broadcast(&_condition);
+            continue;
+        }
+
+        // Then write the oldest frame
+        if (!_frames.empty()) {
+            const Frame frame = _frames.front();
+            _frames.pop_front();
+            pthread_mutex_unlock(&_mutex);
+            bool succeeded = true;
+            try {
+                writer.write(frame.bitmap, getFilename(frame.number));
+            } catch (exception&) {
+                succeeded = false;
+            }
+            pthread_mutex_lock(&_mutex);
+            if (succeeded) {
+                ++_written;
+            } else {
+                ++_dropped;
+            }
+            continue;
+        }
+
+        // Nothing left and told to stop
+        break;
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+/**
+ * Returns the number of frames written to files so far.
+ */
+size_t FrameCapture::written() {
+    pthread_mutex_lock(&_mutex);
+    const size_t written = _written;
+    pthread_mutex_unlock(&_mutex);
+    return written;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,128 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_FRAMECAPTURE_HXX
+#define GLYCERIN_FRAMECAPTURE_HXX
+#include "glycerin/common.h"
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for saving rendered frames to bitmap files without stalling.
+ *
+ * Reading pixels straight into client memory makes the CPU wait for the GPU
+ * to finish the frame.  _FrameCapture_ instead reads each frame into one of a
+ * ring of pixel pack buffers and puts a fence after it.  Buffers whose fences
+ * have passed are mapped and handed to a background thread, which copies the
+ * pixels out and writes them as bitmap files named with the prefix and the
+ * number of the frame, such as `capture-000012.bmp`.
+ *
+ * ~~~
+ * FrameCapture capture(width, height);
+ * capture.prefix("session-");
+ * while (running) {
+ *     render();
+ *     capture.capture();
+ *     glfwSwapBuffers();
+ * }
+ * capture.finish();
+ * ~~~
+ *
+ * [capture] never waits.  If every buffer is still in use, or more frames are
+ * waiting to be written than the queue depth allows, the frame is dropped and
+ * counted by [dropped].  By default there are three buffers and up to eight
+ * frames may wait to be written.  The settings can only be changed before the
+ * first capture.
+ *
+ * Every method must be called on the thread that owns the OpenGL context,
+ * which must still be current when the capture is finished or destroyed.
+ *
+ * [capture]: @ref capture() "capture()"
+ * [dropped]: @ref dropped() "dropped()"
+ */
+class FrameCapture {
+public:
+// Methods
+    FrameCapture(GLsizei width, GLsizei height);
+    virtual ~FrameCapture();
+    FrameCapture& buffers(size_t buffers);
+    bool capture();
+    size_t dropped();
+    void finish();
+    FrameCapture& prefix(const std::string& prefix);
+    size_t queued();
+    FrameCapture& queueDepth(size_t queueDepth);
+    size_t written();
+private:
+// Types
+    enum State {
+        IDLE,
+        READING,
+        MAPPED,
+        COPIED
+    };
+    struct Slot {
+        GLuint buffer;
+        GLsync fence;
+        const GLubyte* data;
+        size_t frame;
+        State state;
+    };
+    struct Frame {
+        size_t number;
+        Bitmap bitmap;
+    };
+// Constants
+    static const size_t DEFAULT_BUFFERS = 3;
+    static const size_t DEFAULT_QUEUE_DEPTH = 8;
+    static const GLuint64 FINISH_TIMEOUT = 1000000000;
+// Attributes
+    std::deque<size_t> _copies;
+    pthread_cond_t _condition;
+    size_t _dropped;
+    std::deque<Frame> _frames;
+    size_t _frameNumber;
+    GLsizei _height;
+    pthread_mutex_t _mutex;
+    size_t _next;
+    std::string _prefix;
+    size_t _queueDepth;
+    std::vector<Slot> _slots;
+    bool _started;
+    bool _stopping;
+    GLsizei _width;
+    pthread_t _worker;
+    size_t _written;
+// Methods
+    FrameCapture(const FrameCapture&);
+    FrameCapture& operator=(const FrameCapture&);
+    void collect(bool wait);
+    Bitmap copy(const Slot& slot) const;
+    std::string getFilename(size_t number) const;
+    void release();
+    static void* runWorker(void* capture);
+    void start();
+    void work();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/BitmapReader.hxx"
+#include "glycerin/FrameCapture.hxx"
+
+
+/**
+ * Test for `FrameCapture`.
+ */
+class FrameCaptureTest {
+public:
+
+    /**
+     * Tests `FrameCapture::capture` and `FrameCapture::finish`.
+     */
+    void testCapture() {
+
+        // Capture a few frames
+        Glycerin::FrameCapture capture(512, 512);
+        capture.prefix("FrameCaptureTest-").buffers(2);
+        size_t captured = 0;
+        for (int i = 0; i < 4; ++i) {
+            glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            if (capture.capture()) {
+                ++captured;
+            }
+            glfwSwapBuffers();
+        }
+        capture.finish();
+
+        // Check the counts
+        CPPUNIT_ASSERT(captured > 0);
+        CPPUNIT_ASSERT(capture.written() == captured);
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, capture.written() + capture.dropped());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, capture.queued());
+
+        // Check the files and remove them
+        bool checked = false;
+        for (int i = 0; i < 4; ++i) {
+            std::stringstream stream;
+            stream << "FrameCaptureTest-00000" << i << ".bmp";
+            const std::string filename = stream.str();
+            std::FILE* const file = std::fopen(filename.c_str(), "rb");
+            if (file == NULL) {
+                continue;
+            }
+            std::fclose(file);
+            if (!checked) {
+                const Glycerin::Bitmap bitmap = Glycerin::BitmapReader().read(filename);
+                CPPUNIT_ASSERT_EQUAL(512, bitmap.getWidth());
+                CPPUNIT_ASSERT_EQUAL(512, bitmap.getHeight());
+                std::vector<GLubyte> pixels(bitmap.getSize());
+                bitmap.getPixels(&pixels[0], pixels.size());
+                CPPUNIT_ASSERT_EQUAL(0, (int) pixels[0]);
+                CPPUNIT_ASSERT_EQUAL(0, (int) pixels[1]);
+                CPPUNIT_ASSERT_EQUAL(255, (int) pixels[2]);
+                checked = true;
+            }
+            std::remove(filename.c_str());
+        }
+        CPPUNIT_ASSERT(checked);
+    }
+
+    /**
+     * Tests that settings are rejected once capturing has started.
+     */
+    void testSettingsAfterCapture() {
+        Glycerin::FrameCapture capture(512, 512);
+        capture.prefix("FrameCaptureTest-");
+        capture.capture();
+        try {
+            capture.buffers(4);
+            throw std::runtime_error("Changed buffers while capturing!");
+        } catch (std::logic_error& e) {
+            // expected
+        }
+        capture.finish();
+        std::remove("FrameCaptureTest-000000.bmp");
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run tests
+    try {
+        FrameCaptureTest test;
+        test.testCapture();
+        test.testSettingsAfterCapture();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include "glycerin/GlyphTable.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs an empty glyph table.
+ */
+GlyphTable::GlyphTable() : _blocks(NUMBER_OF_BLOCKS, NO_BLOCK), _pages(0), _size(0) {
+    const Slot slot = { 0, 0 };
+    _fallback = slot;
+}
+
+/**
+ * Destroys the glyph table.
+ */
+GlyphTable::~GlyphTable() {
+    // empty
+}
+
+/**
+ * Adds or replaces the glyph of a code point.
+ *
+ * @param codePoint Code point to add
+ * @param page Page of the atlas the glyph is on
+ * @param index Index of the glyph in its page
+ * @return Reference to this table to support chaining
+ * @throws invalid_argument if code point is past U+10FFFF or page is invalid
+ */
+GlyphTable& GlyphTable::add(const GLuint codePoint, const GLuint page, const GLuint index) {
+    return add(codePoint, 1, page, index);
+}
+
+/**
+ * Adds or replaces the glyphs of a range of code points stored one after another.
+ *
+ * @param first First code point to add
+ * @param count Number of code points to add
+ * @param page Page of the atlas the glyphs are on
+ * @param index Index of the first glyph in its page
+ * @return Reference to this table to support chaining
+ * @throws invalid_argument if the range goes past U+10FFFF or page is invalid
+ */
+GlyphTable& GlyphTable::add(const GLuint first, const GLuint count, const GLuint page, const GLuint index) {
+
+    if ((first > MAX_CODE_POINT) || (count > MAX_CODE_POINT + 1 - first)) {
+        throw invalid_argument("[GlyphTable] Code points must not be past U+10FFFF!");
+    } else if (page == NO_PAGE) {
+        throw invalid_argument("[GlyphTable] Page is invalid!");
+    }
+
+    for (GLuint i = 0; i < count; ++i) {
+
+        // Make storage for the block the first time it is used
+        const GLuint codePoint = first + i;
+        GLint& block = _blocks[codePoint >> BLOCK_SHIFT];
+        if (block == NO_BLOCK) {
+            const Slot empty = { NO_PAGE, 0 };
+            block = _slots.size();
+            _slots.resize(_slots.size() + BLOCK_SIZE, empty);
+        }
+
+        // Store the slot
+        Slot& slot = _slots[block + (codePoint & (BLOCK_SIZE - 1))];
+        if (slot.page == NO_PAGE) {
+            ++_size;
+        }
+        slot.page = page;
+        slot.index = index + i;
+    }
+
+    _pages = max(_pages, page + 1);
+    return (*this);
+}
+
+/**
+ * Checks if a code point has a glyph of its own.
+ *
+ * @param codePoint Code point to check
+ * @return `true` if the code point was added
+ */
+bool GlyphTable::contains(const GLuint codePoint) const {
+    return &find(codePoint) != &_fallback;
+}
+
+/**
+ * Returns the slot used for code points without a glyph of their own.
+ */
+const GlyphTable::Slot& GlyphTable::fallback() const {
+    return _fallback;
+}
+
+/**
+ * Changes the glyph used for code points without one of their own.
+ *
+ * @param codePoint Code point whose glyph to use, which must already be added
+ * @return Reference to this table to support chaining
+ * @throws invalid_argument if code point was not added
+ */
+GlyphTable& GlyphTable::fallback(const GLuint codePoint) {
+    if (!contains(codePoint)) {
+        throw invalid_argument("[GlyphTable] Fallback code point has no glyph!");
+    }
+    _fallback = find(codePoint);
+    return (*this);
+}
+
+/**
+ * Looks up the glyph of a code point.
+ *
+ * @param codePoint Code point to look up
+ * @return Slot of the code point's glyph, or of the fallback glyph if it has none
+ */
+const GlyphTable::Slot& GlyphTable::find(const GLuint codePoint) const {
+    if (codePoint > MAX_CODE_POINT) {
+        return _fallback;
+    }
+    const GLint block = _blocks[codePoint >> BLOCK_SHIFT];
+    if (block == NO_BLOCK) {
+        return _fallback;
+    }
+    const Slot& slot = _slots[block + (codePoint & (BLOCK_SIZE - 1))];
+    return (slot.page == NO_PAGE) ? _fallback : slot;
+}
+
+/**
+ * Returns the number of pages glyphs were added on.
+ */
+GLuint GlyphTable::pages() const {
+    return _pages;
+}
+
+/**
+ * Returns the number of code points with a glyph of their own.
+ */
+size_t GlyphTable::size() const {
+    return _size;
+}
+
+} /* namespace Glycerin */
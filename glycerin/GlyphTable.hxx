@@ -0,0 +1,83 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_GLYPH_TABLE_HXX
+#define GLYCERIN_GLYPH_TABLE_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Map from code points to the places of their glyphs in a font atlas.
+ *
+ * An atlas may be split over several pages, so each glyph has the page it is
+ * on as well as its index in that page.  Code points without a glyph of their
+ * own get a fallback glyph, which starts out as the first slot of the first
+ * page.
+ *
+ * Lookups cost two array reads.  Code points are grouped into blocks of 256,
+ * and storage is only made for blocks that have at least one glyph in them,
+ * so a table for a few scripts stays small.
+ *
+ * ~~~
+ * GlyphTable table;
+ * table.add(' ', 95, 0, 0).add(0x0400, 256, 1, 0).fallback('?');
+ * const GlyphTable::Slot& slot = table.find(codePoint);
+ * ~~~
+ */
+class GlyphTable {
+public:
+// Types
+    /**
+     * Place of a glyph in an atlas.
+     */
+    struct Slot {
+        GLuint page;
+        GLuint index;
+    };
+// Constants
+    static const GLuint MAX_CODE_POINT = 0x10FFFF;
+// Methods
+    GlyphTable();
+    virtual ~GlyphTable();
+    GlyphTable& add(GLuint codePoint, GLuint page, GLuint index);
+    GlyphTable& add(GLuint first, GLuint count, GLuint page, GLuint index);
+    bool contains(GLuint codePoint) const;
+    const Slot& fallback() const;
+    GlyphTable& fallback(GLuint codePoint);
+    const Slot& find(GLuint codePoint) const;
+    GLuint pages() const;
+    size_t size() const;
+private:
+// Constants
+    static const GLuint BLOCK_SIZE = 256;
+    static const GLuint BLOCK_SHIFT = 8;
+    static const GLuint NUMBER_OF_BLOCKS = (MAX_CODE_POINT + 1) / BLOCK_SIZE;
+    static const GLint NO_BLOCK = -1;
+    static const GLuint NO_PAGE = 0xFFFFFFFF;
+// Attributes
+    std::vector<GLint> _blocks;
+    Slot _fallback;
+    GLuint _pages;
+    size_t _size;
+    std::vector<Slot> _slots;
+};
+
+} /* namespace Glycerin */
+#endif
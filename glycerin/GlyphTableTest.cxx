@@ -0,0 +1,83 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/GlyphTable.hxx"
+
+
+/**
+ * Unit test for `GlyphTable`.
+ */
+class GlyphTableTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `GlyphTable::find` returns the slots of added code points on every page.
+     */
+    void testFind() {
+        Glycerin::GlyphTable table;
+        table.add(' ', 95, 0, 0).add(0x3FE, 4, 1, 10).add(0x1F600, 2, 0);
+        CPPUNIT_ASSERT_EQUAL((size_t) 100, table.size());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 3, table.pages());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 33, table.find('A').index);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0, table.find('A').page);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 12, table.find(0x400).index);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 1, table.find(0x400).page);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 2, table.find(0x1F600).page);
+        CPPUNIT_ASSERT(table.contains(0x401));
+        CPPUNIT_ASSERT(!table.contains(0x402));
+    }
+
+    /**
+     * Ensures `GlyphTable::find` returns the fallback for code points without a glyph.
+     */
+    void testFindWithFallback() {
+        Glycerin::GlyphTable table;
+        table.add(' ', 95, 0, 0).fallback('?');
+        CPPUNIT_ASSERT_EQUAL((GLuint) ('?' - ' '), table.find(0xE9).index);
+        CPPUNIT_ASSERT_EQUAL((GLuint) ('?' - ' '), table.find('\n').index);
+        CPPUNIT_ASSERT_EQUAL((GLuint) ('?' - ' '), table.find(0x110000).index);
+        CPPUNIT_ASSERT_EQUAL((GLuint) ('?' - ' '), table.fallback().index);
+    }
+
+    /**
+     * Ensures `GlyphTable` rejects invalid code points.
+     */
+    void testInvalidSettings() {
+        Glycerin::GlyphTable table;
+        CPPUNIT_ASSERT_THROW(table.add(0x110000, 0, 0), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(table.add(0x10FFFF, 2, 0, 0), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(table.fallback('?'), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(GlyphTableTest);
+    CPPUNIT_TEST(testFind);
+    CPPUNIT_TEST(testFindWithFallback);
+    CPPUNIT_TEST(testInvalidSettings);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(GlyphTableTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "glycerin/MappedFile.hxx"
+namespace Glycerin {
+
+/**
+ * Maps a file into memory.
+ *
+ * @param filename Path to the file to map
+ * @throws std::invalid_argument if file cannot be opened
+ * @throws std::runtime_error if file is empty or cannot be mapped
+ */
+MappedFile::MappedFile(const std::string& filename) : _data(NULL), _size(0) {
+
+    // Open the file
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("[MappedFile] File does not exist!");
+    }
+
+    // Find its size
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (info.st_size <= 0)) {
+        close(fd);
+        throw std::runtime_error("[MappedFile] File is empty!");
+    }
+
+    // Map it
+    void* const ptr = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("[MappedFile] File could not be mapped!");
+    }
+    _data = (GLubyte*) ptr;
+    _size = info.st_size;
+}
+
+/**
+ * Unmaps the file.
+ */
+MappedFile::~MappedFile() {
+    munmap(_data, _size);
+}
+
+/**
+ * Returns the start of the file in memory.
+ *
+ * @return Start of the file in memory
+ */
+GLubyte* MappedFile::data() const {
+    return _data;
+}
+
+/**
+ * Returns the size of the file.
+ *
+ * @return Size of the file in bytes
+ */
+size_t MappedFile::size() const {
+    return _size;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,49 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_MAPPED_FILE_HXX
+#define GLYCERIN_MAPPED_FILE_HXX
+#include <string>
+#include "glycerin/common.h"
+namespace Glycerin {
+
+
+/**
+ * Contents of a file mapped into memory.
+ *
+ * The mapping is private, so the contents can be changed in memory without
+ * changing the file.  Pages are only copied by the operating system when
+ * they are first written to.
+ */
+class MappedFile {
+public:
+// Methods
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+    GLubyte* data() const;
+    size_t size() const;
+private:
+// Attributes
+    GLubyte* _data;
+    size_t _size;
+// Methods
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/MappedFile.hxx"
+
+
+/**
+ * Unit test for `MappedFile`.
+ */
+class MappedFileTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `MappedFile::MappedFile` maps the whole file.
+     */
+    void testMappedFile() {
+        const Glycerin::MappedFile file("glycerin/rgbw.bmp");
+        CPPUNIT_ASSERT_EQUAL((size_t) 70, file.size());
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 'B', file.data()[0]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 'M', file.data()[1]);
+    }
+
+    /**
+     * Ensures writing to a `MappedFile` does not change the file.
+     */
+    void testMappedFileIsPrivate() {
+        {
+            const Glycerin::MappedFile file("glycerin/rgbw.bmp");
+            file.data()[0] = 'X';
+        }
+        const Glycerin::MappedFile file("glycerin/rgbw.bmp");
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 'B', file.data()[0]);
+    }
+
+    /**
+     * Ensures `MappedFile::MappedFile` throws if the file does not exist.
+     */
+    void testMappedFileWithMissingFile() {
+        CPPUNIT_ASSERT_THROW(Glycerin::MappedFile("glycerin/missing.bmp"), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(MappedFileTest);
+    CPPUNIT_TEST(testMappedFile);
+    CPPUNIT_TEST(testMappedFileIsPrivate);
+    CPPUNIT_TEST(testMappedFileWithMissingFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(MappedFileTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,533 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <pthread.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+#include <gloop/TextureTarget.hxx>
+#include "glycerin/BitmapReader.hxx"
+#include "glycerin/BitmapWriter.hxx"
+#include "glycerin/MipmapGenerator.hxx"
+#include "glycerin/Parallel.hxx"
+#include "glycerin/Simd.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+// Fills the conversion tables only once, even when several threads generate mipmaps at the same time
+static pthread_once_t tablesOnce = PTHREAD_ONCE_INIT;
+
+// Table converting 8-bit sRGB values to linear values
+GLfloat MipmapGenerator::toLinearTable[256];
+
+// Table converting linear values to 8-bit sRGB values
+GLubyte MipmapGenerator::toSrgbTable[MipmapGenerator::TABLE_SIZE];
+
+/**
+ * Level held as four floats per pixel, in the same order as the bitmap.
+ */
+struct MipmapGenerator::Image {
+    GLsizei width;
+    GLsizei height;
+    vector<GLfloat> values;
+};
+
+/**
+ * Source samples and their weights for each sample along one axis of a level.
+ */
+struct MipmapGenerator::Weights {
+    GLsizei srcSize;
+    int taps;
+    vector<GLint> first;
+    vector<GLfloat> values;
+};
+
+/**
+ * Converts a range of rows of a bitmap to floats.
+ */
+class MipmapGenerator::DecodeTask : public Parallel::Task {
+public:
+    DecodeTask(const Bitmap& bitmap, const GLfloat* toLinear, Image& image) :
+            bitmap(bitmap), toLinear(toLinear), image(image) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Bitmap& bitmap;
+    const GLfloat* const toLinear;
+    Image& image;
+};
+
+/**
+ * Shrinks a range of rows horizontally.
+ */
+class MipmapGenerator::RowTask : public Parallel::Task {
+public:
+    RowTask(const Image& src, const Weights& weights, Image& dst) :
+            src(src), weights(weights), dst(dst) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Image& src;
+    const Weights& weights;
+    Image& dst;
+};
+
+/**
+ * Shrinks a range of rows vertically and stores them in a bitmap.
+ */
+class MipmapGenerator::ColumnTask : public Parallel::Task {
+public:
+    ColumnTask(const Image& src, const Weights& weights, const GLubyte* toSrgb, Image& dst, Bitmap& bitmap) :
+            src(src), weights(weights), toSrgb(toSrgb), dst(dst), bitmap(bitmap) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Image& src;
+    const Weights& weights;
+    const GLubyte* const toSrgb;
+    Image& dst;
+    Bitmap& bitmap;
+};
+
+/**
+ * Constructs a mipmap generator with default settings.
+ */
+MipmapGenerator::MipmapGenerator() :
+        _filter(BOX),
+        _gammaCorrect(true) {
+    // empty
+}
+
+/**
+ * Destroys the mipmap generator.
+ */
+MipmapGenerator::~MipmapGenerator() {
+    // empty
+}
+
+/**
+ * Fills the tables converting between sRGB and linear values.
+ */
+void MipmapGenerator::createTables() {
+    for (int i = 0; i < 256; ++i) {
+        const double c = i / 255.0;
+        toLinearTable[i] = (GLfloat) ((c <= 0.04045) ? (c / 12.92) : pow((c + 0.055) / 1.055, 2.4));
+    }
+    for (int i = 0; i < TABLE_SIZE; ++i) {
+        const double l = ((double) i) / (TABLE_SIZE - 1);
+        const double c = (l <= 0.0031308) ? (l * 12.92) : (1.055 * pow(l, 1 / 2.4) - 0.055);
+        toSrgbTable[i] = (GLubyte) (c * 255 + 0.5);
+    }
+}
+
+/**
+ * Creates a new OpenGL texture on the current texture unit from a mipmap chain.
+ *
+ * Each level is uploaded in turn, and `GL_TEXTURE_MAX_LEVEL` is set so the
+ * texture is complete without calling `glGenerateMipmap`.  Like
+ * `Bitmap::createTexture`, the unpack alignment is restored afterwards and the
+ * texture is left bound.
+ *
+ * @param levels Mipmap chain made by [generate](@ref generate)
+ * @return Handle for the new OpenGL texture
+ * @throws invalid_argument if there are no levels
+ */
+Gloop::TextureObject MipmapGenerator::createTexture(const vector<Bitmap>& levels) {
+
+    if (levels.empty()) {
+        throw invalid_argument("[MipmapGenerator] No levels to upload!");
+    }
+
+    // Generate and bind a new texture
+    const Gloop::TextureObject texture = Gloop::TextureObject::generate();
+    const Gloop::TextureTarget target = Gloop::TextureTarget::texture2d();
+    StateCache::current().bindTexture(GL_TEXTURE_2D, texture.id());
+
+    // Load each level
+    const GLenum lastAlignment = Bitmap::getUnpackAlignment();
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const Bitmap& level = levels[i];
+        const GLint internalFormat = Bitmap::getInternalFormat(level.format);
+        Bitmap::setUnpackAlignment(level.alignment);
+        target.texImage2d(
+                    i,                // level
+                    internalFormat,   // internal format
+                    level.width,      // width
+                    level.height,     // height
+                    level.format,     // format
+                    GL_UNSIGNED_BYTE, // type
+                    level.pixels);    // data
+    }
+    Bitmap::setUnpackAlignment(lastAlignment);
+
+    // Only use the levels that were loaded
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels.size() - 1);
+    return texture;
+}
+
+/**
+ * Computes the weights for shrinking one axis of a level.
+ *
+ * @param filter Filter to use
+ * @param srcSize Number of samples along the axis in the larger level
+ * @param dstSize Number of samples along the axis in the smaller level
+ * @return Weights for each sample in the smaller level, summing to one
+ */
+MipmapGenerator::Weights MipmapGenerator::createWeights(const Filter filter,
+                                                        const GLsizei srcSize,
+                                                        const GLsizei dstSize) {
+
+    const double scale = ((double) srcSize) / dstSize;
+    const double support = ((filter == KAISER) ? 2.0 : 0.5) * scale;
+
+    Weights weights;
+    weights.srcSize = srcSize;
+    weights.taps = (int) ceil(2 * support) + 1;
+    weights.first.resize(dstSize);
+    weights.values.resize(((size_t) dstSize) * weights.taps);
+
+    for (GLsizei x = 0; x < dstSize; ++x) {
+        const double center = (x + 0.5) * scale;
+        const GLint first = (GLint) floor(center - support);
+        GLfloat* const values = &weights.values[((size_t) x) * weights.taps];
+        double sum = 0;
+        for (int k = 0; k < weights.taps; ++k) {
+            values[k] = evaluate(filter, (first + k + 0.5 - center) / scale);
+            sum += values[k];
+        }
+        for (int k = 0; k < weights.taps; ++k) {
+            values[k] = (GLfloat) (values[k] / sum);
+        }
+        weights.first[x] = first;
+    }
+    return weights;
+}
+
+/**
+ * Evaluates a filter.
+ *
+ * @param filter Filter to evaluate
+ * @param x Distance from the center of the filter, in pixels of the smaller level
+ * @return Unnormalized weight of the filter at that distance
+ */
+GLfloat MipmapGenerator::evaluate(const Filter filter, const double x) {
+
+    const double d = fabs(x);
+    if (filter == BOX) {
+        return (d < 0.5) ? 1.0f : ((d == 0.5) ? 0.5f : 0.0f);
+    }
+
+    // Kaiser window with a width of four and alpha of four
+    static const double RADIUS = 2.0;
+    static const double ALPHA = 4.0;
+    if (d >= RADIUS) {
+        return 0.0f;
+    }
+    const double t = d / RADIUS;
+    const double sinc = (d < 1e-6) ? 1.0 : sin(M_PI * d) / (M_PI * d);
+    double window = 0;
+    double norm = 0;
+    const double a = ALPHA * sqrt(1.0 - t * t);
+    double termA = 1, termB = 1;
+    for (int k = 1; k < 32; ++k) {
+        window += termA;
+        norm += termB;
+        termA *= (a / (2 * k)) * (a / (2 * k));
+        termB *= (ALPHA / (2 * k)) * (ALPHA / (2 * k));
+    }
+    return (GLfloat) (sinc * window / norm);
+}
+
+/**
+ * Changes the filter used to shrink each level.
+ *
+ * @param filter Filter to use
+ * @return Reference to this generator to support chaining
+ */
+MipmapGenerator& MipmapGenerator::filter(const Filter filter) {
+    _filter = filter;
+    return (*this);
+}
+
+/**
+ * Changes whether pixels are converted from sRGB to linear values before filtering.
+ *
+ * @param gammaCorrect `true` to treat color components as sRGB, `false` to filter them as they are
+ * @return Reference to this generator to support chaining
+ */
+MipmapGenerator& MipmapGenerator::gammaCorrect(const bool gammaCorrect) {
+    _gammaCorrect = gammaCorrect;
+    return (*this);
+}
+
+/**
+ * Makes the mipmap chain for a bitmap using the current settings.
+ *
+ * @param bitmap Bitmap to use as the first level
+ * @return Every level of the chain, starting with the bitmap itself
+ * @throws invalid_argument if the bitmap is empty
+ */
+vector<Bitmap> MipmapGenerator::generate(const Bitmap& bitmap) const {
+
+    if ((bitmap.width < 1) || (bitmap.height < 1)) {
+        throw invalid_argument("[MipmapGenerator] Bitmap is empty!");
+    }
+
+    // Pick the conversions
+    const GLfloat* toLinear = NULL;
+    const GLubyte* toSrgb = NULL;
+    if (_gammaCorrect) {
+        toLinear = getToLinearTable();
+        toSrgb = getToSrgbTable();
+    }
+
+    // Convert the first level to floats
+    vector<Bitmap> levels(1, bitmap);
+    levels.reserve(getLevelCount(bitmap.width, bitmap.height));
+    Image current;
+    current.width = bitmap.width;
+    current.height = bitmap.height;
+    current.values.resize(((size_t) current.width) * current.height * 4);
+    DecodeTask decodeTask(bitmap, toLinear, current);
+    Parallel::forEach(current.height, decodeTask, 16);
+
+    // Shrink each level to make the next one
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    while ((current.width > 1) || (current.height > 1)) {
+        const GLsizei width = max(1, current.width / 2);
+        const GLsizei height = max(1, current.height / 2);
+
+        // Shrink horizontally
+        const Weights weightsX = createWeights(_filter, current.width, width);
+        Image narrow;
+        narrow.width = width;
+        narrow.height = current.height;
+        narrow.values.resize(((size_t) width) * current.height * 4);
+        RowTask rowTask(current, weightsX, narrow);
+        Parallel::forEach(current.height, rowTask, 16);
+
+        // Shrink vertically into a new bitmap
+        const GLsizei stride = ((width * bytesPerPixel + (ALIGNMENT - 1)) / ALIGNMENT) * ALIGNMENT;
+        Bitmap level;
+        level.setPixels(new GLubyte[((size_t) stride) * height], NULL);
+        level.format = bitmap.format;
+        level.width = width;
+        level.height = height;
+        level.size = stride * height;
+        level.alignment = ALIGNMENT;
+        const Weights weightsY = createWeights(_filter, current.height, height);
+        Image next;
+        next.width = width;
+        next.height = height;
+        next.values.resize(((size_t) width) * height * 4);
+        ColumnTask columnTask(narrow, weightsY, toSrgb, next, level);
+        Parallel::forEach(height, columnTask, 4);
+
+        levels.push_back(level);
+        current.width = width;
+        current.height = height;
+        current.values.swap(next.values);
+    }
+    return levels;
+}
+
+/**
+ * Loads the mipmap chain for a bitmap from files, or makes and saves it if the files are not usable.
+ *
+ * Levels after the first are kept in bitmap files named with the prefix and
+ * the number of the level, such as `prefix.1.bmp`.  They are mapped into
+ * memory rather than read when possible.
+ *
+ * @param bitmap Bitmap to use as the first level
+ * @param prefix Start of the path for each file
+ * @return Every level of the chain, starting with the bitmap itself
+ * @throws invalid_argument if the bitmap is empty or not in a format that can be written
+ * @throws runtime_error if the levels needed to be made but could not be written
+ */
+vector<Bitmap> MipmapGenerator::generateCached(const Bitmap& bitmap, const string& prefix) const {
+
+    // Try to load every level from the files
+    const size_t count = getLevelCount(bitmap.width, bitmap.height);
+    vector<Bitmap> levels(1, bitmap);
+    try {
+        BitmapReader reader;
+        GLsizei width = bitmap.width;
+        GLsizei height = bitmap.height;
+        for (size_t i = 1; i < count; ++i) {
+            width = max(1, width / 2);
+            height = max(1, height / 2);
+            const Bitmap level = reader.readMapped(getFilename(prefix, i));
+            if ((level.width != width) || (level.height != height) || (level.format != bitmap.format)) {
+                break;
+            }
+            levels.push_back(level);
+        }
+    } catch (exception&) {
+        // Missing or unreadable, so make them instead
+    }
+    if (levels.size() == count) {
+        return levels;
+    }
+
+    // Make them and save them for next time
+    levels = generate(bitmap);
+    BitmapWriter writer;
+    for (size_t i = 1; i < levels.size(); ++i) {
+        writer.write(levels[i], getFilename(prefix, i));
+    }
+    return levels;
+}
+
+/**
+ * Determines the name of the file a level is kept in.
+ *
+ * @param prefix Start of the path for each file
+ * @param level Number of the level
+ * @return Path to the file for the level
+ */
+string MipmapGenerator::getFilename(const string& prefix, const size_t level) {
+    stringstream stream;
+    stream << prefix << '.' << level << ".bmp";
+    return stream.str();
+}
+
+/**
+ * Computes the number of levels in a full mipmap chain.
+ *
+ * @param width Size of the first level in the X direction
+ * @param height Size of the first level in the Y direction
+ * @return Number of levels, including the first
+ */
+GLsizei MipmapGenerator::getLevelCount(GLsizei width, GLsizei height) {
+    GLsizei count = 1;
+    while ((width > 1) || (height > 1)) {
+        width = max(1, width / 2);
+        height = max(1, height / 2);
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * Returns a table converting 8-bit sRGB values to linear values.
+ *
+ * @return Table of 256 linear values between zero and one
+ */
+const GLfloat* MipmapGenerator::getToLinearTable() {
+    pthread_once(&tablesOnce, &createTables);
+    return toLinearTable;
+}
+
+/**
+ * Returns a table converting linear values to 8-bit sRGB values.
+ *
+ * @return Table of `TABLE_SIZE` sRGB values, indexed by linear value times `TABLE_SIZE - 1`
+ */
+const GLubyte* MipmapGenerator::getToSrgbTable() {
+    pthread_once(&tablesOnce, &createTables);
+    return toSrgbTable;
+}
+
+// HELPERS
+
+void MipmapGenerator::DecodeTask::run(const size_t begin, const size_t end) {
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    const size_t stride = ((bitmap.width * bytesPerPixel + (bitmap.alignment - 1)) / bitmap.alignment) * bitmap.alignment;
+    for (size_t y = begin; y < end; ++y) {
+        const GLubyte* src = bitmap.pixels + y * stride;
+        GLfloat* dst = &image.values[y * image.width * 4];
+        for (GLsizei x = 0; x < bitmap.width; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                dst[c] = (toLinear != NULL) ? toLinear[src[c]] : (src[c] / 255.0f);
+            }
+            dst[3] = (bytesPerPixel == 4) ? (src[3] / 255.0f) : 1.0f;
+            src += bytesPerPixel;
+            dst += 4;
+        }
+    }
+}
+
+void MipmapGenerator::RowTask::run(const size_t begin, const size_t end) {
+    const int taps = weights.taps;
+    const GLint last = weights.srcSize - 1;
+    for (size_t y = begin; y < end; ++y) {
+        const GLfloat* const row = &src.values[y * src.width * 4];
+        GLfloat* dst = &this->dst.values[y * this->dst.width * 4];
+        for (GLsizei x = 0; x < this->dst.width; ++x) {
+            const GLint first = weights.first[x];
+            const GLfloat* const values = &weights.values[((size_t) x) * taps];
+#ifdef __SSE__
+            __m128 sum = _mm_setzero_ps();
+            for (int k = 0; k < taps; ++k) {
+                const GLint i = min(max(first + k, 0), last);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(values[k]), _mm_loadu_ps(row + i * 4)));
+            }
+            _mm_storeu_ps(dst, sum);
+#else
+            dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            for (int k = 0; k < taps; ++k) {
+                const GLint i = min(max(first + k, 0), last);
+                for (int c = 0; c < 4; ++c) {
+                    dst[c] += values[k] * row[i * 4 + c];
+                }
+            }
+#endif
+            dst += 4;
+        }
+    }
+}
+
+void MipmapGenerator::ColumnTask::run(const size_t begin, const size_t end) {
+
+    const int taps = weights.taps;
+    const GLint last = weights.srcSize - 1;
+    const size_t n = ((size_t) dst.width) * 4;
+    const GLsizei bytesPerPixel = Bitmap::sizeOf(bitmap.format);
+    const size_t stride = bitmap.size / bitmap.height;
+
+    for (size_t y = begin; y < end; ++y) {
+
+        // Filter the rows
+        GLfloat* const row = &dst.values[y * n];
+        fill(row, row + n, 0.0f);
+        const GLfloat* const values = &weights.values[y * taps];
+        for (int k = 0; k < taps; ++k) {
+            const GLint i = min(max(weights.first[y] + k, 0), last);
+            Simd::accumulate(n, values[k], &src.values[i * n], row);
+        }
+
+        // Store the row, including padding
+        GLubyte* const out = bitmap.pixels + y * stride;
+        memset(out, 0, stride);
+        for (GLsizei x = 0; x < dst.width; ++x) {
+            for (int c = 0; c < bytesPerPixel; ++c) {
+                const GLfloat value = min(max(row[x * 4 + c], 0.0f), 1.0f);
+                if ((c < 3) && (toSrgb != NULL)) {
+                    out[x * bytesPerPixel + c] = toSrgb[(int) (value * (TABLE_SIZE - 1) + 0.5f)];
+                } else {
+                    out[x * bytesPerPixel + c] = (GLubyte) (value * 255 + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,102 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_MIPMAPGENERATOR_HXX
+#define GLYCERIN_MIPMAPGENERATOR_HXX
+#include "glycerin/common.h"
+#include <string>
+#include <vector>
+#include <gloop/TextureObject.hxx>
+#include "glycerin/Bitmap.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for making mipmaps of bitmaps on the CPU.
+ *
+ * Letting `glGenerateMipmap` build mipmaps costs driver time on every load
+ * and leaves the filter up to the implementation.  _MipmapGenerator_ builds
+ * the whole chain ahead of time instead, splitting the work across all
+ * available processors.  Its properties are set with chained calls.
+ *
+ * ~~~
+ * MipmapGenerator generator;
+ * const std::vector<Bitmap> levels = generator.filter(MipmapGenerator::KAISER).generate(bitmap);
+ * const Gloop::TextureObject texture = MipmapGenerator::createTexture(levels);
+ * ~~~
+ *
+ * The first level is always the original bitmap, and each level after it is
+ * half the size of the one before, down to 1x1.  Levels keep the format of
+ * the original.  By default the [box](@ref BOX) filter is used and pixels
+ * are treated as sRGB, so they are converted to linear values before being
+ * averaged.  Turn that off with [gamma-correct] for images that hold data
+ * rather than colors.
+ *
+ * To avoid building the same chain every time an application runs, use
+ * [generate-cached] with a prefix for the files to keep the levels in.  The
+ * prefix should change whenever the original image or the settings do.
+ *
+ * ~~~
+ * const std::vector<Bitmap> levels = generator.generateCached(bitmap, "cache/crate");
+ * ~~~
+ *
+ * [gamma-correct]: @ref gammaCorrect(bool) "gammaCorrect(bool)"
+ * [generate-cached]: @ref generateCached(const Bitmap&, const std::string&) const "generateCached(const Bitmap&, const std::string&)"
+ */
+class MipmapGenerator {
+public:
+// Types
+    /// Filter used to shrink each level
+    enum Filter {
+        BOX,   ///< Average of each 2x2 block, which is fast but slightly blurry
+        KAISER ///< Kaiser-windowed sinc, which keeps levels sharper
+    };
+// Methods
+    MipmapGenerator();
+    virtual ~MipmapGenerator();
+    static Gloop::TextureObject createTexture(const std::vector<Bitmap>& levels);
+    MipmapGenerator& filter(Filter filter);
+    MipmapGenerator& gammaCorrect(bool gammaCorrect);
+    std::vector<Bitmap> generate(const Bitmap& bitmap) const;
+    std::vector<Bitmap> generateCached(const Bitmap& bitmap, const std::string& prefix) const;
+private:
+// Types
+    struct Image;
+    struct Weights;
+    class DecodeTask;
+    class RowTask;
+    class ColumnTask;
+// Constants
+    static const GLint ALIGNMENT = 4;
+    static const int TABLE_SIZE = 4096;
+// Attributes
+    Filter _filter;
+    bool _gammaCorrect;
+    static GLfloat toLinearTable[256];
+    static GLubyte toSrgbTable[TABLE_SIZE];
+// Methods
+    static void createTables();
+    static Weights createWeights(Filter filter, GLsizei srcSize, GLsizei dstSize);
+    static GLfloat evaluate(Filter filter, double x);
+    static std::string getFilename(const std::string& prefix, size_t level);
+    static GLsizei getLevelCount(GLsizei width, GLsizei height);
+    static const GLfloat* getToLinearTable();
+    static const GLubyte* getToSrgbTable();
+};
+
+} /* namespace Glycerin */
+#endif
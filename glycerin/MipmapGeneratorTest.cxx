@@ -0,0 +1,141 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/BitmapGenerator.hxx"
+#include "glycerin/MipmapGenerator.hxx"
+
+
+/**
+ * Unit test for `MipmapGenerator`.
+ */
+class MipmapGeneratorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the pixels of a bitmap.
+     */
+    static std::vector<GLubyte> getPixels(const Glycerin::Bitmap& bitmap) {
+        std::vector<GLubyte> pixels(bitmap.getSize());
+        bitmap.getPixels(&pixels[0], pixels.size());
+        return pixels;
+    }
+
+    /**
+     * Returns a 2x2 checkerboard of black and white pixels.
+     */
+    static Glycerin::Bitmap getCheckerboard() {
+        return Glycerin::BitmapGenerator()
+                .size(2, 2)
+                .cellSize(1)
+                .pattern(Glycerin::BitmapGenerator::CHECKERBOARD)
+                .generate();
+    }
+
+    /**
+     * Ensures `MipmapGenerator::generate` halves each level down to 1x1.
+     */
+    void testGenerateSizes() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(5, 3).generate();
+        const std::vector<Glycerin::Bitmap> levels = Glycerin::MipmapGenerator().generate(bitmap);
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, levels.size());
+        CPPUNIT_ASSERT_EQUAL(5, levels[0].getWidth());
+        CPPUNIT_ASSERT_EQUAL(2, levels[1].getWidth());
+        CPPUNIT_ASSERT_EQUAL(1, levels[1].getHeight());
+        CPPUNIT_ASSERT_EQUAL(1, levels[2].getWidth());
+        CPPUNIT_ASSERT_EQUAL(1, levels[2].getHeight());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_BGR, levels[2].getFormat());
+        CPPUNIT_ASSERT_EQUAL(4, levels[2].getSize());
+    }
+
+    /**
+     * Ensures `MipmapGenerator::generate` averages values as they are without gamma correction.
+     */
+    void testGenerateWithoutGammaCorrection() {
+        const std::vector<Glycerin::Bitmap> levels = Glycerin::MipmapGenerator()
+                .gammaCorrect(false)
+                .generate(getCheckerboard());
+        const std::vector<GLubyte> pixels = getPixels(levels[1]);
+        CPPUNIT_ASSERT_EQUAL(128, (int) pixels[0]);
+    }
+
+    /**
+     * Ensures `MipmapGenerator::generate` averages linear values with gamma correction.
+     */
+    void testGenerateWithGammaCorrection() {
+        const std::vector<Glycerin::Bitmap> levels = Glycerin::MipmapGenerator().generate(getCheckerboard());
+        const std::vector<GLubyte> pixels = getPixels(levels[1]);
+        CPPUNIT_ASSERT(abs(188 - pixels[0]) <= 1);
+    }
+
+    /**
+     * Ensures the Kaiser filter keeps a solid color.
+     */
+    void testGenerateWithKaiser() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator()
+                .size(16, 8)
+                .cellSize(64)
+                .pattern(Glycerin::BitmapGenerator::CHECKERBOARD)
+                .generate();
+        const std::vector<Glycerin::Bitmap> levels = Glycerin::MipmapGenerator()
+                .filter(Glycerin::MipmapGenerator::KAISER)
+                .generate(bitmap);
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, levels.size());
+        const GLubyte expected = getPixels(bitmap)[0];
+        for (size_t i = 1; i < levels.size(); ++i) {
+            CPPUNIT_ASSERT(abs(expected - getPixels(levels[i])[0]) <= 1);
+        }
+    }
+
+    /**
+     * Ensures `MipmapGenerator::generateCached` gives the same levels when it loads them from files.
+     */
+    void testGenerateCached() {
+        const Glycerin::Bitmap bitmap = Glycerin::BitmapGenerator().size(8, 4).generate();
+        Glycerin::MipmapGenerator generator;
+        const std::vector<Glycerin::Bitmap> made = generator.generateCached(bitmap, "MipmapGeneratorTest");
+        const std::vector<Glycerin::Bitmap> loaded = generator.generateCached(bitmap, "MipmapGeneratorTest");
+        remove("MipmapGeneratorTest.1.bmp");
+        remove("MipmapGeneratorTest.2.bmp");
+        remove("MipmapGeneratorTest.3.bmp");
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, loaded.size());
+        for (size_t i = 0; i < made.size(); ++i) {
+            CPPUNIT_ASSERT(getPixels(made[i]) == getPixels(loaded[i]));
+        }
+    }
+
+    CPPUNIT_TEST_SUITE(MipmapGeneratorTest);
+    CPPUNIT_TEST(testGenerateSizes);
+    CPPUNIT_TEST(testGenerateWithoutGammaCorrection);
+    CPPUNIT_TEST(testGenerateWithGammaCorrection);
+    CPPUNIT_TEST(testGenerateWithKaiser);
+    CPPUNIT_TEST(testGenerateCached);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(MipmapGeneratorTest::suite());
+    runner.run();
+    return 0;
+}
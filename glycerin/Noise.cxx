@@ -0,0 +1,47 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "glycerin/Noise.hxx"
+namespace Glycerin {
+
+/**
+ * Scrambles the bits of a value.
+ *
+ * @param value Value to scramble
+ * @return Scrambled value
+ */
+GLuint Noise::hash(GLuint value) {
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+/**
+ * Maps a value to a number between zero and one.
+ *
+ * @param value Value to map
+ * @return Number between zero and one
+ */
+GLfloat Noise::toUnit(const GLuint value) {
+    return (value >> 8) / 16777215.0f;
+}
+
+} /* namespace Glycerin */
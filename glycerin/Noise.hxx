@@ -0,0 +1,47 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_NOISE_HXX
+#define GLYCERIN_NOISE_HXX
+#include "glycerin/common.h"
+namespace Glycerin {
+
+
+/**
+ * Utility for making reproducible random values without any state.
+ *
+ * The same input always scrambles to the same output, so generators can
+ * compute any sample on any thread in any order and still produce the same
+ * image from the same seed.
+ *
+ * ~~~
+ * const GLuint base = Noise::hash(seed ^ Noise::hash(y));
+ * const GLfloat value = Noise::toUnit(Noise::hash(base + x));
+ * ~~~
+ */
+class Noise {
+public:
+// Methods
+    static GLuint hash(GLuint value);
+    static GLfloat toUnit(GLuint value);
+private:
+// Methods
+    Noise();
+};
+
+} /* namespace Glycerin */
+#endif
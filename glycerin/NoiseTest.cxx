@@ -0,0 +1,61 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/Noise.hxx"
+
+
+/**
+ * Unit test for `Noise`.
+ */
+class NoiseTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `Noise::hash` is reproducible and scrambles neighbouring values.
+     */
+    void testHash() {
+        CPPUNIT_ASSERT_EQUAL(Glycerin::Noise::hash(12345), Glycerin::Noise::hash(12345));
+        CPPUNIT_ASSERT(Glycerin::Noise::hash(1) != Glycerin::Noise::hash(2));
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0, Glycerin::Noise::hash(0));
+    }
+
+    /**
+     * Ensures `Noise::toUnit` covers zero to one.
+     */
+    void testToUnit() {
+        CPPUNIT_ASSERT_EQUAL(0.0f, Glycerin::Noise::toUnit(0));
+        CPPUNIT_ASSERT_EQUAL(1.0f, Glycerin::Noise::toUnit(0xffffffffU));
+        const GLfloat half = Glycerin::Noise::toUnit(0x80000000U);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, half, 1e-6);
+    }
+
+    CPPUNIT_TEST_SUITE(NoiseTest);
+    CPPUNIT_TEST(testHash);
+    CPPUNIT_TEST(testToUnit);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(NoiseTest::suite());
+    runner.run();
+    return 0;
+}
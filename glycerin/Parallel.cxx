@@ -0,0 +1,110 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+#include "glycerin/Parallel.hxx"
+namespace Glycerin {
+
+/**
+ * Range of indices handed to a single thread.
+ */
+struct Parallel::Chunk {
+    Task* task;
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * Processes a range of indices using as many threads as there are processors.
+ *
+ * The calling thread processes the first chunk itself, so a task is never
+ * split when there is only one processor or when `count` is not larger than
+ * `grain`.  If a thread cannot be started, its chunk is processed on the
+ * calling thread instead.
+ *
+ * @param count Total number of indices to process
+ * @param task Work to perform on each range of indices
+ * @param grain Smallest number of indices worth giving to a thread
+ */
+void Parallel::forEach(const size_t count, Task& task, const size_t grain) {
+
+    // Determine how many chunks to make
+    const size_t maxChunks = std::max((size_t) 1, count / std::max((size_t) 1, grain));
+    const size_t n = std::min(getConcurrency(), maxChunks);
+    if (n <= 1) {
+        task.run(0, count);
+        return;
+    }
+
+    // Divide the range
+    std::vector<Chunk> chunks(n);
+    for (size_t i = 0; i < n; ++i) {
+        chunks[i].task = &task;
+        chunks[i].begin = (count * i) / n;
+        chunks[i].end = (count * (i + 1)) / n;
+    }
+
+    // Start a thread for every chunk but the first
+    std::vector<pthread_t> threads;
+    threads.reserve(n - 1);
+    for (size_t i = 1; i < n; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &runChunk, &chunks[i]) != 0) {
+            break;
+        }
+        threads.push_back(thread);
+    }
+
+    // Do the first chunk on this thread, plus any that could not be started
+    task.run(chunks[0].begin, chunks[0].end);
+    for (size_t i = threads.size() + 1; i < n; ++i) {
+        task.run(chunks[i].begin, chunks[i].end);
+    }
+
+    // Wait for the others
+    for (size_t i = 0; i < threads.size(); ++i) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+/**
+ * Returns the number of threads work will be split across.
+ *
+ * @return Number of processors currently online, at least one
+ */
+size_t Parallel::getConcurrency() {
+    static const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return (processors > 0) ? ((size_t) processors) : 1;
+}
+
+/**
+ * Runs a chunk on a new thread.
+ *
+ * @param chunk Pointer to the chunk to run
+ * @return `NULL` always
+ */
+void* Parallel::runChunk(void* const chunk) {
+    const Chunk* const c = (const Chunk*) chunk;
+    c->task->run(c->begin, c->end);
+    return NULL;
+}
+
+} /* namespace Glycerin */
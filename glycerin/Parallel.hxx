@@ -0,0 +1,82 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_PARALLEL_HXX
+#define GLYCERIN_PARALLEL_HXX
+#include <cstddef>
+#include "glycerin/common.h"
+namespace Glycerin {
+
+
+/**
+ * Utility for splitting work across threads.
+ *
+ * To use _Parallel_, derive from [task] and implement `run` to process a
+ * range of indices, then pass the task to [for-each] with the total number of
+ * indices.  The range is divided into contiguous chunks, one per thread, and
+ * the call returns once every chunk has been processed.
+ *
+ * ~~~
+ * class Invert : public Parallel::Task {
+ * public:
+ *     GLubyte* pixels;
+ *     void run(size_t begin, size_t end) {
+ *         for (size_t i = begin; i < end; ++i) {
+ *             pixels[i] = 255 - pixels[i];
+ *         }
+ *     }
+ * };
+ *
+ * Invert task;
+ * task.pixels = pixels;
+ * Parallel::forEach(size, task);
+ * ~~~
+ *
+ * Since chunks may be processed at the same time, `run` must only write to
+ * memory belonging to its own range.  It also must not throw, because there
+ * is nothing on the other threads to catch the exception.
+ *
+ * [for-each]: @ref forEach(size_t, Task&, size_t) "forEach(size_t, Task&, size_t)"
+ * [task]: @ref Parallel::Task "Parallel::Task"
+ */
+class Parallel {
+public:
+// Types
+    class Task;
+// Methods
+    static void forEach(size_t count, Task& task, size_t grain = 1);
+    static size_t getConcurrency();
+private:
+// Types
+    struct Chunk;
+// Methods
+    Parallel();
+    static void* runChunk(void* chunk);
+};
+
+
+/**
+ * Work that can be split into ranges of indices.
+ */
+class Parallel::Task {
+public:
+    virtual ~Task() { }
+    virtual void run(size_t begin, size_t end) = 0;
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,372 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/time.h>
+#include "glycerin/PerformanceHud.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a disabled `PerformanceHud`.
+ *
+ * @param window Number of recent frames to work out statistics from, by default 120
+ * @throws invalid_argument if window is zero
+ */
+PerformanceHud::PerformanceHud(const size_t window) :
+        _window(window),
+        _timed(StateCache::isVersionSupported(3, 3)),
+        _enabled(false),
+        _frame(0),
+        _frameStart(-1),
+        _frameDraws(0),
+        _frameUpload(0),
+        _active(NONE),
+        _cpuTime(window),
+        _draws(window),
+        _uploads(window) {
+    // pass
+}
+
+/**
+ * Destroys this `PerformanceHud`, deleting its queries.
+ */
+PerformanceHud::~PerformanceHud() {
+    for (vector<Scope>::iterator it = _scopes.begin(); it != _scopes.end(); ++it) {
+        if (it->queries[0] != 0) {
+            glDeleteQueries(2, it->queries);
+        }
+    }
+}
+
+/**
+ * Starts timing a frame, and collects GPU times measured two frames ago.
+ */
+void PerformanceHud::beginFrame() {
+
+    if (!_enabled) {
+        return;
+    }
+
+    // Collect results from the queries this frame will reuse
+    const int slot = _frame % 2;
+    for (vector<Scope>::iterator it = _scopes.begin(); it != _scopes.end(); ++it) {
+        collect(*it, slot);
+    }
+
+    _frameStart = now();
+    _frameDraws = 0;
+    _frameUpload = 0;
+}
+
+/**
+ * Starts timing part of a frame on the GPU.
+ *
+ * @param name Name to show the time under
+ * @throws logic_error if another scope has not ended yet
+ */
+void PerformanceHud::beginScope(const string& name) {
+
+    if (!_enabled) {
+        return;
+    } else if (_active != NONE) {
+        throw logic_error("[PerformanceHud] Scopes cannot be nested!");
+    }
+
+    // Find the scope, adding it the first time
+    map<string,size_t>::const_iterator it = _indices.find(name);
+    if (it == _indices.end()) {
+        _scopes.push_back(Scope(name, _window));
+        if (_timed) {
+            glGenQueries(2, _scopes.back().queries);
+        }
+        it = _indices.insert(make_pair(name, _scopes.size() - 1)).first;
+    }
+    _active = it->second;
+
+    // Start the query for this frame
+    if (_timed) {
+        Scope& scope = _scopes[_active];
+        const int slot = _frame % 2;
+        glBeginQuery(GL_TIME_ELAPSED, scope.queries[slot]);
+        scope.pending[slot] = true;
+    }
+}
+
+/**
+ * Reads back the time measured by one of a scope's queries if it is ready.
+ *
+ * @param scope Scope to read back
+ * @param slot Which of the scope's two queries to read
+ */
+void PerformanceHud::collect(Scope& scope, const int slot) {
+
+    if (!scope.pending[slot]) {
+        return;
+    }
+    scope.pending[slot] = false;
+
+    // Skip rather than wait if the GPU has not got there yet
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(scope.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(scope.queries[slot], GL_QUERY_RESULT, &nanoseconds);
+    scope.statistics.add(nanoseconds * 1e-6);
+}
+
+/**
+ * Adds to the number of draw calls made in this frame.
+ *
+ * @param draws Number of draw calls to add
+ */
+void PerformanceHud::countDraws(const size_t draws) {
+    if (_enabled) {
+        _frameDraws += draws;
+    }
+}
+
+/**
+ * Adds to the number of bytes uploaded to textures in this frame.
+ *
+ * @param bytes Number of bytes to add
+ */
+void PerformanceHud::countUpload(const size_t bytes) {
+    if (_enabled) {
+        _frameUpload += bytes;
+    }
+}
+
+/**
+ * Returns the time in milliseconds between `beginFrame` and `endFrame` on the CPU.
+ */
+const RollingStatistics& PerformanceHud::cpuTime() const {
+    return _cpuTime;
+}
+
+/**
+ * Draws the measurements with a text renderer.
+ *
+ * The text is only collected here, and is actually drawn when the renderer
+ * ends rendering.
+ *
+ * @param renderer Text renderer that is rendering
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of baseline of first line
+ */
+void PerformanceHud::draw(TextRenderer& renderer, const GLfloat x, const GLfloat y) {
+    if (_enabled) {
+        format();
+        renderer.draw(_text, x, y);
+    }
+}
+
+/**
+ * Draws the measurements over a dark panel into a sprite batch.
+ *
+ * The panel goes on the batch's current layer and the text on the one above.
+ *
+ * @param batch Sprite batch that is rendering
+ * @param renderer Text renderer to draw the text with
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of baseline of first line
+ */
+void PerformanceHud::draw(SpriteBatch& batch, TextRenderer& renderer, const GLfloat x, const GLfloat y) {
+
+    if (!_enabled) {
+        return;
+    }
+    format();
+
+    // Fill behind every line
+    const TextLayout layout = renderer.createLayout();
+    const TextLayout::Size size = layout.measure(_text);
+    const GLfloat top = y - layout.descent() + layout.lineHeight();
+    batch.fill(
+            x - PADDING,
+            top - size.height - PADDING,
+            size.width + PADDING * 2,
+            size.height + PADDING * 2,
+            Color(0, 0, 0, 0.6f));
+
+    // Put the text on top
+    const GLint layer = batch.layer();
+    batch.layer(layer + 1);
+    renderer.draw(batch, _text, x, y, layout);
+    batch.layer(layer);
+}
+
+/**
+ * Returns the number of draw calls counted in each frame.
+ */
+const RollingStatistics& PerformanceHud::draws() const {
+    return _draws;
+}
+
+/**
+ * Checks if measurements are being taken.
+ */
+bool PerformanceHud::enabled() const {
+    return _enabled;
+}
+
+/**
+ * Starts or stops taking measurements.
+ *
+ * Disabling in the middle of a scope ends it.  After enabling, measuring
+ * starts with the next call to `beginFrame`.
+ *
+ * @param enabled Whether to take measurements
+ * @return Reference to this overlay to support chaining
+ */
+PerformanceHud& PerformanceHud::enabled(const bool enabled) {
+    if (_enabled && !enabled && (_active != NONE)) {
+        endScope();
+    }
+    if (enabled && !_enabled) {
+        _frameStart = -1;
+    }
+    _enabled = enabled;
+    return (*this);
+}
+
+/**
+ * Finishes timing a frame, and adds its measurements to the statistics.
+ *
+ * @throws logic_error if a scope has not ended yet
+ */
+void PerformanceHud::endFrame() {
+
+    if (!_enabled) {
+        return;
+    } else if (_active != NONE) {
+        throw logic_error("[PerformanceHud] Scope did not end before frame!");
+    } else if (_frameStart < 0) {
+        return;
+    }
+
+    _cpuTime.add((now() - _frameStart) * 1e3);
+    _draws.add(_frameDraws);
+    _uploads.add(_frameUpload);
+    _frameStart = -1;
+    ++_frame;
+}
+
+/**
+ * Finishes timing part of a frame on the GPU.
+ *
+ * @throws logic_error if no scope was started
+ */
+void PerformanceHud::endScope() {
+
+    if (!_enabled) {
+        return;
+    } else if (_active == NONE) {
+        throw logic_error("[PerformanceHud] No scope to end!");
+    }
+
+    if (_timed) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    _active = NONE;
+}
+
+/**
+ * Makes the text showing every measurement.
+ */
+void PerformanceHud::format() {
+    _text = format("cpu ms", _cpuTime, 1);
+    for (vector<Scope>::const_iterator it = _scopes.begin(); it != _scopes.end(); ++it) {
+        _text += '\n';
+        _text += format(it->name + " ms", it->statistics, 1);
+    }
+    _text += '\n';
+    _text += format("draws", _draws, 1);
+    _text += '\n';
+    _text += format("upload KB", _uploads, 1.0 / 1024);
+}
+
+/**
+ * Makes one line of text showing a measurement.
+ *
+ * @param label Name of the measurement
+ * @param statistics Statistics of the measurement
+ * @param scale Number to multiply values by
+ * @return Label, last value, minimum, average and maximum
+ */
+string PerformanceHud::format(const string& label, const RollingStatistics& statistics, const double scale) {
+    ostringstream stream;
+    stream << fixed << setprecision(2) << left << setw(12) << label << right
+           << setw(8) << statistics.last() * scale
+           << "  min " << setw(8) << statistics.minimum() * scale
+           << "  avg " << setw(8) << statistics.average() * scale
+           << "  max " << setw(8) << statistics.maximum() * scale;
+    return stream.str();
+}
+
+/**
+ * Returns the GPU time in milliseconds of a scope.
+ *
+ * @param name Name of the scope
+ * @return Statistics of the scope, which are empty if timer queries are not available
+ * @throws invalid_argument if no scope has that name
+ */
+const RollingStatistics& PerformanceHud::gpuTime(const string& name) const {
+    const map<string,size_t>::const_iterator it = _indices.find(name);
+    if (it == _indices.end()) {
+        throw invalid_argument("[PerformanceHud] No scope with that name!");
+    }
+    return _scopes[it->second].statistics;
+}
+
+/**
+ * Returns the current time in seconds.
+ */
+double PerformanceHud::now() {
+    timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec * 1e-6;
+}
+
+/**
+ * Returns the number of bytes uploaded to textures in each frame.
+ */
+const RollingStatistics& PerformanceHud::uploads() const {
+    return _uploads;
+}
+
+/**
+ * Constructs a scope that has not been timed yet.
+ *
+ * @param name Name to show the time under
+ * @param window Number of recent frames to work out statistics from
+ */
+PerformanceHud::Scope::Scope(const string& name, const size_t window) : name(name), statistics(window) {
+    queries[0] = 0;
+    queries[1] = 0;
+    pending[0] = false;
+    pending[1] = false;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,119 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_PERFORMANCE_HUD_HXX
+#define GLYCERIN_PERFORMANCE_HUD_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "glycerin/RollingStatistics.hxx"
+#include "glycerin/SpriteBatch.hxx"
+#include "glycerin/TextRenderer.hxx"
+namespace Glycerin {
+
+
+/**
+ * Overlay showing how long frames take and how much work they do.
+ *
+ * Call `beginFrame` and `endFrame` around each frame, and `beginScope` and
+ * `endScope` around parts of it to time on the GPU.  Draw calls and bytes
+ * uploaded to textures can be counted with `countDraws` and `countUpload`,
+ * e.g. from [sprite batch draws](@ref SpriteBatch::draws).  Then `draw` adds
+ * the last value and the rolling minimum, average and maximum of each
+ * measurement to a text renderer.
+ *
+ * ~~~
+ * hud.beginFrame();
+ * hud.beginScope("scene");
+ * drawScene();
+ * hud.endScope();
+ * textRenderer.beginRendering(width, height);
+ * hud.draw(textRenderer, 10, height - 20);
+ * textRenderer.endRendering();
+ * hud.endFrame();
+ * ~~~
+ *
+ * GPU time is measured with `GL_TIME_ELAPSED` queries, which need OpenGL
+ * 3.3.  Each scope has two queries used on alternate frames, and a query's
+ * result is only read back two frames later, when it is normally ready.
+ * Results that are still not ready are skipped rather than waited for, so
+ * timing never stalls the pipeline.  Scopes cannot be nested, since only
+ * one such query can be active at a time.
+ *
+ * While disabled, every method returns straight away without calling
+ * OpenGL, so the overlay can stay in production builds and be switched on
+ * when needed.  It starts out disabled.
+ */
+class PerformanceHud {
+public:
+// Methods
+    explicit PerformanceHud(size_t window = 120);
+    virtual ~PerformanceHud();
+    void beginFrame();
+    void beginScope(const std::string& name);
+    void countDraws(size_t draws);
+    void countUpload(size_t bytes);
+    const RollingStatistics& cpuTime() const;
+    void draw(TextRenderer& renderer, GLfloat x, GLfloat y);
+    void draw(SpriteBatch& batch, TextRenderer& renderer, GLfloat x, GLfloat y);
+    const RollingStatistics& draws() const;
+    bool enabled() const;
+    PerformanceHud& enabled(bool enabled);
+    void endFrame();
+    void endScope();
+    const RollingStatistics& gpuTime(const std::string& name) const;
+    const RollingStatistics& uploads() const;
+private:
+// Types
+    struct Scope {
+        std::string name;
+        GLuint queries[2];
+        bool pending[2];
+        RollingStatistics statistics;
+        Scope(const std::string& name, size_t window);
+    };
+// Constants
+    static const size_t NONE = (size_t) -1;
+    static const GLfloat PADDING = 6;
+// Attributes
+    const size_t _window;
+    const bool _timed;
+    bool _enabled;
+    size_t _frame;
+    double _frameStart;
+    size_t _frameDraws;
+    size_t _frameUpload;
+    size_t _active;
+    RollingStatistics _cpuTime;
+    RollingStatistics _draws;
+    RollingStatistics _uploads;
+    std::vector<Scope> _scopes;
+    std::map<std::string,size_t> _indices;
+    std::string _text;
+// Methods
+    PerformanceHud(const PerformanceHud&);
+    PerformanceHud& operator=(const PerformanceHud&);
+    void collect(Scope& scope, int slot);
+    void format();
+    static std::string format(const std::string& label, const RollingStatistics& statistics, double scale);
+    static double now();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/Color.hxx"
+#include "glycerin/PerformanceHud.hxx"
+#include "glycerin/SpriteBatch.hxx"
+#include "glycerin/TextRenderer.hxx"
+
+
+/**
+ * Test for `PerformanceHud`.
+ */
+class PerformanceHudTest {
+public:
+
+    /**
+     * Tests that `PerformanceHud` measures frames only while enabled.
+     */
+    void testMeasure() {
+
+        Glycerin::PerformanceHud hud(30);
+        Glycerin::SpriteBatch batch;
+
+        // Nothing is measured while disabled
+        hud.beginFrame();
+        hud.beginScope("scene");
+        hud.endScope();
+        hud.endFrame();
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, hud.cpuTime().count());
+
+        // Measure some frames
+        hud.enabled(true);
+        for (int i = 0; i < 10; ++i) {
+            hud.beginFrame();
+            hud.beginScope("scene");
+            batch.beginRendering(512, 512);
+            batch.fill(0, 0, 512, 512, Glycerin::Color(0.1f, 0.1f, 0.3f));
+            batch.endRendering();
+            hud.endScope();
+            hud.countDraws(batch.draws());
+            hud.countUpload(1024);
+            hud.endFrame();
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t) 10, hud.cpuTime().count());
+        CPPUNIT_ASSERT_EQUAL(1.0, hud.draws().average());
+        CPPUNIT_ASSERT_EQUAL(1024.0, hud.uploads().maximum());
+        CPPUNIT_ASSERT(hud.gpuTime("scene").count() <= 8);
+
+        // Scopes cannot be nested
+        bool thrown = false;
+        hud.beginScope("outer");
+        try {
+            hud.beginScope("inner");
+        } catch (std::logic_error& e) {
+            thrown = true;
+        }
+        hud.endScope();
+        CPPUNIT_ASSERT(thrown);
+    }
+
+    /**
+     * Tests `PerformanceHud::draw`.
+     */
+    void testDraw() {
+
+        // Clear
+        glClearColor(0.0f, 0.0f, 0.3f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // Measure a few frames
+        Glycerin::PerformanceHud hud;
+        hud.enabled(true);
+        for (int i = 0; i < 5; ++i) {
+            hud.beginFrame();
+            hud.beginScope("clear");
+            glClear(GL_COLOR_BUFFER_BIT);
+            hud.endScope();
+            hud.countDraws(1);
+            hud.endFrame();
+        }
+
+        // Draw into a text renderer and over a panel in a batch
+        Glycerin::TextRenderer textRenderer;
+        textRenderer.beginRendering(512, 512);
+        hud.draw(textRenderer, 10, 480);
+        textRenderer.endRendering();
+        Glycerin::SpriteBatch batch;
+        batch.beginRendering(512, 512);
+        hud.draw(batch, textRenderer, 10, 200);
+        batch.endRendering();
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, batch.draws());
+
+        // Flush and wait
+        glfwSwapBuffers();
+        glfwSleep(2.0);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run tests
+    try {
+        PerformanceHudTest test;
+        test.testMeasure();
+        test.testDraw();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
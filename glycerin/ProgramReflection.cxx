@@ -0,0 +1,286 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "glycerin/ProgramReflection.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Reads the active uniforms, attributes and uniform blocks of a program.
+ *
+ * @param program Name of a linked program
+ * @throws invalid_argument if program is not a linked program
+ */
+ProgramReflection::ProgramReflection(const GLuint program) : _program(program) {
+
+    if (!glIsProgram(program)) {
+        throw invalid_argument("[ProgramReflection] Not a program!");
+    }
+    GLint linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        throw invalid_argument("[ProgramReflection] Program is not linked!");
+    }
+
+    readUniforms();
+    readAttributes();
+    readBlocks();
+}
+
+/**
+ * Destroys the reflection.
+ */
+ProgramReflection::~ProgramReflection() {
+    // empty
+}
+
+/**
+ * Returns an attribute by its handle.
+ *
+ * @param handle Handle from `findAttribute`
+ * @return Attribute with the handle
+ * @throws out_of_range if handle is invalid
+ */
+const ProgramReflection::Variable& ProgramReflection::attribute(const size_t handle) const {
+    if (handle >= _attributes.size()) {
+        throw out_of_range("[ProgramReflection] Invalid attribute handle!");
+    }
+    return _attributes[handle];
+}
+
+/**
+ * Returns the location of an attribute.
+ *
+ * @param name Name of the attribute
+ * @return Location of the attribute, or -1 if it is not active
+ */
+GLint ProgramReflection::attributeLocation(const std::string& name) const {
+    const size_t handle = find(_attributeHandles, name);
+    return (handle == NOT_FOUND) ? -1 : _attributes[handle].location;
+}
+
+/**
+ * Returns the number of active attributes.
+ */
+size_t ProgramReflection::attributes() const {
+    return _attributes.size();
+}
+
+/**
+ * Returns a uniform block by its handle.
+ *
+ * @param handle Handle from `findBlock`
+ * @return Uniform block with the handle
+ * @throws out_of_range if handle is invalid
+ */
+const ProgramReflection::Block& ProgramReflection::block(const size_t handle) const {
+    if (handle >= _blocks.size()) {
+        throw out_of_range("[ProgramReflection] Invalid block handle!");
+    }
+    return _blocks[handle];
+}
+
+/**
+ * Returns the index of a uniform block.
+ *
+ * @param name Name of the block
+ * @return Index of the block, or `GL_INVALID_INDEX` if it is not active
+ */
+GLuint ProgramReflection::blockIndex(const std::string& name) const {
+    const size_t handle = find(_blockHandles, name);
+    return (handle == NOT_FOUND) ? GL_INVALID_INDEX : _blocks[handle].index;
+}
+
+/**
+ * Returns the number of active uniform blocks.
+ */
+size_t ProgramReflection::blocks() const {
+    return _blocks.size();
+}
+
+/**
+ * Looks up a handle by name.
+ *
+ * @param handles Map from names to handles
+ * @param name Name to look up
+ * @return Handle with the name, or `NOT_FOUND`
+ */
+size_t ProgramReflection::find(const std::map<std::string,size_t>& handles, const std::string& name) {
+    const map<string,size_t>::const_iterator it = handles.find(name);
+    return (it == handles.end()) ? NOT_FOUND : it->second;
+}
+
+/**
+ * Finds the handle of an attribute.
+ *
+ * @param name Name of the attribute
+ * @return Handle of the attribute, or `NOT_FOUND` if it is not active
+ */
+size_t ProgramReflection::findAttribute(const std::string& name) const {
+    return find(_attributeHandles, name);
+}
+
+/**
+ * Finds the handle of a uniform block.
+ *
+ * @param name Name of the block
+ * @return Handle of the block, or `NOT_FOUND` if it is not active
+ */
+size_t ProgramReflection::findBlock(const std::string& name) const {
+    return find(_blockHandles, name);
+}
+
+/**
+ * Finds the handle of a uniform.
+ *
+ * @param name Name of the uniform, without `[0]` for arrays
+ * @return Handle of the uniform, or `NOT_FOUND` if it is not active
+ */
+size_t ProgramReflection::findUniform(const std::string& name) const {
+    return find(_uniformHandles, name);
+}
+
+/**
+ * Returns the name of the program that was reflected.
+ */
+GLuint ProgramReflection::program() const {
+    return _program;
+}
+
+/**
+ * Asks OpenGL for every active attribute.
+ */
+void ProgramReflection::readAttributes() {
+
+    GLint count, maxLength;
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    vector<GLchar> name(maxLength + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        Variable attribute;
+        GLsizei length = 0;
+        glGetActiveAttrib(_program, i, name.size(), &length, &attribute.size, &attribute.type, &name[0]);
+        attribute.name = trimArray(name, length);
+        if (attribute.name.compare(0, 3, "gl_") == 0) {
+            continue;
+        }
+        attribute.location = glGetAttribLocation(_program, attribute.name.c_str());
+        _attributeHandles[attribute.name] = _attributes.size();
+        _attributes.push_back(attribute);
+    }
+}
+
+/**
+ * Asks OpenGL for every active uniform block.
+ */
+void ProgramReflection::readBlocks() {
+
+    GLint count, maxLength;
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    vector<GLchar> name(maxLength + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        Block block;
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(_program, i, name.size(), &length, &name[0]);
+        block.name = string(&name[0], length);
+        block.index = i;
+        glGetActiveUniformBlockiv(_program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.size);
+        glGetActiveUniformBlockiv(_program, i, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+        _blockHandles[block.name] = _blocks.size();
+        _blocks.push_back(block);
+    }
+}
+
+/**
+ * Asks OpenGL for every active uniform.
+ *
+ * Uniforms in blocks have no location, so theirs is -1.
+ */
+void ProgramReflection::readUniforms() {
+
+    GLint count, maxLength;
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    vector<GLchar> name(maxLength + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        Variable uniform;
+        GLsizei length = 0;
+        glGetActiveUniform(_program, i, name.size(), &length, &uniform.size, &uniform.type, &name[0]);
+        uniform.name = trimArray(name, length);
+        if (uniform.name.compare(0, 3, "gl_") == 0) {
+            continue;
+        }
+        uniform.location = glGetUniformLocation(_program, uniform.name.c_str());
+        _uniformHandles[uniform.name] = _uniforms.size();
+        _uniforms.push_back(uniform);
+    }
+}
+
+/**
+ * Makes a string from a name returned by OpenGL, dropping `[0]` from the end.
+ *
+ * @param name Characters of the name
+ * @param length Number of characters in the name
+ * @return Name without `[0]`
+ */
+std::string ProgramReflection::trimArray(const std::vector<GLchar>& name, const GLsizei length) {
+    string str(&name[0], length);
+    if ((str.size() > 3) && (str.compare(str.size() - 3, 3, "[0]") == 0)) {
+        str.erase(str.size() - 3);
+    }
+    return str;
+}
+
+/**
+ * Returns a uniform by its handle.
+ *
+ * @param handle Handle from `findUniform`
+ * @return Uniform with the handle
+ * @throws out_of_range if handle is invalid
+ */
+const ProgramReflection::Variable& ProgramReflection::uniform(const size_t handle) const {
+    if (handle >= _uniforms.size()) {
+        throw out_of_range("[ProgramReflection] Invalid uniform handle!");
+    }
+    return _uniforms[handle];
+}
+
+/**
+ * Returns the location of a uniform.
+ *
+ * @param name Name of the uniform, without `[0]` for arrays
+ * @return Location of the uniform, or -1 if it is not active or is in a block
+ */
+GLint ProgramReflection::uniformLocation(const std::string& name) const {
+    const size_t handle = find(_uniformHandles, name);
+    return (handle == NOT_FOUND) ? -1 : _uniforms[handle].location;
+}
+
+/**
+ * Returns the number of active uniforms, including those in blocks.
+ */
+size_t ProgramReflection::uniforms() const {
+    return _uniforms.size();
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,105 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_PROGRAM_REFLECTION_HXX
+#define GLYCERIN_PROGRAM_REFLECTION_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Description of the active uniforms, attributes and uniform blocks of a linked program.
+ *
+ * Asking OpenGL for a location by name means a string search inside the
+ * driver every time.  _ProgramReflection_ asks for everything once, right
+ * after the program is linked, and keeps the names, types, sizes and
+ * locations.  Look up a name once with one of the `find` methods to get a
+ * handle, and use the handle from then on, which is just an index.
+ *
+ * ~~~
+ * const ProgramReflection reflection(program.id());
+ * const size_t matrix = reflection.findUniform("MVPMatrix");
+ * ...
+ * glUniformMatrix4fv(reflection.uniform(matrix).location, 1, false, arr);
+ * ~~~
+ *
+ * Arrays are listed under their names without `[0]`, and built-in
+ * variables such as `gl_VertexID` are left out.  The reflection does not
+ * notice if the program is linked again.
+ */
+class ProgramReflection {
+public:
+// Types
+    /**
+     * Active uniform or attribute.
+     */
+    struct Variable {
+        std::string name;
+        GLenum type;
+        GLint size;
+        GLint location;
+    };
+    /**
+     * Active uniform block.
+     */
+    struct Block {
+        std::string name;
+        GLuint index;
+        GLint size;
+        GLint binding;
+    };
+// Constants
+    static const size_t NOT_FOUND = (size_t) -1;
+// Methods
+    explicit ProgramReflection(GLuint program);
+    virtual ~ProgramReflection();
+    const Variable& attribute(size_t handle) const;
+    GLint attributeLocation(const std::string& name) const;
+    size_t attributes() const;
+    const Block& block(size_t handle) const;
+    GLuint blockIndex(const std::string& name) const;
+    size_t blocks() const;
+    size_t findAttribute(const std::string& name) const;
+    size_t findBlock(const std::string& name) const;
+    size_t findUniform(const std::string& name) const;
+    GLuint program() const;
+    const Variable& uniform(size_t handle) const;
+    GLint uniformLocation(const std::string& name) const;
+    size_t uniforms() const;
+private:
+// Attributes
+    std::map<std::string,size_t> _attributeHandles;
+    std::vector<Variable> _attributes;
+    std::map<std::string,size_t> _blockHandles;
+    std::vector<Block> _blocks;
+    GLuint _program;
+    std::map<std::string,size_t> _uniformHandles;
+    std::vector<Variable> _uniforms;
+// Methods
+    static size_t find(const std::map<std::string,size_t>& handles, const std::string& name);
+    void readAttributes();
+    void readBlocks();
+    void readUniforms();
+    static std::string trimArray(const std::vector<GLchar>& name, GLsizei length);
+};
+
+} /* namespace Glycerin */
+#endif
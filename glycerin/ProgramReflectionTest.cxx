@@ -0,0 +1,155 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include <gloop/Program.hxx>
+#include "glycerin/ProgramReflection.hxx"
+#include "glycerin/ShaderFactory.hxx"
+
+
+/**
+ * Test for `ProgramReflection`.
+ */
+class ProgramReflectionTest {
+public:
+
+    /**
+     * Makes a program with uniforms, attributes and a uniform block.
+     */
+    static Gloop::Program createProgram() {
+        Glycerin::ShaderFactory factory;
+        const Gloop::Shader vertexShader = factory.createShaderFromString(GL_VERTEX_SHADER,
+                "#version 140\n"
+                "uniform mat4 MVPMatrix;\n"
+                "uniform vec2 Offsets[4];\n"
+                "uniform Lights { vec4 LightColor; vec4 LightDirection; };\n"
+                "in vec4 MCVertex;\n"
+                "in vec3 MCNormal;\n"
+                "out vec4 Color;\n"
+                "void main() {\n"
+                "    gl_Position = MVPMatrix * (MCVertex + vec4(Offsets[gl_VertexID % 4], 0, 0));\n"
+                "    Color = LightColor * dot(MCNormal, LightDirection.xyz);\n"
+                "}\n");
+        const Gloop::Shader fragmentShader = factory.createShaderFromString(GL_FRAGMENT_SHADER,
+                "#version 140\n"
+                "in vec4 Color;\n"
+                "out vec4 FragColor;\n"
+                "void main() {\n"
+                "    FragColor = Color;\n"
+                "}\n");
+        const Gloop::Program program = Gloop::Program::create();
+        program.attachShader(vertexShader);
+        program.attachShader(fragmentShader);
+        program.link();
+        CPPUNIT_ASSERT_MESSAGE(program.log(), program.linked());
+        return program;
+    }
+
+    /**
+     * Tests that `ProgramReflection` finds everything the driver does.
+     */
+    void testReflect() {
+        const Gloop::Program program = createProgram();
+        const Glycerin::ProgramReflection reflection(program.id());
+        CPPUNIT_ASSERT(reflection.program() == program.id());
+
+        // Uniforms, including those in the block
+        const size_t matrix = reflection.findUniform("MVPMatrix");
+        CPPUNIT_ASSERT(matrix != Glycerin::ProgramReflection::NOT_FOUND);
+        CPPUNIT_ASSERT(reflection.uniform(matrix).type == GL_FLOAT_MAT4);
+        CPPUNIT_ASSERT(reflection.uniform(matrix).location == glGetUniformLocation(program.id(), "MVPMatrix"));
+        const size_t offsets = reflection.findUniform("Offsets");
+        CPPUNIT_ASSERT(offsets != Glycerin::ProgramReflection::NOT_FOUND);
+        CPPUNIT_ASSERT_EQUAL(4, reflection.uniform(offsets).size);
+        CPPUNIT_ASSERT(reflection.uniformLocation("LightColor") == -1);
+        CPPUNIT_ASSERT(reflection.uniformLocation("Missing") == -1);
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, reflection.uniforms());
+
+        // Attributes
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, reflection.attributes());
+        CPPUNIT_ASSERT(reflection.attributeLocation("MCNormal") == glGetAttribLocation(program.id(), "MCNormal"));
+        CPPUNIT_ASSERT(reflection.findAttribute("gl_VertexID") == Glycerin::ProgramReflection::NOT_FOUND);
+
+        // Blocks
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, reflection.blocks());
+        const size_t lights = reflection.findBlock("Lights");
+        CPPUNIT_ASSERT(reflection.block(lights).size >= 32);
+        CPPUNIT_ASSERT(reflection.blockIndex("Lights") == glGetUniformBlockIndex(program.id(), "Lights"));
+    }
+
+    /**
+     * Tests that `ProgramReflection` rejects a program that was not linked.
+     */
+    void testUnlinked() {
+        const Gloop::Program program = Gloop::Program::create();
+        try {
+            Glycerin::ProgramReflection reflection(program.id());
+        } catch (std::invalid_argument& e) {
+            return;
+        }
+        throw std::runtime_error("Unlinked program was accepted!");
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run tests
+    try {
+        ProgramReflectionTest test;
+        test.testReflect();
+        test.testUnlinked();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
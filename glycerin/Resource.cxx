@@ -0,0 +1,142 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdlib>
+#include <stdexcept>
+#include "glycerin/Resource.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Name and contents of one embedded file.
+ */
+struct Resource::Entry {
+    const char* name;
+    const char* data;
+    size_t size;
+};
+
+// Every embedded file, generated from the originals by the build
+#define GLYCERIN_RESOURCE(name, data) { name, data, sizeof(data) - 1 },
+const Resource::Entry Resource::ENTRIES[] = {
+#include "resources.inc"
+};
+#undef GLYCERIN_RESOURCE
+
+// Number of embedded files
+const size_t Resource::NUMBER_OF_ENTRIES = sizeof(ENTRIES) / sizeof(ENTRIES[0]);
+
+// Environment variable naming a directory to load resources from instead
+const char* const Resource::DIRECTORY_VARIABLE = "GLYCERIN_RESOURCE_DIR";
+
+/**
+ * Constructs a resource.
+ *
+ * @param entry Embedded file the resource refers to
+ */
+Resource::Resource(const Entry* const entry) : _entry(entry) {
+    // empty
+}
+
+/**
+ * Returns the contents of the resource.
+ */
+const GLubyte* Resource::data() const {
+    return (const GLubyte*) _entry->data;
+}
+
+/**
+ * Checks if a file was embedded.
+ *
+ * @param name Name of the original file, without any directories
+ * @return `true` if a resource with that name exists
+ */
+bool Resource::exists(const string& name) {
+    return lookup(name) != NULL;
+}
+
+/**
+ * Finds an embedded file.
+ *
+ * @param name Name of the original file, without any directories
+ * @return Resource with that name
+ * @throws invalid_argument if name is empty
+ * @throws runtime_error if no resource has that name
+ */
+Resource Resource::find(const string& name) {
+    if (name.empty()) {
+        throw invalid_argument("[Resource] Name of resource is empty!");
+    }
+    const Entry* const entry = lookup(name);
+    if (entry == NULL) {
+        throw runtime_error("[Resource] Could not find resource!");
+    }
+    return Resource(entry);
+}
+
+/**
+ * Determines where to load a resource from instead of using the embedded copy.
+ *
+ * @param name Name of the original file, without any directories
+ * @return Path to the file in the directory named by `GLYCERIN_RESOURCE_DIR`, or an empty string if it is not set
+ */
+string Resource::getOverride(const string& name) {
+    const char* const directory = getenv(DIRECTORY_VARIABLE);
+    if ((directory == NULL) || (directory[0] == '\0')) {
+        return "";
+    }
+    return string(directory) + '/' + name;
+}
+
+/**
+ * Searches the embedded files.
+ *
+ * @param name Name of the original file
+ * @return Pointer to the entry for the file, or `NULL` if there is none
+ */
+const Resource::Entry* Resource::lookup(const string& name) {
+    for (size_t i = 0; i < NUMBER_OF_ENTRIES; ++i) {
+        if (name == ENTRIES[i].name) {
+            return &ENTRIES[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns the name of the original file.
+ */
+const char* Resource::name() const {
+    return _entry->name;
+}
+
+/**
+ * Returns the number of bytes in the resource.
+ */
+size_t Resource::size() const {
+    return _entry->size;
+}
+
+/**
+ * Returns a copy of the contents as text, such as for shader source code.
+ */
+string Resource::toString() const {
+    return string(_entry->data, _entry->size);
+}
+
+} /* namespace Glycerin */
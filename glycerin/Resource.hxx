@@ -0,0 +1,74 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_RESOURCE_HXX
+#define GLYCERIN_RESOURCE_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <string>
+namespace Glycerin {
+
+
+/**
+ * File compiled into the library.
+ *
+ * The font and shaders Glycerin needs are embedded when the library is
+ * built, so nothing has to be found on disk at run time.  Look one up by its
+ * original file name with [find].
+ *
+ * ~~~
+ * const Resource font = Resource::find("monospaced-24.bmp");
+ * const Bitmap bitmap = BitmapReader().readMemory(font.data(), font.size());
+ * ~~~
+ *
+ * The contents live in the library's read-only data, so resources are cheap
+ * to copy and never need to be freed.
+ *
+ * To try out changes to the files without rebuilding, set the
+ * `GLYCERIN_RESOURCE_DIR` environment variable to a directory holding
+ * replacements.  Code that loads a resource asks [get-override] for the path
+ * of the replacement first.
+ *
+ * [find]: @ref find(const std::string&) "find(const std::string&)"
+ * [get-override]: @ref getOverride(const std::string&) "getOverride(const std::string&)"
+ */
+class Resource {
+public:
+// Methods
+    const GLubyte* data() const;
+    const char* name() const;
+    size_t size() const;
+    std::string toString() const;
+    static bool exists(const std::string& name);
+    static Resource find(const std::string& name);
+    static std::string getOverride(const std::string& name);
+private:
+// Types
+    struct Entry;
+// Constants
+    static const char* const DIRECTORY_VARIABLE;
+    static const Entry ENTRIES[];
+    static const size_t NUMBER_OF_ENTRIES;
+// Attributes
+    const Entry* _entry;
+// Methods
+    explicit Resource(const Entry* entry);
+    static const Entry* lookup(const std::string& name);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/Resource.hxx"
+
+
+/**
+ * Unit test for `Resource`.
+ */
+class ResourceTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns every byte of a file.
+     */
+    static std::string readContents(const std::string& filename) {
+        std::ifstream file(filename.c_str(), std::ios_base::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Ensures `Resource::find` returns exactly the contents of each embedded file.
+     */
+    void testFind() {
+        const char* names[] = {
+                "monospaced-24.bmp",
+                "sprite-batch.frag",
+                "sprite-batch.vert",
+                "text-renderer.frag",
+                "text-renderer-sdf.frag",
+                "text-renderer.vert" };
+        for (int i = 0; i < 6; ++i) {
+            const Glycerin::Resource resource = Glycerin::Resource::find(names[i]);
+            const std::string expected = readContents(std::string("glycerin/") + names[i]);
+            CPPUNIT_ASSERT_EQUAL(std::string(names[i]), std::string(resource.name()));
+            CPPUNIT_ASSERT_EQUAL(expected.size(), resource.size());
+            CPPUNIT_ASSERT(expected == resource.toString());
+        }
+    }
+
+    /**
+     * Ensures `Resource::find` throws for a name that was not embedded.
+     */
+    void testFindWithMissingName() {
+        CPPUNIT_ASSERT(!Glycerin::Resource::exists("missing.bmp"));
+        CPPUNIT_ASSERT_THROW(Glycerin::Resource::find("missing.bmp"), std::runtime_error);
+        CPPUNIT_ASSERT_THROW(Glycerin::Resource::find(""), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `Resource::getOverride` only returns a path when `GLYCERIN_RESOURCE_DIR` is set.
+     */
+    void testGetOverride() {
+        unsetenv("GLYCERIN_RESOURCE_DIR");
+        CPPUNIT_ASSERT_EQUAL(std::string(), Glycerin::Resource::getOverride("text-renderer.vert"));
+        setenv("GLYCERIN_RESOURCE_DIR", "", 1);
+        CPPUNIT_ASSERT_EQUAL(std::string(), Glycerin::Resource::getOverride("text-renderer.vert"));
+        setenv("GLYCERIN_RESOURCE_DIR", "/tmp/glycerin", 1);
+        CPPUNIT_ASSERT_EQUAL(std::string("/tmp/glycerin/text-renderer.vert"),
+                Glycerin::Resource::getOverride("text-renderer.vert"));
+        unsetenv("GLYCERIN_RESOURCE_DIR");
+    }
+
+    CPPUNIT_TEST_SUITE(ResourceTest);
+    CPPUNIT_TEST(testFind);
+    CPPUNIT_TEST(testFindWithMissingName);
+    CPPUNIT_TEST(testGetOverride);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(ResourceTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include "glycerin/RollingStatistics.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs an empty `RollingStatistics`.
+ *
+ * @param capacity Number of recent samples to keep, by default 120
+ * @throws invalid_argument if capacity is zero
+ */
+RollingStatistics::RollingStatistics(const size_t capacity) : _next(0), _count(0) {
+    if (capacity == 0) {
+        throw invalid_argument("[RollingStatistics] Capacity must be positive!");
+    }
+    _samples.resize(capacity);
+}
+
+/**
+ * Adds a sample, dropping the oldest if the ring is full.
+ *
+ * @param sample Value to add
+ */
+void RollingStatistics::add(const double sample) {
+    _samples[_next] = sample;
+    _next = (_next + 1) % _samples.size();
+    if (_count < _samples.size()) {
+        ++_count;
+    }
+}
+
+/**
+ * Returns the average of the kept samples, or zero if there are none.
+ */
+double RollingStatistics::average() const {
+    if (_count == 0) {
+        return 0;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < _count; ++i) {
+        sum += _samples[i];
+    }
+    return sum / _count;
+}
+
+/**
+ * Returns the number of recent samples kept.
+ */
+size_t RollingStatistics::capacity() const {
+    return _samples.size();
+}
+
+/**
+ * Drops all the samples.
+ */
+void RollingStatistics::clear() {
+    _next = 0;
+    _count = 0;
+}
+
+/**
+ * Returns the number of samples kept so far, at most the capacity.
+ */
+size_t RollingStatistics::count() const {
+    return _count;
+}
+
+/**
+ * Returns the most recent sample, or zero if there are none.
+ */
+double RollingStatistics::last() const {
+    if (_count == 0) {
+        return 0;
+    }
+    return _samples[(_next + _samples.size() - 1) % _samples.size()];
+}
+
+/**
+ * Returns the largest of the kept samples, or zero if there are none.
+ */
+double RollingStatistics::maximum() const {
+    if (_count == 0) {
+        return 0;
+    }
+    double value = _samples[0];
+    for (size_t i = 1; i < _count; ++i) {
+        if (_samples[i] > value) {
+            value = _samples[i];
+        }
+    }
+    return value;
+}
+
+/**
+ * Returns the smallest of the kept samples, or zero if there are none.
+ */
+double RollingStatistics::minimum() const {
+    if (_count == 0) {
+        return 0;
+    }
+    double value = _samples[0];
+    for (size_t i = 1; i < _count; ++i) {
+        if (_samples[i] < value) {
+            value = _samples[i];
+        }
+    }
+    return value;
+}
+
+} /* namespace Glycerin */
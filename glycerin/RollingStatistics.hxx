@@ -0,0 +1,60 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_ROLLING_STATISTICS_HXX
+#define GLYCERIN_ROLLING_STATISTICS_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Minimum, average and maximum of the most recent samples of a measurement.
+ *
+ * Samples are kept in a ring, so adding one is constant time and replaces
+ * the oldest once the ring is full.  The statistics are worked out from the
+ * ring only when asked for, which is usually much less often.
+ *
+ * ~~~
+ * RollingStatistics frameTimes(60);
+ * frameTimes.add(16.2);
+ * frameTimes.add(17.1);
+ * double worst = frameTimes.maximum();
+ * ~~~
+ */
+class RollingStatistics {
+public:
+// Methods
+    explicit RollingStatistics(size_t capacity = 120);
+    void add(double sample);
+    double average() const;
+    size_t capacity() const;
+    void clear();
+    size_t count() const;
+    double last() const;
+    double maximum() const;
+    double minimum() const;
+private:
+// Attributes
+    std::vector<double> _samples;
+    size_t _next;
+    size_t _count;
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/RollingStatistics.hxx"
+
+
+/**
+ * Unit test for `RollingStatistics`.
+ */
+class RollingStatisticsTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures the statistics cover every sample before the ring is full.
+     */
+    void testAdd() {
+        Glycerin::RollingStatistics statistics(4);
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, statistics.count());
+        CPPUNIT_ASSERT_EQUAL(0.0, statistics.average());
+        statistics.add(3);
+        statistics.add(1);
+        statistics.add(2);
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, statistics.count());
+        CPPUNIT_ASSERT_EQUAL(1.0, statistics.minimum());
+        CPPUNIT_ASSERT_EQUAL(2.0, statistics.average());
+        CPPUNIT_ASSERT_EQUAL(3.0, statistics.maximum());
+        CPPUNIT_ASSERT_EQUAL(2.0, statistics.last());
+    }
+
+    /**
+     * Ensures the oldest samples are dropped once the ring is full.
+     */
+    void testAddWhenFull() {
+        Glycerin::RollingStatistics statistics(3);
+        statistics.add(100);
+        statistics.add(1);
+        statistics.add(2);
+        statistics.add(3);
+        statistics.add(4);
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, statistics.count());
+        CPPUNIT_ASSERT_EQUAL(2.0, statistics.minimum());
+        CPPUNIT_ASSERT_EQUAL(3.0, statistics.average());
+        CPPUNIT_ASSERT_EQUAL(4.0, statistics.maximum());
+        CPPUNIT_ASSERT_EQUAL(4.0, statistics.last());
+    }
+
+    /**
+     * Ensures `RollingStatistics::clear` drops everything and rejects an empty ring.
+     */
+    void testClear() {
+        Glycerin::RollingStatistics statistics(2);
+        statistics.add(5);
+        statistics.clear();
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, statistics.count());
+        CPPUNIT_ASSERT_EQUAL(0.0, statistics.maximum());
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, statistics.capacity());
+        CPPUNIT_ASSERT_THROW(Glycerin::RollingStatistics(0), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(RollingStatisticsTest);
+    CPPUNIT_TEST(testAdd);
+    CPPUNIT_TEST(testAddWhenFull);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(RollingStatisticsTest::suite());
+    runner.run();
+    return 0;
+}
@@ -19,6 +19,7 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include "glycerin/Resource.hxx"
 #include "glycerin/ShaderFactory.hxx"
 using namespace std;
 namespace Glycerin {
@@ -50,6 +51,26 @@ Gloop::Shader ShaderFactory::createShaderFromFile(const GLenum type, const strin
     return createShaderFromStream(type, fs);
 }
 
+/**
+ * Creates a shader from a resource compiled into the library.
+ *
+ * If the `GLYCERIN_RESOURCE_DIR` environment variable is set, the file with
+ * the same name in that directory is used instead.
+ *
+ * @param type Kind of shader, e.g. `GL_VERTEX_SHADER` or `GL_FRAGMENT_SHADER`
+ * @param name Name of the resource holding the shader's source code
+ * @return OpenGL handle to the shader
+ * @throws invalid_argument if type is invalid or name is empty
+ * @throws runtime_error if resource does not exist or could not compile shader
+ */
+Gloop::Shader ShaderFactory::createShaderFromResource(const GLenum type, const string& name) {
+    const string path = Resource::getOverride(name);
+    if (!path.empty()) {
+        return createShaderFromFile(type, path);
+    }
+    return createShaderFromString(type, Resource::find(name).toString());
+}
+
 /**
  * Creates a shader from a stream.
  *
@@ -24,12 +24,18 @@ namespace Glycerin {
 
 /**
  * Utility for creating shaders.
+ *
+ * Shaders compiled into the library can be made with
+ * `createShaderFromResource`.  To try out changes to them without
+ * rebuilding, set the `GLYCERIN_RESOURCE_DIR` environment variable to a
+ * directory holding replacements, which are then read instead.
  */
 class ShaderFactory {
 public:
 // Methods
     ShaderFactory();
     Gloop::Shader createShaderFromFile(GLenum type, const std::string& filename);
+    Gloop::Shader createShaderFromResource(GLenum type, const std::string& name);
     Gloop::Shader createShaderFromStream(GLenum type, std::istream& stream);
     Gloop::Shader createShaderFromString(GLenum type, const std::string& str);
 private:
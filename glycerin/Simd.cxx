@@ -0,0 +1,48 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+#include "glycerin/Simd.hxx"
+namespace Glycerin {
+
+/**
+ * Adds a weighted array to another array.
+ *
+ * @param n Number of elements in each array
+ * @param weight Weight to multiply source elements by
+ * @param src Array to add
+ * @param dst Array to add to
+ */
+void Simd::accumulate(const size_t n, const GLfloat weight, const GLfloat* src, GLfloat* dst) {
+    size_t i = 0;
+#ifdef __SSE__
+    const __m128 w = _mm_set1_ps(weight);
+    for (; i + 4 <= n; i += 4) {
+        const __m128 s = _mm_loadu_ps(src + i);
+        const __m128 d = _mm_loadu_ps(dst + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(w, s)));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] += weight * src[i];
+    }
+}
+
+} /* namespace Glycerin */
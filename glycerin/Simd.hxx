@@ -0,0 +1,48 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_SIMD_HXX
+#define GLYCERIN_SIMD_HXX
+#include <cstddef>
+#include "glycerin/common.h"
+namespace Glycerin {
+
+
+/**
+ * Utility for arithmetic on rows of floating-point values.
+ *
+ * Separable filters spend most of their time adding weighted rows together.
+ * _Simd_ does that four values at a time with SSE when the compiler allows,
+ * and one at a time otherwise, so every filter shares the same kernel.
+ *
+ * ~~~
+ * for (int k = 0; k < taps; ++k) {
+ *     Simd::accumulate(width, weights[k], &src[k * width], row);
+ * }
+ * ~~~
+ */
+class Simd {
+public:
+// Methods
+    static void accumulate(size_t n, GLfloat weight, const GLfloat* src, GLfloat* dst);
+private:
+// Methods
+    Simd();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/Simd.hxx"
+
+
+/**
+ * Unit test for `Simd`.
+ */
+class SimdTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures `Simd::accumulate` adds every element, including ones past the last group of four.
+     */
+    void testAccumulate() {
+        GLfloat src[11];
+        GLfloat dst[11];
+        for (int i = 0; i < 11; ++i) {
+            src[i] = (GLfloat) i;
+            dst[i] = 1.0f;
+        }
+        Glycerin::Simd::accumulate(11, 0.5f, src, dst);
+        for (int i = 0; i < 11; ++i) {
+            CPPUNIT_ASSERT_EQUAL(1.0f + 0.5f * i, dst[i]);
+        }
+    }
+
+    CPPUNIT_TEST_SUITE(SimdTest);
+    CPPUNIT_TEST(testAccumulate);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(SimdTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,526 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <gloop/TextureTarget.hxx>
+#include <gloop/VertexAttribPointer.hxx>
+#include <m3d/Mat4.h>
+#include "glycerin/Projection.hxx"
+#include "glycerin/ShaderFactory.hxx"
+#include "glycerin/SpriteBatch.hxx"
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a `SpriteBatch`.
+ *
+ * Rectangles are blended by alpha, colored by their texture and put on layer
+ * zero until changed with `blend`, `mode` and `layer`.
+ *
+ * @throws runtime_error if the shaders could not be compiled or linked
+ */
+SpriteBatch::SpriteBatch() :
+        _instanced(StateCache::isVersionSupported(3, 3)),
+        _streamBuffer(GL_ARRAY_BUFFER, STREAM_BUFFER_CAPACITY),
+        _program(createProgram()),
+        _reflection(_program.id()),
+        _rectangleLocation(_reflection.attributeLocation("MCRectangle")),
+        _regionLocation(_reflection.attributeLocation("Region")),
+        _tintLocation(_reflection.attributeLocation("Tint")),
+        _matrixLocation(_reflection.uniformLocation("MVPMatrix")),
+        _modeLocation(_reflection.uniformLocation("Mode")),
+        _vertexArray(Gloop::VertexArrayObject::generate()),
+        _white(createWhiteTexture()),
+        _blend(ALPHA),
+        _mode(COLOR),
+        _layer(0),
+        _width(-1),
+        _height(-1),
+        _draws(0) {
+
+    // Point the vertex array at the stream buffer
+    StateCache& state = StateCache::current();
+    state.bindVertexArray(_vertexArray.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, _streamBuffer.id());
+    setUpPointers(0);
+
+    // Sample from the first texture unit
+    state.useProgram(_program.id());
+    glUniform1i(_reflection.uniformLocation("Texture"), 0);
+
+    // Unbind
+    state.bindBuffer(GL_ARRAY_BUFFER, 0);
+    state.bindVertexArray(0);
+}
+
+/**
+ * Destroys this `SpriteBatch`, deleting the objects it made.
+ */
+SpriteBatch::~SpriteBatch() {
+
+    StateCache& state = StateCache::current();
+
+    GLuint texture = _white.id();
+    state.forgetTexture(texture);
+    glDeleteTextures(1, &texture);
+
+    GLuint array = _vertexArray.id();
+    state.forgetVertexArray(array);
+    glDeleteVertexArrays(1, &array);
+
+    glDeleteProgram(_program.id());
+}
+
+/**
+ * Adds a rectangle to be drawn with the current layer, blend mode and shading mode.
+ *
+ * @param texture OpenGL handle to the texture
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of bottom edge
+ * @param width Size of rectangle on X axis
+ * @param height Size of rectangle on Y axis
+ * @param s0 Texture coordinate of left edge
+ * @param t0 Texture coordinate of bottom edge
+ * @param s1 Texture coordinate of right edge
+ * @param t1 Texture coordinate of top edge
+ * @param color Color to multiply the texture by
+ */
+void SpriteBatch::add(const GLuint texture,
+                      const GLfloat x, const GLfloat y, const GLfloat width, const GLfloat height,
+                      const GLfloat s0, const GLfloat t0, const GLfloat s1, const GLfloat t1,
+                      const Color& color) {
+
+    _sprites.resize(_sprites.size() + 1);
+    Sprite& sprite = _sprites.back();
+    sprite.layer = _layer;
+    sprite.state = (_blend << 8) | _mode;
+    sprite.texture = texture;
+
+    Instance& instance = sprite.instance;
+    instance.rectangle[0] = x;
+    instance.rectangle[1] = y;
+    instance.rectangle[2] = width;
+    instance.rectangle[3] = height;
+    instance.region[0] = s0;
+    instance.region[1] = t0;
+    instance.region[2] = s1;
+    instance.region[3] = t1;
+    instance.tint[0] = toByte(color.r);
+    instance.tint[1] = toByte(color.g);
+    instance.tint[2] = toByte(color.b);
+    instance.tint[3] = toByte(color.a);
+}
+
+/**
+ * Changes the blending function for a blend mode.
+ *
+ * @param blend Blend mode to change to
+ */
+void SpriteBatch::applyBlend(const Blend blend) {
+    StateCache& state = StateCache::current();
+    switch (blend) {
+    case ALPHA:
+        state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        state.enable(GL_BLEND);
+        break;
+    case ADDITIVE:
+        state.blendFunc(GL_SRC_ALPHA, GL_ONE);
+        state.enable(GL_BLEND);
+        break;
+    case PREMULTIPLIED:
+        state.blendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        state.enable(GL_BLEND);
+        break;
+    case REPLACE:
+        state.disable(GL_BLEND);
+        break;
+    }
+}
+
+/**
+ * Starts rendering.
+ *
+ * @param width Width of the viewport
+ * @param height Height of the viewport
+ */
+void SpriteBatch::beginRendering(const GLsizei width, const GLsizei height) {
+
+    StateCache& state = StateCache::current();
+    state.blendEquation(GL_FUNC_ADD);
+    state.activeTexture(GL_TEXTURE0);
+    state.useProgram(_program.id());
+
+    // Set transformation matrix if the size changed
+    if ((width != _width) || (height != _height)) {
+        const M3d::Mat4 mat = Projection::orthographic(width, height);
+        GLfloat arr[16];
+        mat.toArrayInColumnMajor(arr);
+        glUniformMatrix4fv(_matrixLocation, 1, false, arr);
+        _width = width;
+        _height = height;
+    }
+
+    _sprites.clear();
+}
+
+/**
+ * Returns how rectangles drawn from now on are combined with what is already drawn.
+ */
+SpriteBatch::Blend SpriteBatch::blend() const {
+    return _blend;
+}
+
+/**
+ * Changes how rectangles drawn from now on are combined with what is already drawn.
+ *
+ * @param blend Blend mode, `ALPHA` by default
+ * @return Reference to this batch to support chaining
+ */
+SpriteBatch& SpriteBatch::blend(const Blend blend) {
+    _blend = blend;
+    return (*this);
+}
+
+/**
+ * Creates the shader program used to draw the rectangles.
+ *
+ * @return Shader program used to draw the rectangles
+ */
+Gloop::Program SpriteBatch::createProgram() {
+
+    // Create shaders
+    ShaderFactory shaderFactory;
+    const Gloop::Shader vertexShader = shaderFactory.createShaderFromResource(GL_VERTEX_SHADER, "sprite-batch.vert");
+    const Gloop::Shader fragmentShader = shaderFactory.createShaderFromResource(GL_FRAGMENT_SHADER, "sprite-batch.frag");
+
+    // Create program and attach shaders
+    const Gloop::Program program = Gloop::Program::create();
+    program.attachShader(vertexShader);
+    program.attachShader(fragmentShader);
+
+    // Link program
+    program.link();
+    if (!program.linked()) {
+        throw runtime_error(program.log());
+    }
+    return program;
+}
+
+/**
+ * Creates the white texture that filled rectangles are drawn with.
+ *
+ * @return Handle to a texture holding one opaque white texel
+ */
+Gloop::TextureObject SpriteBatch::createWhiteTexture() {
+
+    const Gloop::TextureObject textureObject = Gloop::TextureObject::generate();
+    const Gloop::TextureTarget texture2d = Gloop::TextureTarget::texture2d();
+    const GLubyte texel[4] = { 255, 255, 255, 255 };
+
+    StateCache::current().bindTexture(GL_TEXTURE_2D, textureObject.id());
+    texture2d.texImage2d(0, GL_RGBA8, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+    texture2d.minFilter(GL_NEAREST);
+    texture2d.magFilter(GL_NEAREST);
+
+    return textureObject;
+}
+
+/**
+ * Draws a whole texture stretched over a rectangle.
+ *
+ * @param texture Texture to draw
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of bottom edge
+ * @param width Size of rectangle on X axis
+ * @param height Size of rectangle on Y axis
+ * @param color Color to multiply the texture by, white by default
+ */
+void SpriteBatch::draw(const Gloop::TextureObject& texture,
+                       const GLfloat x, const GLfloat y, const GLfloat width, const GLfloat height,
+                       const Color& color) {
+    add(texture.id(), x, y, width, height, 0, 0, 1, 1, color);
+}
+
+/**
+ * Draws one region of an atlas at its own size.
+ *
+ * @param texture Texture made from the atlas
+ * @param region Region of the atlas to draw
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of bottom edge
+ * @param color Color to multiply the texture by, white by default
+ */
+void SpriteBatch::draw(const Gloop::TextureObject& texture,
+                       const AtlasRegion& region,
+                       const GLfloat x, const GLfloat y,
+                       const Color& color) {
+    add(texture.id(),
+        x, y, region.width(), region.height(),
+        region.s0(), region.t0(), region.s1(), region.t1(),
+        color);
+}
+
+/**
+ * Draws part of a texture stretched over a rectangle.
+ *
+ * @param texture Texture to draw
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of bottom edge
+ * @param width Size of rectangle on X axis
+ * @param height Size of rectangle on Y axis
+ * @param s0 Texture coordinate of left edge
+ * @param t0 Texture coordinate of bottom edge
+ * @param s1 Texture coordinate of right edge
+ * @param t1 Texture coordinate of top edge
+ * @param color Color to multiply the texture by, white by default
+ */
+void SpriteBatch::draw(const Gloop::TextureObject& texture,
+                       const GLfloat x, const GLfloat y, const GLfloat width, const GLfloat height,
+                       const GLfloat s0, const GLfloat t0, const GLfloat s1, const GLfloat t1,
+                       const Color& color) {
+    add(texture.id(), x, y, width, height, s0, t0, s1, t1, color);
+}
+
+/**
+ * Returns the number of draw calls made the last time rendering ended.
+ */
+size_t SpriteBatch::draws() const {
+    return _draws;
+}
+
+/**
+ * Finishes rendering, drawing all the rectangles collected since rendering started.
+ *
+ * Blending, the program and the last texture are left as they are.  The
+ * vertex array is unbound so that later calls to `glVertexAttribPointer`
+ * cannot change it.
+ */
+void SpriteBatch::endRendering() {
+    flush();
+    StateCache::current().bindVertexArray(0);
+}
+
+/**
+ * Fills a rectangle with a color.
+ *
+ * @param x Location on X axis of left edge
+ * @param y Location on Y axis of bottom edge
+ * @param width Size of rectangle on X axis
+ * @param height Size of rectangle on Y axis
+ * @param color Color to fill with
+ */
+void SpriteBatch::fill(const GLfloat x, const GLfloat y, const GLfloat width, const GLfloat height, const Color& color) {
+    add(_white.id(), x, y, width, height, 0, 0, 1, 1, color);
+}
+
+/**
+ * Sorts the collected rectangles, uploads them in one piece and draws each run of equal state with one call.
+ *
+ * The stream buffer is replaced with one twice as large whenever the
+ * rectangles do not fit in it.
+ */
+void SpriteBatch::flush() {
+
+    _draws = 0;
+    if (_sprites.empty()) {
+        return;
+    }
+
+    // Group rectangles that can be drawn together, keeping the order within each group
+    stable_sort(_sprites.begin(), _sprites.end(), isSortedBefore);
+
+    // Copy out the instances, once per instance or once per vertex
+    const int copies = _instanced ? 1 : VERTICES_PER_SPRITE;
+    _instances.resize(_sprites.size() * copies);
+    size_t n = 0;
+    for (vector<Sprite>::const_iterator it = _sprites.begin(); it != _sprites.end(); ++it) {
+        for (int j = 0; j < copies; ++j) {
+            _instances[n++] = it->instance;
+        }
+    }
+
+    // Make room
+    StateCache& state = StateCache::current();
+    state.bindVertexArray(_vertexArray.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, _streamBuffer.id());
+    const GLsizeiptr size = _instances.size() * sizeof(Instance);
+    if (size > _streamBuffer.capacity()) {
+        GLsizeiptr capacity = _streamBuffer.capacity();
+        while (capacity < size) {
+            capacity *= 2;
+        }
+        _streamBuffer.reserve(capacity);
+        state.bindBuffer(GL_ARRAY_BUFFER, _streamBuffer.id());
+        setUpPointers(0);
+    }
+
+    // Upload
+    const GLsizeiptr stride = sizeof(Instance);
+    const GLintptr offset = _streamBuffer.write(&_instances[0], size, stride * copies);
+
+    // Draw each run of rectangles with the same state and texture
+    GLint mode = -1;
+    size_t first = 0;
+    while (first < _sprites.size()) {
+
+        const GLuint key = _sprites[first].state;
+        const GLuint texture = _sprites[first].texture;
+        size_t last = first + 1;
+        while ((last < _sprites.size()) && (_sprites[last].state == key) && (_sprites[last].texture == texture)) {
+            ++last;
+        }
+
+        // Change state
+        applyBlend((Blend) (key >> 8));
+        if ((GLint) (key & 0xFF) != mode) {
+            mode = key & 0xFF;
+            glUniform1i(_modeLocation, mode);
+        }
+        state.bindTexture(GL_TEXTURE_2D, texture);
+
+        // Draw
+        const GLsizei count = last - first;
+        if (_instanced) {
+            setUpPointers(offset + first * stride);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, VERTICES_PER_SPRITE, count);
+        } else {
+            glDrawArrays(GL_TRIANGLES, offset / stride + first * VERTICES_PER_SPRITE, count * VERTICES_PER_SPRITE);
+        }
+        ++_draws;
+        first = last;
+    }
+
+    _streamBuffer.fence();
+    _sprites.clear();
+}
+
+/**
+ * Checks if one rectangle must be drawn in an earlier run than another.
+ *
+ * @param a First rectangle
+ * @param b Second rectangle
+ * @return `true` if _a_ is on a lower layer, or on the same layer with lower state or texture
+ */
+bool SpriteBatch::isSortedBefore(const Sprite& a, const Sprite& b) {
+    if (a.layer != b.layer) {
+        return a.layer < b.layer;
+    } else if (a.state != b.state) {
+        return a.state < b.state;
+    } else {
+        return a.texture < b.texture;
+    }
+}
+
+/**
+ * Returns the layer rectangles drawn from now on are put on.
+ */
+GLint SpriteBatch::layer() const {
+    return _layer;
+}
+
+/**
+ * Changes the layer rectangles drawn from now on are put on.
+ *
+ * Higher layers are drawn on top of lower ones.
+ *
+ * @param layer Layer, zero by default
+ * @return Reference to this batch to support chaining
+ */
+SpriteBatch& SpriteBatch::layer(const GLint layer) {
+    _layer = layer;
+    return (*this);
+}
+
+/**
+ * Returns how the texture of rectangles drawn from now on is turned into a color.
+ */
+SpriteBatch::Mode SpriteBatch::mode() const {
+    return _mode;
+}
+
+/**
+ * Changes how the texture of rectangles drawn from now on is turned into a color.
+ *
+ * @param mode Shading mode, `COLOR` by default
+ * @return Reference to this batch to support chaining
+ */
+SpriteBatch& SpriteBatch::mode(const Mode mode) {
+    _mode = mode;
+    return (*this);
+}
+
+/**
+ * Points the vertex attributes at the stream buffer.
+ *
+ * The vertex array object and the stream buffer must already be bound.
+ *
+ * @param offset Offset in bytes of the first instance in the stream buffer
+ */
+void SpriteBatch::setUpPointers(const GLintptr offset) const {
+
+    const GLsizei stride = sizeof(Instance);
+
+    _vertexArray.enableVertexAttribArray(_rectangleLocation);
+    _vertexArray.vertexAttribPointer(Gloop::VertexAttribPointer()
+            .index(_rectangleLocation)
+            .size(4)
+            .stride(stride)
+            .offset(offset + offsetof(Instance, rectangle)));
+
+    _vertexArray.enableVertexAttribArray(_regionLocation);
+    _vertexArray.vertexAttribPointer(Gloop::VertexAttribPointer()
+            .index(_regionLocation)
+            .size(4)
+            .stride(stride)
+            .offset(offset + offsetof(Instance, region)));
+
+    _vertexArray.enableVertexAttribArray(_tintLocation);
+    _vertexArray.vertexAttribPointer(Gloop::VertexAttribPointer()
+            .index(_tintLocation)
+            .size(4)
+            .type(GL_UNSIGNED_BYTE)
+            .normalized(true)
+            .stride(stride)
+            .offset(offset + offsetof(Instance, tint)));
+
+    if (_instanced) {
+        glVertexAttribDivisor(_rectangleLocation, 1);
+        glVertexAttribDivisor(_regionLocation, 1);
+        glVertexAttribDivisor(_tintLocation, 1);
+    }
+}
+
+/**
+ * Converts a color component to a normalized byte.
+ *
+ * @param value Component from zero to one, clamped if outside
+ * @return Component from zero to 255
+ */
+GLubyte SpriteBatch::toByte(const GLfloat value) {
+    if (!(value > 0)) {
+        return 0;
+    } else if (value >= 1) {
+        return 255;
+    } else {
+        return (GLubyte) (value * 255 + 0.5f);
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,153 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_SPRITE_BATCH_HXX
+#define GLYCERIN_SPRITE_BATCH_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <vector>
+#include <gloop/Program.hxx>
+#include <gloop/TextureObject.hxx>
+#include <gloop/VertexArrayObject.hxx>
+#include "glycerin/AtlasRegion.hxx"
+#include "glycerin/Color.hxx"
+#include "glycerin/ProgramReflection.hxx"
+#include "glycerin/StreamBuffer.hxx"
+namespace Glycerin {
+
+
+/**
+ * Renderer that draws many textured or colored rectangles with few draw calls.
+ *
+ * Rectangles drawn between `beginRendering` and `endRendering` are collected
+ * on the CPU.  When rendering ends they are sorted by layer, blend mode,
+ * shading mode and texture, uploaded to a [stream buffer](@ref StreamBuffer)
+ * in one piece, and drawn with one call for each run that shares all of
+ * those.  A frame that fills some rectangles, draws icons from one atlas and
+ * draws text therefore needs only three draw calls, however the calls to
+ * `draw` and `fill` were interleaved.
+ *
+ * ~~~
+ * SpriteBatch batch;
+ * batch.beginRendering(width, height);
+ * batch.fill(10, 10, 200, 40, Color(0, 0, 0, 0.5f));
+ * batch.draw(atlas, iconRegion, 14, 14);
+ * textRenderer.draw(batch, "Score: 100", 50, 24);
+ * batch.endRendering();
+ * ~~~
+ *
+ * Sorting is stable, so rectangles with the same state are drawn in the
+ * order they were given.  Rectangles with different state are not, so
+ * anything that must appear on top of something else with a different
+ * texture or mode should be put on a higher `layer`.
+ *
+ * Each rectangle is sent as one instance holding its position, its region of
+ * the texture and its tint, and the vertex shader expands it into a quad.
+ * Without instanced arrays, as before OpenGL 3.3, each instance is repeated
+ * for the quad's six vertices instead.
+ */
+class SpriteBatch {
+public:
+// Types
+    /**
+     * How rectangles are combined with what is already drawn.
+     */
+    enum Blend {
+        ALPHA,          ///< Blend by the alpha of the source
+        ADDITIVE,       ///< Add the source, weighted by its alpha
+        PREMULTIPLIED,  ///< Blend a source whose colors are already multiplied by its alpha
+        REPLACE         ///< Replace what is already drawn, ignoring alpha
+    };
+    /**
+     * How the texture is turned into a color before it is tinted.
+     */
+    enum Mode {
+        COLOR,          ///< Use the texture's color as is
+        COVERAGE,       ///< Use the texture's red channel as alpha over white
+        DISTANCE_FIELD  ///< Treat the texture's red channel as a signed distance field
+    };
+// Methods
+    SpriteBatch();
+    virtual ~SpriteBatch();
+    void beginRendering(GLsizei width, GLsizei height);
+    Blend blend() const;
+    SpriteBatch& blend(Blend blend);
+    void draw(const Gloop::TextureObject& texture, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+            const Color& color = Color(1, 1, 1, 1));
+    void draw(const Gloop::TextureObject& texture, const AtlasRegion& region, GLfloat x, GLfloat y,
+            const Color& color = Color(1, 1, 1, 1));
+    void draw(const Gloop::TextureObject& texture, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+            GLfloat s0, GLfloat t0, GLfloat s1, GLfloat t1, const Color& color = Color(1, 1, 1, 1));
+    size_t draws() const;
+    void endRendering();
+    void fill(GLfloat x, GLfloat y, GLfloat width, GLfloat height, const Color& color);
+    GLint layer() const;
+    SpriteBatch& layer(GLint layer);
+    Mode mode() const;
+    SpriteBatch& mode(Mode mode);
+private:
+// Types
+    struct Instance {
+        GLfloat rectangle[4];
+        GLfloat region[4];
+        GLubyte tint[4];
+    };
+    struct Sprite {
+        GLint layer;
+        GLuint state;
+        GLuint texture;
+        Instance instance;
+    };
+// Constants
+    static const int VERTICES_PER_SPRITE = 6;
+    static const GLsizeiptr STREAM_BUFFER_CAPACITY = 262144;
+// Attributes
+    const bool _instanced;
+    StreamBuffer _streamBuffer;
+    const Gloop::Program _program;
+    const ProgramReflection _reflection;
+    const GLint _rectangleLocation;
+    const GLint _regionLocation;
+    const GLint _tintLocation;
+    const GLint _matrixLocation;
+    const GLint _modeLocation;
+    const Gloop::VertexArrayObject _vertexArray;
+    const Gloop::TextureObject _white;
+    Blend _blend;
+    Mode _mode;
+    GLint _layer;
+    GLsizei _width;
+    GLsizei _height;
+    size_t _draws;
+    std::vector<Sprite> _sprites;
+    std::vector<Instance> _instances;
+// Methods
+    SpriteBatch(const SpriteBatch&);
+    SpriteBatch& operator=(const SpriteBatch&);
+    void add(GLuint texture, GLfloat x, GLfloat y, GLfloat width, GLfloat height,
+            GLfloat s0, GLfloat t0, GLfloat s1, GLfloat t1, const Color& color);
+    static void applyBlend(Blend blend);
+    static Gloop::Program createProgram();
+    static Gloop::TextureObject createWhiteTexture();
+    void flush();
+    static bool isSortedBefore(const Sprite& a, const Sprite& b);
+    void setUpPointers(GLintptr offset) const;
+    static GLubyte toByte(GLfloat value);
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/Color.hxx"
+#include "glycerin/SpriteBatch.hxx"
+#include "glycerin/StateCache.hxx"
+#include "glycerin/TextRenderer.hxx"
+
+
+/**
+ * Test for `SpriteBatch`.
+ */
+class SpriteBatchTest {
+public:
+
+    /**
+     * Makes a small checkered texture.
+     */
+    static Gloop::TextureObject createCheckerTexture() {
+        GLubyte texels[4][4][4];
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                const GLubyte value = ((i + j) % 2) ? 255 : 64;
+                texels[i][j][0] = value;
+                texels[i][j][1] = 255 - value;
+                texels[i][j][2] = 128;
+                texels[i][j][3] = 255;
+            }
+        }
+        GLuint id;
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D, id);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        Glycerin::StateCache::current().invalidate();
+        return Gloop::TextureObject::fromId(id);
+    }
+
+    /**
+     * Tests that interleaved rectangles, textures and text are drawn with one call per texture.
+     */
+    void testDraw() {
+
+        // Clear
+        glClearColor(0.0f, 0.0f, 0.3f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // Interleave fills, a texture and text on one layer
+        const Gloop::TextureObject checker = createCheckerTexture();
+        Glycerin::TextRenderer textRenderer;
+        Glycerin::SpriteBatch batch;
+        batch.beginRendering(512, 512);
+        for (int i = 0; i < 8; ++i) {
+            const GLfloat y = 20 + i * 50;
+            batch.fill(10, y, 300, 40, Glycerin::Color(0.2f, 0.2f, 0.2f, 0.8f));
+            batch.draw(checker, 16, y + 4, 32, 32);
+            textRenderer.draw(batch, "Row", 60, y + 12, Glycerin::Color(1.0f, 0.8f, 0.2f));
+        }
+        batch.endRendering();
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, batch.draws());
+
+        // A different blend mode or layer needs its own run
+        batch.beginRendering(512, 512);
+        batch.fill(330, 20, 150, 150, Glycerin::Color(1, 0, 0, 1));
+        batch.blend(Glycerin::SpriteBatch::ADDITIVE).fill(380, 70, 150, 150, Glycerin::Color(0, 1, 0, 0.5f));
+        batch.blend(Glycerin::SpriteBatch::ALPHA).layer(1);
+        batch.draw(checker, 350, 300, 128, 128, 0, 0, 0.5f, 0.5f);
+        textRenderer.draw(batch, "On top", 350, 360);
+        batch.endRendering();
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, batch.draws());
+
+        // Nothing drawn means no calls
+        batch.beginRendering(512, 512);
+        batch.endRendering();
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, batch.draws());
+
+        // Flush and wait
+        glfwSwapBuffers();
+        glfwSleep(2.0);
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run test
+    try {
+        SpriteBatchTest test;
+        test.testDraw();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,447 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <pthread.h>
+#include "glycerin/StateCache.hxx"
+using namespace std;
+namespace Glycerin {
+
+// Makes the thread keys only once
+static pthread_once_t keysOnce = PTHREAD_ONCE_INIT;
+
+// Cache each thread is using
+static pthread_key_t currentKey;
+
+// Pass-through cache made for each thread that has not been given one, freed when the thread exits
+static pthread_key_t ownedKey;
+
+/**
+ * Frees a cache made for a thread when the thread exits.
+ */
+static void destroyOwned(void* cache) {
+    delete (StateCache*) cache;
+}
+
+/**
+ * Constructs a cache that knows nothing about the current state.
+ *
+ * @param caching Whether to skip changes and answer queries from what was set, or pass everything on to OpenGL
+ */
+StateCache::StateCache(const bool caching) :
+        _activeTexture(UNKNOWN),
+        _blendDestination(UNKNOWN),
+        _blendEquation(UNKNOWN),
+        _blendSource(UNKNOWN),
+        _caching(caching),
+        _issued(0),
+        _program(UNKNOWN),
+        _queried(0),
+        _skipped(0),
+        _vertexArray(UNKNOWN),
+        _viewportKnown(false) {
+    // empty
+}
+
+/**
+ * Destroys the cache.
+ */
+StateCache::~StateCache() {
+    // empty
+}
+
+/**
+ * Makes a texture unit active.
+ *
+ * @param unit Enumeration of the unit, e.g. `GL_TEXTURE0`
+ */
+void StateCache::activeTexture(const GLenum unit) {
+    if (change(_activeTexture, unit)) {
+        glActiveTexture(unit);
+    }
+}
+
+/**
+ * Binds a buffer.
+ *
+ * @param target Target to bind the buffer to, e.g. `GL_ARRAY_BUFFER`
+ * @param buffer Name of the buffer, or zero to unbind
+ */
+void StateCache::bindBuffer(const GLenum target, const GLuint buffer) {
+    map<GLenum,GLuint>::iterator it = _buffers.insert(make_pair(target, UNKNOWN)).first;
+    if (change(it->second, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+/**
+ * Binds a texture to the active texture unit.
+ *
+ * @param target Target to bind the texture to, e.g. `GL_TEXTURE_2D`
+ * @param texture Name of the texture, or zero to unbind
+ */
+void StateCache::bindTexture(const GLenum target, const GLuint texture) {
+
+    // Without knowing the unit there is nowhere to remember the texture
+    if (_activeTexture == UNKNOWN) {
+        ++_issued;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    const pair<GLenum,GLenum> key(_activeTexture, target);
+    map<pair<GLenum,GLenum>,GLuint>::iterator it = _textures.insert(make_pair(key, UNKNOWN)).first;
+    if (change(it->second, texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+/**
+ * Binds a vertex array.
+ *
+ * The element array buffer belongs to the vertex array, so it is forgotten
+ * whenever the vertex array changes.
+ *
+ * @param array Name of the vertex array, or zero to unbind
+ */
+void StateCache::bindVertexArray(const GLuint array) {
+    if (change(_vertexArray, array)) {
+        glBindVertexArray(array);
+        _buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+/**
+ * Changes how source and destination colors are combined.
+ *
+ * @param mode Blend equation, e.g. `GL_FUNC_ADD`
+ */
+void StateCache::blendEquation(const GLenum mode) {
+    if (change(_blendEquation, mode)) {
+        glBlendEquation(mode);
+    }
+}
+
+/**
+ * Changes how source and destination colors are weighted.
+ *
+ * @param source Factor for the source color, e.g. `GL_SRC_ALPHA`
+ * @param destination Factor for the destination color, e.g. `GL_ONE_MINUS_SRC_ALPHA`
+ */
+void StateCache::blendFunc(const GLenum source, const GLenum destination) {
+    if (_caching && (_blendSource == source) && (_blendDestination == destination)) {
+        ++_skipped;
+        return;
+    }
+    _blendSource = source;
+    _blendDestination = destination;
+    ++_issued;
+    glBlendFunc(source, destination);
+}
+
+/**
+ * Checks if this cache skips changes and answers queries itself.
+ *
+ * @return `false` if every change and query is passed on to OpenGL
+ */
+bool StateCache::caching() const {
+    return _caching;
+}
+
+/**
+ * Stores a new value unless it is the same as the old one, counting either way.
+ *
+ * @param value Value to change
+ * @param next New value
+ * @return `true` if the value changed and OpenGL must be called
+ */
+bool StateCache::change(GLuint& value, const GLuint next) {
+    if (_caching && (value == next)) {
+        ++_skipped;
+        return false;
+    }
+    value = next;
+    ++_issued;
+    return true;
+}
+
+/**
+ * Makes the keys that store each thread's cache.
+ */
+void StateCache::createKeys() {
+    pthread_key_create(&currentKey, NULL);
+    pthread_key_create(&ownedKey, &destroyOwned);
+}
+
+/**
+ * Returns the cache of the calling thread.
+ *
+ * If the thread was never given a cache with `makeCurrent`, a cache that
+ * passes everything on to OpenGL is made for it the first time, and freed
+ * when the thread exits.
+ *
+ * @return Cache for the context current on the calling thread
+ */
+StateCache& StateCache::current() {
+    pthread_once(&keysOnce, &createKeys);
+    StateCache* cache = (StateCache*) pthread_getspecific(currentKey);
+    if (cache == NULL) {
+        cache = (StateCache*) pthread_getspecific(ownedKey);
+        if (cache == NULL) {
+            cache = new StateCache(false);
+            pthread_setspecific(ownedKey, cache);
+        }
+        pthread_setspecific(currentKey, cache);
+    }
+    return (*cache);
+}
+
+/**
+ * Disables a capability.
+ *
+ * @param capability Capability to disable, e.g. `GL_BLEND`
+ */
+void StateCache::disable(const GLenum capability) {
+    map<GLenum,bool>::iterator it = _capabilities.find(capability);
+    if (_caching && (it != _capabilities.end()) && !it->second) {
+        ++_skipped;
+        return;
+    }
+    _capabilities[capability] = false;
+    ++_issued;
+    glDisable(capability);
+}
+
+/**
+ * Enables a capability.
+ *
+ * @param capability Capability to enable, e.g. `GL_BLEND`
+ */
+void StateCache::enable(const GLenum capability) {
+    map<GLenum,bool>::iterator it = _capabilities.find(capability);
+    if (_caching && (it != _capabilities.end()) && it->second) {
+        ++_skipped;
+        return;
+    }
+    _capabilities[capability] = true;
+    ++_issued;
+    glEnable(capability);
+}
+
+/**
+ * Forgets where a buffer that is being deleted was bound.
+ *
+ * @param buffer Name of the buffer
+ */
+void StateCache::forgetBuffer(const GLuint buffer) {
+    for (map<GLenum,GLuint>::iterator it = _buffers.begin(); it != _buffers.end(); ++it) {
+        if (it->second == buffer) {
+            it->second = UNKNOWN;
+        }
+    }
+}
+
+/**
+ * Forgets where a texture that is being deleted was bound.
+ *
+ * @param texture Name of the texture
+ */
+void StateCache::forgetTexture(const GLuint texture) {
+    typedef map<pair<GLenum,GLenum>,GLuint>::iterator iterator;
+    for (iterator it = _textures.begin(); it != _textures.end(); ++it) {
+        if (it->second == texture) {
+            it->second = UNKNOWN;
+        }
+    }
+}
+
+/**
+ * Forgets a vertex array that is being deleted if it is bound.
+ *
+ * @param array Name of the vertex array
+ */
+void StateCache::forgetVertexArray(const GLuint array) {
+    if (_vertexArray == array) {
+        _vertexArray = UNKNOWN;
+        _buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+/**
+ * Forgets everything, so the next change of each value is made and the next query goes to OpenGL.
+ *
+ * Counters are kept.
+ */
+void StateCache::invalidate() {
+    _activeTexture = UNKNOWN;
+    _blendDestination = UNKNOWN;
+    _blendEquation = UNKNOWN;
+    _blendSource = UNKNOWN;
+    _buffers.clear();
+    _capabilities.clear();
+    _pixelStore.clear();
+    _program = UNKNOWN;
+    _textures.clear();
+    _vertexArray = UNKNOWN;
+    _viewportKnown = false;
+}
+
+/**
+ * Returns the number of changes that were passed on to OpenGL.
+ */
+size_t StateCache::issued() const {
+    return _issued;
+}
+
+/**
+ * Checks if the current context is at least a version of OpenGL.
+ *
+ * The version is asked for every time, since it belongs to the context and
+ * not to the cache.
+ *
+ * @param major Major version needed, e.g. 3 for OpenGL 3.3
+ * @param minor Minor version needed, e.g. 3 for OpenGL 3.3
+ * @return `true` if the context's version is the same or later
+ */
+bool StateCache::isVersionSupported(const GLint major, const GLint minor) {
+    GLint actualMajor = 0, actualMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &actualMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &actualMinor);
+    return (actualMajor > major) || ((actualMajor == major) && (actualMinor >= minor));
+}
+
+/**
+ * Changes the cache of the calling thread, usually along with its context.
+ *
+ * This is how an application opts in to caching, since the cache a thread
+ * has by default passes everything on to OpenGL.
+ *
+ * @param cache Cache for the context being made current, which must outlive its use, or `NULL` to go back to the thread's own
+ */
+void StateCache::makeCurrent(StateCache* const cache) {
+    pthread_once(&keysOnce, &createKeys);
+    pthread_setspecific(currentKey, cache);
+}
+
+/**
+ * Returns a pixel storage setting, only asking OpenGL the first time if caching.
+ *
+ * @param name Setting to return, e.g. `GL_UNPACK_ALIGNMENT`
+ * @return Value of the setting
+ */
+GLint StateCache::pixelStore(const GLenum name) {
+    map<GLenum,GLint>::iterator it = _pixelStore.find(name);
+    if (_caching && (it != _pixelStore.end())) {
+        return it->second;
+    }
+    GLint value;
+    glGetIntegerv(name, &value);
+    ++_queried;
+    _pixelStore[name] = value;
+    return value;
+}
+
+/**
+ * Changes a pixel storage setting.
+ *
+ * @param name Setting to change, e.g. `GL_UNPACK_ALIGNMENT`
+ * @param value New value of the setting
+ */
+void StateCache::pixelStore(const GLenum name, const GLint value) {
+    map<GLenum,GLint>::iterator it = _pixelStore.find(name);
+    if (_caching && (it != _pixelStore.end()) && (it->second == value)) {
+        ++_skipped;
+        return;
+    }
+    _pixelStore[name] = value;
+    ++_issued;
+    glPixelStorei(name, value);
+}
+
+/**
+ * Returns the number of queries that went to OpenGL.
+ */
+size_t StateCache::queried() const {
+    return _queried;
+}
+
+/**
+ * Sets the counters of issued, skipped and queried calls back to zero.
+ */
+void StateCache::resetCounters() {
+    _issued = 0;
+    _queried = 0;
+    _skipped = 0;
+}
+
+/**
+ * Returns the number of changes that were skipped because nothing would change.
+ */
+size_t StateCache::skipped() const {
+    return _skipped;
+}
+
+/**
+ * Makes a program current.
+ *
+ * @param program Name of the program, or zero for none
+ */
+void StateCache::useProgram(const GLuint program) {
+    if (change(_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+/**
+ * Returns the viewport, only asking OpenGL the first time if caching.
+ *
+ * @return Area of the window being rendered to
+ */
+Viewport StateCache::viewport() {
+    if (!_caching || !_viewportKnown) {
+        glGetIntegerv(GL_VIEWPORT, _viewport);
+        ++_queried;
+        _viewportKnown = true;
+    }
+    return Viewport(_viewport[0], _viewport[1], _viewport[2], _viewport[3]);
+}
+
+/**
+ * Changes the viewport.
+ *
+ * @param x Left side of area
+ * @param y Bottom of area
+ * @param width Width of area
+ * @param height Height of area
+ */
+void StateCache::viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
+    if (_caching && _viewportKnown
+            && (_viewport[0] == x) && (_viewport[1] == y)
+            && (_viewport[2] == width) && (_viewport[3] == height)) {
+        ++_skipped;
+        return;
+    }
+    _viewport[0] = x;
+    _viewport[1] = y;
+    _viewport[2] = width;
+    _viewport[3] = height;
+    _viewportKnown = true;
+    ++_issued;
+    glViewport(x, y, width, height);
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,117 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_STATE_CACHE_HXX
+#define GLYCERIN_STATE_CACHE_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <map>
+#include <utility>
+#include "glycerin/Viewport.hxx"
+namespace Glycerin {
+
+
+/**
+ * Shadow copy of OpenGL state that skips changes which would not change anything.
+ *
+ * Binding something that is already bound still costs a trip into the
+ * driver, and asking the driver for state with `glGet` can make it wait for
+ * the GPU.  _StateCache_ remembers what was last set through it, only calls
+ * OpenGL when a value actually changes, and answers queries from what it
+ * remembers.  Nothing is assumed at first, so the first change of each value
+ * is always made, and the first query of each value goes to the driver.
+ *
+ * OpenGL state belongs to a context, so each thread has a current cache,
+ * which the library uses for everything it binds, enables or asks about.
+ * Caching is opt-in.  Unless a thread is given a cache with `makeCurrent`,
+ * its current cache passes every change and query on to OpenGL, so the
+ * library behaves exactly as if it called OpenGL itself.
+ *
+ * ~~~
+ * StateCache state;
+ * StateCache::makeCurrent(&state);
+ * textRenderer.beginRendering(width, height);
+ * ~~~
+ *
+ * A cache cannot see changes made behind its back, so opt in only where
+ * every change to the state it keeps goes through it.  Code that changes the
+ * same state directly, e.g. with `Gloop::Program::use`, must call
+ * `invalidate` before the library draws again, and objects deleted while
+ * bound must be passed to one of the `forget` methods, since OpenGL may hand
+ * out their names again.  An application with several contexts on one
+ * thread should make a cache for each and pass it to `makeCurrent` along
+ * with the context.
+ */
+class StateCache {
+public:
+// Methods
+    explicit StateCache(bool caching = true);
+    virtual ~StateCache();
+    void activeTexture(GLenum unit);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindTexture(GLenum target, GLuint texture);
+    void bindVertexArray(GLuint array);
+    void blendEquation(GLenum mode);
+    void blendFunc(GLenum source, GLenum destination);
+    bool caching() const;
+    static StateCache& current();
+    void disable(GLenum capability);
+    void enable(GLenum capability);
+    void forgetBuffer(GLuint buffer);
+    void forgetTexture(GLuint texture);
+    void forgetVertexArray(GLuint array);
+    void invalidate();
+    size_t issued() const;
+    static bool isVersionSupported(GLint major, GLint minor);
+    static void makeCurrent(StateCache* cache);
+    GLint pixelStore(GLenum name);
+    void pixelStore(GLenum name, GLint value);
+    size_t queried() const;
+    void resetCounters();
+    size_t skipped() const;
+    void useProgram(GLuint program);
+    Viewport viewport();
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+private:
+// Constants
+    static const GLuint UNKNOWN = 0xFFFFFFFF;
+// Attributes
+    GLenum _activeTexture;
+    GLenum _blendDestination;
+    GLenum _blendEquation;
+    GLenum _blendSource;
+    std::map<GLenum,GLuint> _buffers;
+    const bool _caching;
+    std::map<GLenum,bool> _capabilities;
+    size_t _issued;
+    std::map<GLenum,GLint> _pixelStore;
+    GLuint _program;
+    size_t _queried;
+    size_t _skipped;
+    std::map<std::pair<GLenum,GLenum>,GLuint> _textures;
+    GLuint _vertexArray;
+    GLint _viewport[4];
+    bool _viewportKnown;
+// Methods
+    StateCache(const StateCache&);
+    StateCache& operator=(const StateCache&);
+    bool change(GLuint& value, GLuint next);
+    static void createKeys();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,152 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/StateCache.hxx"
+
+
+/**
+ * Test for `StateCache`.
+ */
+class StateCacheTest {
+public:
+
+    /**
+     * Tests that `StateCache` skips changes to values it already has.
+     */
+    void testSkip() {
+        Glycerin::StateCache cache;
+        cache.enable(GL_BLEND);
+        cache.enable(GL_BLEND);
+        cache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        cache.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        cache.bindBuffer(GL_ARRAY_BUFFER, 0);
+        cache.bindBuffer(GL_ARRAY_BUFFER, 0);
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, cache.issued());
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, cache.skipped());
+        CPPUNIT_ASSERT(glIsEnabled(GL_BLEND));
+
+        // Forgetting everything makes the next change go through
+        cache.invalidate();
+        cache.disable(GL_BLEND);
+        CPPUNIT_ASSERT_EQUAL((size_t) 4, cache.issued());
+        CPPUNIT_ASSERT(!glIsEnabled(GL_BLEND));
+    }
+
+    /**
+     * Tests that `StateCache` only asks OpenGL for a value it does not know.
+     */
+    void testQuery() {
+        Glycerin::StateCache cache;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        CPPUNIT_ASSERT_EQUAL(2, cache.pixelStore(GL_UNPACK_ALIGNMENT));
+        CPPUNIT_ASSERT_EQUAL(2, cache.pixelStore(GL_UNPACK_ALIGNMENT));
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.queried());
+        cache.pixelStore(GL_UNPACK_ALIGNMENT, 4);
+        CPPUNIT_ASSERT_EQUAL(4, cache.pixelStore(GL_UNPACK_ALIGNMENT));
+
+        // Setting the viewport means it never has to be asked for
+        cache.viewport(0, 0, 256, 128);
+        const Glycerin::Viewport viewport = cache.viewport();
+        CPPUNIT_ASSERT(viewport == Glycerin::Viewport(0, 0, 256, 128));
+        CPPUNIT_ASSERT_EQUAL((size_t) 1, cache.queried());
+        cache.resetCounters();
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, cache.queried());
+    }
+
+    /**
+     * Tests that `StateCache::current` gives each thread a pass-through cache until another is made current.
+     */
+    void testCurrent() {
+        Glycerin::StateCache& own = Glycerin::StateCache::current();
+        CPPUNIT_ASSERT(&own == &Glycerin::StateCache::current());
+
+        // The thread's own cache passes everything on
+        CPPUNIT_ASSERT(!own.caching());
+        own.resetCounters();
+        own.enable(GL_BLEND);
+        own.enable(GL_BLEND);
+        CPPUNIT_ASSERT_EQUAL((size_t) 2, own.issued());
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, own.skipped());
+
+        Glycerin::StateCache cache;
+        Glycerin::StateCache::makeCurrent(&cache);
+        CPPUNIT_ASSERT(&cache == &Glycerin::StateCache::current());
+        Glycerin::StateCache::makeCurrent(NULL);
+        CPPUNIT_ASSERT(&own == &Glycerin::StateCache::current());
+    }
+
+    /**
+     * Tests `StateCache::isVersionSupported` against the 3.2 context the test asks for.
+     */
+    void testIsVersionSupported() {
+        CPPUNIT_ASSERT(Glycerin::StateCache::isVersionSupported(3, 2));
+        CPPUNIT_ASSERT(Glycerin::StateCache::isVersionSupported(2, 1));
+        CPPUNIT_ASSERT(!Glycerin::StateCache::isVersionSupported(99, 0));
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run tests
+    try {
+        StateCacheTest test;
+        test.testSkip();
+        test.testQuery();
+        test.testCurrent();
+        test.testIsVersionSupported();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
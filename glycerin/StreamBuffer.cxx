@@ -0,0 +1,298 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstring>
+#include <stdexcept>
+#include "glycerin/StateCache.hxx"
+#include "glycerin/StreamBuffer.hxx"
+using namespace std;
+namespace Glycerin {
+
+#if defined(GL_MAP_PERSISTENT_BIT) && !defined(__APPLE__)
+/**
+ * Looks up `glBufferStorage`, which may not be exported by older libraries.
+ *
+ * @return Pointer to `glBufferStorage`, or `NULL` if it could not be found
+ */
+static PFNGLBUFFERSTORAGEPROC getBufferStorage() {
+    static const PFNGLBUFFERSTORAGEPROC function =
+            (PFNGLBUFFERSTORAGEPROC) glXGetProcAddress((const GLubyte*) "glBufferStorage");
+    return function;
+}
+#endif
+
+/**
+ * Constructs a stream buffer, making the buffer and binding it to its target.
+ *
+ * @param target Target the buffer is used with, e.g. `GL_ARRAY_BUFFER`
+ * @param capacity Size of the buffer in bytes
+ * @param persistent Whether to map the buffer persistently if that is supported
+ * @throws invalid_argument if capacity is less than one
+ * @throws runtime_error if the buffer could not be mapped
+ */
+StreamBuffer::StreamBuffer(const GLenum target, const GLsizeiptr capacity, const bool persistent) :
+        _begin(0),
+        _buffer(0),
+        _capacity(0),
+        _head(0),
+        _mapping(NULL),
+        _persistent(false),
+        _target(target) {
+    if (capacity < 1) {
+        throw invalid_argument("[StreamBuffer] Capacity must be positive!");
+    }
+    create(capacity, persistent && isPersistentSupported());
+}
+
+/**
+ * Destroys the stream buffer, deleting the buffer.
+ */
+StreamBuffer::~StreamBuffer() {
+    destroy();
+}
+
+/**
+ * Returns the size of the buffer in bytes.
+ */
+GLsizeiptr StreamBuffer::capacity() const {
+    return _capacity;
+}
+
+/**
+ * Makes the buffer.
+ *
+ * @param capacity Size of the buffer in bytes
+ * @param persistent Whether to map the buffer persistently
+ * @throws runtime_error if the buffer could not be mapped
+ */
+void StreamBuffer::create(const GLsizeiptr capacity, const bool persistent) {
+
+    glGenBuffers(1, &_buffer);
+    StateCache::current().bindBuffer(_target, _buffer);
+    _capacity = capacity;
+    _persistent = persistent;
+    _begin = 0;
+    _head = 0;
+    _mapping = NULL;
+
+    // Allocate storage, mapping it for good if possible
+#if defined(GL_MAP_PERSISTENT_BIT) && !defined(__APPLE__)
+    if (persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        getBufferStorage()(_target, capacity, NULL, flags);
+        _mapping = (GLubyte*) glMapBufferRange(_target, 0, capacity, flags);
+        if (_mapping == NULL) {
+            destroy();
+            throw runtime_error("[StreamBuffer] Could not map buffer!");
+        }
+        return;
+    }
+#endif
+    glBufferData(_target, capacity, NULL, GL_STREAM_DRAW);
+}
+
+/**
+ * Deletes the buffer and any fences still waiting.
+ */
+void StreamBuffer::destroy() {
+    for (deque<Region>::iterator it = _regions.begin(); it != _regions.end(); ++it) {
+        glDeleteSync(it->fence);
+    }
+    _regions.clear();
+    if (_mapping != NULL) {
+        StateCache::current().bindBuffer(_target, _buffer);
+        glUnmapBuffer(_target);
+        _mapping = NULL;
+    }
+    StateCache::current().forgetBuffer(_buffer);
+    glDeleteBuffers(1, &_buffer);
+    _buffer = 0;
+}
+
+/**
+ * Marks everything written since the last fence as in use by the commands issued so far.
+ *
+ * Call this after the draws that read the data.  Without persistent mapping
+ * this does nothing.
+ */
+void StreamBuffer::fence() {
+    if (!_persistent || (_head == _begin)) {
+        return;
+    }
+    const Region region = { _begin, _head, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) };
+    _regions.push_back(region);
+    _begin = _head;
+}
+
+/**
+ * Returns the OpenGL name of the buffer.
+ */
+GLuint StreamBuffer::id() const {
+    return _buffer;
+}
+
+/**
+ * Checks if buffers can be mapped persistently in the current context.
+ *
+ * @return `true` if OpenGL 4.4 or `GL_ARB_buffer_storage` is available
+ */
+bool StreamBuffer::isPersistentSupported() {
+#if defined(GL_MAP_PERSISTENT_BIT) && !defined(__APPLE__)
+    if (getBufferStorage() == NULL) {
+        return false;
+    }
+    if (StateCache::isVersionSupported(4, 4)) {
+        return true;
+    }
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const GLubyte* const name = glGetStringi(GL_EXTENSIONS, i);
+        if ((name != NULL) && (strcmp((const char*) name, "GL_ARB_buffer_storage") == 0)) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+/**
+ * Returns the number of fenced stretches of the ring that have not been waited for yet.
+ */
+size_t StreamBuffer::pending() const {
+    return _regions.size();
+}
+
+/**
+ * Returns `true` if the buffer is mapped persistently.
+ */
+bool StreamBuffer::persistent() const {
+    return _persistent;
+}
+
+/**
+ * Makes sure the buffer can hold a certain amount of data, replacing it with a larger one if needed.
+ *
+ * The new buffer has a new name, so anything pointing at the old one, such
+ * as vertex attribute pointers, must be set up again.
+ *
+ * @param capacity Size in bytes the buffer must have at least
+ * @throws runtime_error if the new buffer could not be mapped
+ */
+void StreamBuffer::reserve(const GLsizeiptr capacity) {
+    if (capacity <= _capacity) {
+        return;
+    }
+    const bool persistent = _persistent;
+    destroy();
+    create(capacity, persistent);
+}
+
+/**
+ * Waits for the GPU to finish with any stretch of the ring overlapping a range.
+ *
+ * After the ring wraps at different points, the oldest stretch may not
+ * overlap the range while newer ones behind it do.  Fences pass in the order
+ * they were put in, so everything up to the last overlapping stretch is
+ * waited on, which costs little for the older ones.
+ *
+ * @param begin Offset of the first byte in the range
+ * @param end Offset after the last byte in the range
+ */
+void StreamBuffer::waitFor(const GLintptr begin, const GLintptr end) {
+
+    // Find the last stretch overlapping the range
+    size_t count = 0;
+    for (size_t i = 0; i < _regions.size(); ++i) {
+        if ((_regions[i].begin < end) && (begin < _regions[i].end)) {
+            count = i + 1;
+        }
+    }
+
+    // Wait for it and everything before it
+    for (; count > 0; --count) {
+        const Region& region = _regions.front();
+        GLenum status = glClientWaitSync(region.fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(region.fence, 0, WAIT_TIMEOUT);
+        }
+        glDeleteSync(region.fence);
+        _regions.pop_front();
+    }
+}
+
+/**
+ * Goes back to the start of the ring.
+ */
+void StreamBuffer::wrap() {
+    if (_persistent) {
+        fence();
+    } else {
+        StateCache::current().bindBuffer(_target, _buffer);
+        glBufferData(_target, _capacity, NULL, GL_STREAM_DRAW);
+    }
+    _begin = 0;
+    _head = 0;
+}
+
+/**
+ * Copies data into the next free part of the buffer.
+ *
+ * @param data Data to copy
+ * @param size Size of the data in bytes
+ * @param alignment Number of bytes the offset should be a multiple of, e.g. the stride of a vertex
+ * @return Offset in bytes where the data was written
+ * @throws invalid_argument if data is `NULL`, size is negative, or alignment is less than one
+ * @throws length_error if the data is larger than the buffer
+ * @throws runtime_error if the buffer could not be mapped
+ */
+GLintptr StreamBuffer::write(const GLvoid* const data, const GLsizeiptr size, const GLsizeiptr alignment) {
+
+    if ((data == NULL) || (size < 0) || (alignment < 1)) {
+        throw invalid_argument("[StreamBuffer] Invalid data, size, or alignment!");
+    } else if (size > _capacity) {
+        throw length_error("[StreamBuffer] Data is larger than the buffer!");
+    }
+
+    // Find room after the last write, going back to the start if needed
+    GLintptr offset = ((_head + alignment - 1) / alignment) * alignment;
+    if (offset + size > _capacity) {
+        wrap();
+        offset = 0;
+    }
+
+    // Copy the data
+    if (_persistent) {
+        waitFor(offset, offset + size);
+        memcpy(_mapping + offset, data, size);
+        StateCache::current().bindBuffer(_target, _buffer);
+    } else if (size > 0) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        StateCache::current().bindBuffer(_target, _buffer);
+        GLvoid* const destination = glMapBufferRange(_target, offset, size, flags);
+        if (destination == NULL) {
+            throw runtime_error("[StreamBuffer] Could not map buffer!");
+        }
+        memcpy(destination, data, size);
+        glUnmapBuffer(_target);
+    }
+    _head = offset + size;
+    return offset;
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,99 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_STREAMBUFFER_HXX
+#define GLYCERIN_STREAMBUFFER_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <deque>
+namespace Glycerin {
+
+
+/**
+ * Buffer for data that changes every frame.
+ *
+ * Overwriting the start of a buffer every frame makes the driver wait until
+ * draws still reading the old contents have finished.  _StreamBuffer_ writes
+ * each piece of data after the last one instead, treating the buffer as a
+ * ring, and returns the offset the data was written at so it can be drawn
+ * from there.
+ *
+ * ~~~
+ * StreamBuffer buffer(GL_ARRAY_BUFFER, 1 << 20);
+ * ...
+ * const GLintptr offset = buffer.write(vertices, size, stride);
+ * glDrawArrays(GL_TRIANGLES, offset / stride, count);
+ * buffer.fence();
+ * ~~~
+ *
+ * When `glBufferStorage` is available the buffer is mapped once, persistently
+ * and coherently, and writing is just a copy.  A fence is put after the draws
+ * that use each stretch of the ring by [fence], and writing only waits when it
+ * catches up with a stretch whose fence has not passed yet.  Without it, each
+ * write maps its range unsynchronized, and the buffer is orphaned whenever
+ * the ring wraps around so nothing in flight is ever overwritten.
+ *
+ * Writing binds the buffer to its target and leaves it bound.  Data larger
+ * than the buffer must be made room for with [reserve] first, which makes a
+ * new buffer with a new [id].
+ *
+ * [fence]: @ref fence() "fence()"
+ * [id]: @ref id() const "id()"
+ * [reserve]: @ref reserve(GLsizeiptr) "reserve(GLsizeiptr)"
+ */
+class StreamBuffer {
+public:
+// Methods
+    StreamBuffer(GLenum target, GLsizeiptr capacity, bool persistent = true);
+    virtual ~StreamBuffer();
+    GLsizeiptr capacity() const;
+    void fence();
+    GLuint id() const;
+    static bool isPersistentSupported();
+    size_t pending() const;
+    bool persistent() const;
+    void reserve(GLsizeiptr capacity);
+    GLintptr write(const GLvoid* data, GLsizeiptr size, GLsizeiptr alignment = 1);
+private:
+// Types
+    struct Region {
+        GLintptr begin;
+        GLintptr end;
+        GLsync fence;
+    };
+// Constants
+    static const GLuint64 WAIT_TIMEOUT = 1000000;
+// Attributes
+    GLintptr _begin;
+    GLuint _buffer;
+    GLsizeiptr _capacity;
+    GLintptr _head;
+    GLubyte* _mapping;
+    bool _persistent;
+    std::deque<Region> _regions;
+    GLenum _target;
+// Methods
+    StreamBuffer(const StreamBuffer&);
+    StreamBuffer& operator=(const StreamBuffer&);
+    void create(GLsizeiptr capacity, bool persistent);
+    void destroy();
+    void waitFor(GLintptr begin, GLintptr end);
+    void wrap();
+};
+
+} /* namespace Glycerin */
+#endif
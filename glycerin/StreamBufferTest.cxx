@@ -0,0 +1,131 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <GL/glfw.h>
+#include "glycerin/StreamBuffer.hxx"
+
+
+/**
+ * Test for `StreamBuffer`.
+ */
+class StreamBufferTest {
+public:
+
+    /**
+     * Tests `StreamBuffer::write` wrapping around the ring, with or without persistent mapping.
+     */
+    void testWrite(const bool persistent) {
+
+        Glycerin::StreamBuffer buffer(GL_ARRAY_BUFFER, 256, persistent);
+        CPPUNIT_ASSERT(buffer.persistent() == (persistent && Glycerin::StreamBuffer::isPersistentSupported()));
+
+        // Write enough to go around the ring a few times
+        GLintptr last = -1;
+        for (int i = 0; i < 20; ++i) {
+            const std::vector<GLubyte> data(50, (GLubyte) i);
+            const GLintptr offset = buffer.write(&data[0], data.size(), 16);
+            CPPUNIT_ASSERT_EQUAL((GLintptr) 0, offset % 16);
+            CPPUNIT_ASSERT((offset + 50) <= 256);
+            CPPUNIT_ASSERT((offset > last) || (offset == 0));
+            buffer.fence();
+            last = offset;
+
+            // Read it back
+            std::vector<GLubyte> actual(50);
+            glFinish();
+            glGetBufferSubData(GL_ARRAY_BUFFER, offset, actual.size(), &actual[0]);
+            CPPUNIT_ASSERT(actual == data);
+        }
+
+        // Make more room
+        buffer.reserve(1024);
+        CPPUNIT_ASSERT_EQUAL((GLsizeiptr) 1024, buffer.capacity());
+        const std::vector<GLubyte> data(1000, 7);
+        CPPUNIT_ASSERT_EQUAL((GLintptr) 0, buffer.write(&data[0], data.size()));
+    }
+
+    /**
+     * Tests `StreamBuffer::write` waiting on every overlapping stretch after wrapping at different points.
+     */
+    void testWriteWithDifferentWraps() {
+
+        Glycerin::StreamBuffer buffer(GL_ARRAY_BUFFER, 300);
+        const GLsizeiptr sizes[] = { 100, 100, 50, 60, 100, 150 };
+        const GLintptr offsets[] = { 0, 100, 200, 0, 60, 0 };
+        const std::vector<GLubyte> data(150, 1);
+        for (int i = 0; i < 6; ++i) {
+            CPPUNIT_ASSERT_EQUAL(offsets[i], buffer.write(&data[0], sizes[i]));
+            if (i < 5) {
+                buffer.fence();
+            }
+        }
+
+        // Stretches from both earlier laps were under the last write
+        CPPUNIT_ASSERT_EQUAL((size_t) 0, buffer.pending());
+    }
+};
+
+int main(int argc, char* argv[]) {
+
+#ifdef __APPLE__
+    // Store working directory before GLFW changes it
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) {
+        throw std::runtime_error("Could not get working directory!");
+    }
+#endif
+
+    // Initialize GLFW
+    if (!glfwInit()) {
+        throw std::runtime_error("Could not initialize GLFW!");
+    }
+
+#ifdef __APPLE__
+    // Reset working directory
+    chdir(cwd);
+#endif
+
+    // Open window
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MAJOR, 3);
+    glfwOpenWindowHint(GLFW_OPENGL_VERSION_MINOR, 2);
+    glfwOpenWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!glfwOpenWindow(512, 512, 0, 0, 0, 0, 0, 0, GLFW_WINDOW)) {
+        throw std::runtime_error("Could not open window!");
+    }
+
+    // Run tests
+    try {
+        StreamBufferTest test;
+        test.testWrite(true);
+        test.testWrite(false);
+        test.testWriteWithDifferentWraps();
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        throw;
+    }
+
+    // Exit
+    glfwTerminate();
+    return 0;
+}
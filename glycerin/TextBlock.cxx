@@ -0,0 +1,81 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include "glycerin/StateCache.hxx"
+#include "glycerin/TextBlock.hxx"
+namespace Glycerin {
+
+/**
+ * Constructs a text block.
+ *
+ * Nothing is made on the GPU until the block is first drawn.
+ *
+ * @param text Text to show, by default empty
+ */
+TextBlock::TextBlock(const std::string& text) :
+        _buffer(0),
+        _count(0),
+        _dirty(true),
+        _instanced(false),
+        _location(-1),
+        _scale(0),
+        _text(text),
+        _vertexArray(0) {
+    // empty
+}
+
+/**
+ * Destroys the text block, deleting its buffer if it was drawn.
+ */
+TextBlock::~TextBlock() {
+    StateCache& state = StateCache::current();
+    if (_vertexArray != 0) {
+        state.forgetVertexArray(_vertexArray);
+        glDeleteVertexArrays(1, &_vertexArray);
+    }
+    if (_buffer != 0) {
+        state.forgetBuffer(_buffer);
+        glDeleteBuffers(1, &_buffer);
+    }
+}
+
+/**
+ * Returns the text shown by the block.
+ */
+const std::string& TextBlock::text() const {
+    return _text;
+}
+
+/**
+ * Changes the text shown by the block.
+ *
+ * The block is only laid out again, the next time it is drawn, if the text
+ * is actually different.
+ *
+ * @param text Text to show
+ * @return Reference to this block to support chaining
+ */
+TextBlock& TextBlock::text(const std::string& text) {
+    if (text != _text) {
+        _text = text;
+        _dirty = true;
+    }
+    return (*this);
+}
+
+}
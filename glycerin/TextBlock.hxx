@@ -0,0 +1,76 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_TEXT_BLOCK_HXX
+#define GLYCERIN_TEXT_BLOCK_HXX
+#include "glycerin/common.h"
+#include <string>
+namespace Glycerin {
+
+
+/**
+ * Text whose geometry is kept on the GPU between frames.
+ *
+ * Text passed to `TextRenderer::draw` as a string is laid out and uploaded
+ * again every frame.  A _TextBlock_ is laid out and uploaded once, the first
+ * time it is drawn, into a buffer it owns.  After that drawing it only sets
+ * where it goes, until its text is changed.
+ *
+ * ~~~
+ * TextBlock label("Temperature");
+ * ...
+ * renderer.beginRendering(width, height);
+ * renderer.draw(label, 10, 10);
+ * renderer.endRendering();
+ * ~~~
+ *
+ * A block remembers the scale, attribute location and instancing mode of
+ * the renderer it was last laid out for.  Drawing it with a renderer that
+ * differs in any of them lays it out and points its vertex array again, so
+ * the same block can be drawn by several renderers, although switching back
+ * and forth every frame costs an upload each time.
+ *
+ * A block belongs to the OpenGL context it was first drawn in, which must
+ * be current when it is destroyed.  It should only be drawn with renderers
+ * in that context.
+ */
+class TextBlock {
+public:
+// Methods
+    explicit TextBlock(const std::string& text = "");
+    virtual ~TextBlock();
+    const std::string& text() const;
+    TextBlock& text(const std::string& text);
+private:
+// Attributes
+    GLuint _buffer;
+    GLsizei _count;
+    bool _dirty;
+    bool _instanced;
+    GLint _location;
+    GLfloat _scale;
+    std::string _text;
+    GLuint _vertexArray;
+// Methods
+    TextBlock(const TextBlock&);
+    TextBlock& operator=(const TextBlock&);
+// Friends
+    friend class TextRenderer;
+};
+
+} /* namespace Glycerin */
+#endif
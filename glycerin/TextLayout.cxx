@@ -0,0 +1,322 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "glycerin/TextLayout.hxx"
+#include "glycerin/Utf8Decoder.hxx"
+using namespace std;
+namespace Glycerin {
+
+/**
+ * Constructs a layout for a monospaced font, with no wrapping or clipping.
+ *
+ * @param advance Distance from the left edge of one character to the next
+ * @param lineHeight Distance from the baseline of one line to the next, also the height of a character
+ * @param descent Distance from the baseline down to the bottom of a character
+ * @throws invalid_argument if advance or line height is not positive
+ */
+TextLayout::TextLayout(const GLfloat advance, const GLfloat lineHeight, const GLfloat descent) :
+        _advance(advance),
+        _alignment(LEFT),
+        _clipBottom(0),
+        _clipped(false),
+        _clipLeft(0),
+        _clipRight(0),
+        _clipTop(0),
+        _descent(descent),
+        _lineHeight(lineHeight),
+        _width(0) {
+    if (!(advance > 0) || !(lineHeight > 0)) {
+        throw invalid_argument("[TextLayout] Advance and line height must be positive!");
+    }
+}
+
+/**
+ * Destroys the layout.
+ */
+TextLayout::~TextLayout() {
+    // empty
+}
+
+/**
+ * Returns the distance from the left edge of one character to the next.
+ */
+GLfloat TextLayout::advance() const {
+    return _advance;
+}
+
+/**
+ * Returns how lines are placed horizontally.
+ */
+TextLayout::Alignment TextLayout::alignment() const {
+    return _alignment;
+}
+
+/**
+ * Changes how lines are placed horizontally.
+ *
+ * With a width, lines are aligned within it.  Without one, the position
+ * passed to `layout` is where lines start, are centered, or end.
+ *
+ * @param alignment `LEFT`, `CENTER` or `RIGHT`
+ * @return Reference to this layout to support chaining
+ */
+TextLayout& TextLayout::alignment(const Alignment alignment) {
+    _alignment = alignment;
+    return (*this);
+}
+
+/**
+ * Drops characters that fall entirely outside a rectangle.
+ *
+ * @param x Position of the left edge of the rectangle
+ * @param y Position of the bottom edge of the rectangle
+ * @param width Size of the rectangle in the X direction
+ * @param height Size of the rectangle in the Y direction
+ * @return Reference to this layout to support chaining
+ * @throws invalid_argument if width or height is negative
+ */
+TextLayout& TextLayout::clip(const GLfloat x, const GLfloat y, const GLfloat width, const GLfloat height) {
+    if ((width < 0) || (height < 0)) {
+        throw invalid_argument("[TextLayout] Clip width and height must not be negative!");
+    }
+    _clipLeft = x;
+    _clipBottom = y;
+    _clipRight = x + width;
+    _clipTop = y + height;
+    _clipped = true;
+    return (*this);
+}
+
+/**
+ * Checks if characters outside a rectangle are dropped.
+ */
+bool TextLayout::clipped() const {
+    return _clipped;
+}
+
+/**
+ * Returns the number of characters that fit in the width, or zero if lines are not wrapped.
+ */
+size_t TextLayout::columns() const {
+    if (_width == 0) {
+        return 0;
+    }
+    return max((size_t) floor(_width / _advance), (size_t) 1);
+}
+
+/**
+ * Returns the distance from the baseline down to the bottom of a character.
+ */
+GLfloat TextLayout::descent() const {
+    return _descent;
+}
+
+/**
+ * Positions the visible characters of some text.
+ *
+ * @param text UTF-8 text to lay out
+ * @param x Location on X axis of the left edge of the text, or its anchor if there is no width
+ * @param y Location on Y axis of the baseline of the first line
+ * @param glyphs Vector to add the visible characters to, which is not cleared first
+ */
+void TextLayout::layout(const std::string& text,
+                        const GLfloat x,
+                        const GLfloat y,
+                        std::vector<Glyph>& glyphs) const {
+
+    vector<GLuint> codePoints;
+    Utf8Decoder::decode(text, codePoints);
+
+    size_t position = 0;
+    Line line;
+    GLfloat baseline = y;
+    while (nextLine(codePoints, position, line)) {
+
+        // Skip lines above the rectangle, and stop at the first one below it
+        const GLfloat bottom = baseline - _descent;
+        if (_clipped) {
+            if (bottom + _lineHeight <= _clipBottom) {
+                break;
+            } else if (bottom >= _clipTop) {
+                baseline -= _lineHeight;
+                continue;
+            }
+        }
+
+        // Find the columns inside the rectangle
+        const size_t length = line.end - line.begin;
+        const GLfloat left = x + offsetOf(length);
+        size_t first = 0;
+        size_t last = length;
+        if (_clipped) {
+            const GLfloat from = floor((_clipLeft - left) / _advance);
+            const GLfloat to = ceil((_clipRight - left) / _advance);
+            first = (from > 0) ? min((size_t) from, length) : 0;
+            last = (to > 0) ? min((size_t) to, length) : 0;
+        }
+
+        // Add everything but spaces
+        for (size_t i = first; i < last; ++i) {
+            const GLuint c = codePoints[line.begin + i];
+            if (c != ' ') {
+                const Glyph glyph = { left + i * _advance, baseline, c };
+                glyphs.push_back(glyph);
+            }
+        }
+        baseline -= _lineHeight;
+    }
+}
+
+/**
+ * Returns the distance from the baseline of one line to the next.
+ */
+GLfloat TextLayout::lineHeight() const {
+    return _lineHeight;
+}
+
+/**
+ * Computes the room some text needs, ignoring the clipping rectangle.
+ *
+ * @param text UTF-8 text to measure
+ * @return Width of the longest line and height of all the lines
+ */
+TextLayout::Size TextLayout::measure(const std::string& text) const {
+    vector<GLuint> codePoints;
+    Utf8Decoder::decode(text, codePoints);
+    size_t position = 0;
+    size_t longest = 0;
+    size_t count = 0;
+    Line line;
+    while (nextLine(codePoints, position, line)) {
+        longest = max(longest, line.end - line.begin);
+        ++count;
+    }
+    const Size size = { longest * _advance, count * _lineHeight };
+    return size;
+}
+
+/**
+ * Finds the next line of some text.
+ *
+ * Wrapped lines lose the spaces they were broken at, and a newline right
+ * after a wrap does not start another, empty line.
+ *
+ * @param text Code points of the text to break into lines
+ * @param position Index of the start of the line, moved to the start of the next one
+ * @param line Line to store the indices of the characters in
+ * @return `true` if there was another line
+ */
+bool TextLayout::nextLine(const std::vector<GLuint>& text, size_t& position, Line& line) const {
+
+    const size_t size = text.size();
+    if ((size == 0) || (position > size)) {
+        return false;
+    }
+
+    // Stop at the newline
+    size_t end = position;
+    while ((end < size) && (text[end] != '\n')) {
+        ++end;
+    }
+    size_t next = end + 1;
+
+    // Wrap at the last space that fits, or in the middle of a word that is too long
+    const size_t columns = this->columns();
+    if ((columns > 0) && (end - position > columns)) {
+        size_t space = position + columns;
+        while ((space > position) && (text[space] != ' ')) {
+            --space;
+        }
+        end = (space > position) ? space : (position + columns);
+        next = end;
+        while ((next < size) && (text[next] == ' ')) {
+            ++next;
+        }
+        if ((next == size) || (text[next] == '\n')) {
+            ++next;
+        }
+        while ((end > position) && (text[end - 1] == ' ')) {
+            --end;
+        }
+    }
+
+    // Leave out the carriage return of a Windows line ending
+    if ((end > position) && (text[end - 1] == '\r')) {
+        --end;
+    }
+
+    line.begin = position;
+    line.end = end;
+    position = next;
+    return true;
+}
+
+/**
+ * Returns the distance from the left of the text to the start of a line.
+ *
+ * @param length Number of characters in the line
+ */
+GLfloat TextLayout::offsetOf(const size_t length) const {
+    switch (_alignment) {
+    case CENTER:
+        return (_width - length * _advance) * 0.5f;
+    case RIGHT:
+        return _width - length * _advance;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Keeps characters outside the clipping rectangle.
+ *
+ * @return Reference to this layout to support chaining
+ */
+TextLayout& TextLayout::unclip() {
+    _clipped = false;
+    return (*this);
+}
+
+/**
+ * Returns the width lines are wrapped to, or zero if they are not wrapped.
+ */
+GLfloat TextLayout::width() const {
+    return _width;
+}
+
+/**
+ * Changes the width lines are wrapped to.
+ *
+ * At least one character is put on every line, however narrow the width.
+ *
+ * @param width Width to wrap lines to, or zero to only break lines at newlines
+ * @return Reference to this layout to support chaining
+ * @throws invalid_argument if width is negative
+ */
+TextLayout& TextLayout::width(const GLfloat width) {
+    if (width < 0) {
+        throw invalid_argument("[TextLayout] Width must not be negative!");
+    }
+    _width = width;
+    return (*this);
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,119 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_TEXT_LAYOUT_HXX
+#define GLYCERIN_TEXT_LAYOUT_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Positions the characters of monospaced text before it is drawn.
+ *
+ * _TextLayout_ breaks text into lines at newlines and, if a width is set,
+ * wraps lines at the last space that fits, breaking words that are wider
+ * than the width on their own.  Each line is aligned to the left, center or
+ * right, and lines go down the screen starting from the baseline passed to
+ * [layout].  Use [measure] to find how much room text needs without
+ * positioning any characters.  Text is UTF-8, and every code point takes up
+ * one column.
+ *
+ * If a clipping rectangle is set, characters that would fall entirely outside
+ * it are dropped before they ever become glyphs, and layout stops at the
+ * first line below the rectangle.  A pane that only shows a few lines of a
+ * long buffer therefore only pays for the lines above and inside it.  Spaces
+ * never become glyphs at all.
+ *
+ * ~~~
+ * TextLayout layout(16, 28, 6);
+ * layout.width(320).alignment(TextLayout::CENTER).clip(0, 0, 640, 480);
+ * std::vector<TextLayout::Glyph> glyphs;
+ * layout.layout(text, 0, 460, glyphs);
+ * ~~~
+ *
+ * [layout]: @ref layout(const std::string&, GLfloat, GLfloat, std::vector<Glyph>&) const "layout"
+ * [measure]: @ref measure(const std::string&) const "measure"
+ */
+class TextLayout {
+public:
+// Types
+    /**
+     * How lines are placed horizontally.
+     */
+    enum Alignment {
+        LEFT,
+        CENTER,
+        RIGHT
+    };
+    /**
+     * Code point positioned by a layout, with its left edge and baseline.
+     */
+    struct Glyph {
+        GLfloat x;
+        GLfloat y;
+        GLuint character;
+    };
+    /**
+     * Extent of laid out text.
+     */
+    struct Size {
+        GLfloat width;
+        GLfloat height;
+    };
+// Methods
+    TextLayout(GLfloat advance, GLfloat lineHeight, GLfloat descent);
+    virtual ~TextLayout();
+    GLfloat advance() const;
+    Alignment alignment() const;
+    TextLayout& alignment(Alignment alignment);
+    TextLayout& clip(GLfloat x, GLfloat y, GLfloat width, GLfloat height);
+    bool clipped() const;
+    GLfloat descent() const;
+    void layout(const std::string& text, GLfloat x, GLfloat y, std::vector<Glyph>& glyphs) const;
+    GLfloat lineHeight() const;
+    Size measure(const std::string& text) const;
+    TextLayout& unclip();
+    GLfloat width() const;
+    TextLayout& width(GLfloat width);
+private:
+// Types
+    struct Line {
+        size_t begin;
+        size_t end;
+    };
+// Attributes
+    GLfloat _advance;
+    Alignment _alignment;
+    GLfloat _clipBottom;
+    bool _clipped;
+    GLfloat _clipLeft;
+    GLfloat _clipRight;
+    GLfloat _clipTop;
+    GLfloat _descent;
+    GLfloat _lineHeight;
+    GLfloat _width;
+// Methods
+    size_t columns() const;
+    bool nextLine(const std::vector<GLuint>& text, size_t& position, Line& line) const;
+    GLfloat offsetOf(size_t length) const;
+};
+
+} /* namespace Glycerin */
+#endif
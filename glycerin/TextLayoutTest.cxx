@@ -0,0 +1,167 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/TextLayout.hxx"
+
+
+/**
+ * Unit test for `TextLayout`.
+ */
+class TextLayoutTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the characters of some glyphs as a string.
+     */
+    static std::string toString(const std::vector<Glycerin::TextLayout::Glyph>& glyphs) {
+        std::string str;
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            str += (char) glyphs[i].character;
+        }
+        return str;
+    }
+
+    /**
+     * Ensures `TextLayout::layout` breaks lines at newlines and moves each one down.
+     */
+    void testLayoutWithNewlines() {
+        const Glycerin::TextLayout layout(10, 20, 5);
+        std::vector<Glycerin::TextLayout::Glyph> glyphs;
+        layout.layout("ab\r\n\nc d", 100, 200, glyphs);
+        CPPUNIT_ASSERT_EQUAL(std::string("abcd"), toString(glyphs));
+        CPPUNIT_ASSERT_EQUAL(100.0f, glyphs[0].x);
+        CPPUNIT_ASSERT_EQUAL(200.0f, glyphs[0].y);
+        CPPUNIT_ASSERT_EQUAL(110.0f, glyphs[1].x);
+        CPPUNIT_ASSERT_EQUAL(100.0f, glyphs[2].x);
+        CPPUNIT_ASSERT_EQUAL(160.0f, glyphs[2].y);
+        CPPUNIT_ASSERT_EQUAL(120.0f, glyphs[3].x);
+    }
+
+    /**
+     * Ensures `TextLayout::layout` gives each code point of UTF-8 text one column.
+     */
+    void testLayoutWithUtf8() {
+        const Glycerin::TextLayout layout(10, 20, 5);
+        std::vector<Glycerin::TextLayout::Glyph> glyphs;
+        layout.layout("caf\xC3\xA9 \xE2\x82\xAC", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL((size_t) 5, glyphs.size());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0xE9, glyphs[3].character);
+        CPPUNIT_ASSERT_EQUAL(30.0f, glyphs[3].x);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0x20AC, glyphs[4].character);
+        CPPUNIT_ASSERT_EQUAL(50.0f, glyphs[4].x);
+        CPPUNIT_ASSERT_EQUAL(60.0f, layout.measure("caf\xC3\xA9 \xE2\x82\xAC").width);
+    }
+
+    /**
+     * Ensures `TextLayout::layout` wraps at spaces and breaks words that do not fit.
+     */
+    void testLayoutWithWidth() {
+        Glycerin::TextLayout layout(10, 20, 5);
+        layout.width(45);
+        std::vector<Glycerin::TextLayout::Glyph> glyphs;
+        layout.layout("ab cd  efghij \nk", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL(std::string("abcdefghijk"), toString(glyphs));
+        const GLfloat xs[] = { 0, 10, 0, 10, 0, 10, 20, 30, 0, 10, 0 };
+        const GLfloat ys[] = { 0, 0, -20, -20, -40, -40, -40, -40, -60, -60, -80 };
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(xs[i], glyphs[i].x);
+            CPPUNIT_ASSERT_EQUAL(ys[i], glyphs[i].y);
+        }
+    }
+
+    /**
+     * Ensures `TextLayout::layout` aligns lines within the width or around the position.
+     */
+    void testLayoutWithAlignment() {
+        Glycerin::TextLayout layout(10, 20, 5);
+        std::vector<Glycerin::TextLayout::Glyph> glyphs;
+        layout.width(100).alignment(Glycerin::TextLayout::CENTER).layout("abcd", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL(30.0f, glyphs[0].x);
+        glyphs.clear();
+        layout.alignment(Glycerin::TextLayout::RIGHT).layout("abcd", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL(60.0f, glyphs[0].x);
+        glyphs.clear();
+        layout.width(0).layout("abcd", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL(-40.0f, glyphs[0].x);
+    }
+
+    /**
+     * Ensures `TextLayout::layout` drops characters and lines outside the clipping rectangle.
+     */
+    void testLayoutWithClip() {
+        Glycerin::TextLayout layout(10, 20, 5);
+        layout.clip(15, -40, 20, 20);
+        std::vector<Glycerin::TextLayout::Glyph> glyphs;
+        layout.layout("abcde\nfghij\nklmno\npqrst", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL(std::string("ghilmn"), toString(glyphs));
+        CPPUNIT_ASSERT_EQUAL(10.0f, glyphs[0].x);
+        CPPUNIT_ASSERT_EQUAL(-20.0f, glyphs[0].y);
+        glyphs.clear();
+        layout.unclip().layout("abcde\nfghij\nklmno\npqrst", 0, 0, glyphs);
+        CPPUNIT_ASSERT_EQUAL((size_t) 20, glyphs.size());
+    }
+
+    /**
+     * Ensures `TextLayout::measure` finds the longest line and counts wrapped lines.
+     */
+    void testMeasure() {
+        Glycerin::TextLayout layout(10, 20, 5);
+        Glycerin::TextLayout::Size size = layout.measure("abc\nabcdefg\n");
+        CPPUNIT_ASSERT_EQUAL(70.0f, size.width);
+        CPPUNIT_ASSERT_EQUAL(60.0f, size.height);
+        size = layout.width(50).measure("abc\nabcdefg\n");
+        CPPUNIT_ASSERT_EQUAL(50.0f, size.width);
+        CPPUNIT_ASSERT_EQUAL(80.0f, size.height);
+        size = layout.measure("");
+        CPPUNIT_ASSERT_EQUAL(0.0f, size.width);
+        CPPUNIT_ASSERT_EQUAL(0.0f, size.height);
+    }
+
+    /**
+     * Ensures `TextLayout` rejects invalid settings.
+     */
+    void testInvalidSettings() {
+        CPPUNIT_ASSERT_THROW(Glycerin::TextLayout(0, 20, 5), std::invalid_argument);
+        Glycerin::TextLayout layout(10, 20, 5);
+        CPPUNIT_ASSERT_THROW(layout.width(-1), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(layout.clip(0, 0, -1, 10), std::invalid_argument);
+    }
+
+    CPPUNIT_TEST_SUITE(TextLayoutTest);
+    CPPUNIT_TEST(testLayoutWithNewlines);
+    CPPUNIT_TEST(testLayoutWithUtf8);
+    CPPUNIT_TEST(testLayoutWithWidth);
+    CPPUNIT_TEST(testLayoutWithAlignment);
+    CPPUNIT_TEST(testLayoutWithClip);
+    CPPUNIT_TEST(testMeasure);
+    CPPUNIT_TEST(testInvalidSettings);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(TextLayoutTest::suite());
+    runner.run();
+    return 0;
+}
@@ -17,11 +17,19 @@
  */
 #include "config.h"
 #include <stdexcept>
+#include <pthread.h>
+#include "glycerin/BitmapCompressor.hxx"
+#include "glycerin/DistanceFieldGenerator.hxx"
+#include "glycerin/Resource.hxx"
+#include "glycerin/StateCache.hxx"
 #include "glycerin/TextRenderer.hxx"
 namespace Glycerin {
 
-// Directories to look for resources in
-const std::vector<std::string> TextRenderer::RESOURCE_DIRECTORIES = createResourceDirectories();
+// Guards the distance field shared by every scaled renderer
+static pthread_mutex_t distanceFieldMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Distance field shared by every scaled renderer, made by the first one and kept for the life of the process
+static CompressedBitmap* sharedDistanceField = NULL;
 
 // Image with font's glyphs
 const std::string TextRenderer::FONT_FILENAME("monospaced-24.bmp");
@@ -32,93 +40,161 @@ const std::string TextRenderer::VERTEX_SHADER_FILENAME("text-renderer.vert");
 // Fragment shader used to render the text
 const std::string TextRenderer::FRAGMENT_SHADER_FILENAME("text-renderer.frag");
 
+// Fragment shader used to render the text from a signed distance field
+const std::string TextRenderer::DISTANCE_FIELD_FRAGMENT_SHADER_FILENAME("text-renderer-sdf.frag");
+
 /**
  * Constructs a `TextRenderer`.
+ *
+ * @param scale Size to draw characters at relative to the font, by default one
+ * @throws invalid_argument if scale is not positive
  */
-TextRenderer::TextRenderer() :
-        bufferObject(Gloop::BufferObject::generate()),
-        arrayBuffer(Gloop::BufferTarget::arrayBuffer()),
-        program(createProgram()),
-        textureObject(createTextureObject()),
-        textureTarget(Gloop::TextureTarget::texture2d()),
+TextRenderer::TextRenderer(const GLfloat scale) :
+        scale(checkScale(scale)),
+        instanced(StateCache::isVersionSupported(3, 3)),
+        streamBuffer(GL_ARRAY_BUFFER, STREAM_BUFFER_CAPACITY),
+        program(createProgram(scale != 1)),
+        reflection(program.id()),
+        characterLocation(reflection.attributeLocation("MCCharacter")),
+        matrixLocation(reflection.uniformLocation("MVPMatrix")),
+        translationLocation(reflection.uniformLocation("Translation")),
+        textureObject(createTextureObject(scale != 1)),
         textureUnit(Gloop::TextureUnit::fromEnum(GL_TEXTURE0)),
-        vertexArrayObject(Gloop::VertexArrayObject::generate()) {
+        vertexArrayObject(Gloop::VertexArrayObject::generate()),
+        glyphTable(createGlyphTable()),
+        viewportWidth(-1),
+        viewportHeight(-1),
+        viewport(CHARACTER_WIDTH * scale, CHARACTER_HEIGHT * scale, DESCENT * scale) {
 
     // Bind
-    vertexArrayObject.bind();
-    arrayBuffer.bind(bufferObject);
-
-    // Fill buffer
-    const BufferLayout layout = BufferLayoutBuilder()
-        .count(6)
-        .components(2)
-        .interleaved(true)
-        .region("MCVertex")
-        .region("TexCoord0")
-        .build();
-    arrayBuffer.data(layout.sizeInBytes(), NULL, GL_STREAM_DRAW);
+    StateCache& state = StateCache::current();
+    state.bindVertexArray(vertexArrayObject.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, streamBuffer.id());
 
     // Set up pointers
-    for (BufferLayout::const_iterator it = layout.begin(); it != layout.end(); ++it) {
-        const GLint location = program.attribLocation(it->name());
-        vertexArrayObject.enableVertexAttribArray(location);
-        vertexArrayObject.vertexAttribPointer(Gloop::VertexAttribPointer()
-                .index(location)
-                .size(it->components())
-                .stride(it->stride())
-                .offset(it->offset()));
-    }
+    setUpPointers(0);
+
+    // Set uniforms that never change, since programs keep them
+    state.useProgram(program.id());
+    glUniform2f(reflection.uniformLocation("CharacterSize"), CHARACTER_WIDTH * scale, CHARACTER_HEIGHT * scale);
+    glUniform1f(reflection.uniformLocation("DeltaS"), DELTA_S);
+    glUniform2f(translationLocation, 0, 0);
 
     // Unbind
-    arrayBuffer.unbind(bufferObject);
-    vertexArrayObject.unbind();
+    state.bindBuffer(GL_ARRAY_BUFFER, 0);
+    state.bindVertexArray(0);
+}
+
+/**
+ * Makes vertex data for some laid out characters.
+ *
+ * @param glyphs Characters to add, with their left edges and baselines
+ * @param vertices Vertex data to add the characters to
+ */
+void TextRenderer::append(const std::vector<TextLayout::Glyph>& glyphs, std::vector<GLfloat>& vertices) const {
+
+    // Make room for every character at once
+    const int copies = instanced ? 1 : VERTICES_PER_CHARACTER;
+    size_t n = vertices.size();
+    vertices.resize(n + glyphs.size() * copies * COMPONENTS_PER_CHARACTER);
+
+    for (std::vector<TextLayout::Glyph>::const_iterator it = glyphs.begin(); it != glyphs.end(); ++it) {
+
+        // Calculate Y position of bottom and look up index in texture
+        const GLfloat y1 = it->y - DESCENT * scale;
+        const GLuint i = glyphTable.find(it->character).index;
+
+        // Add position and index, once per instance or once per vertex
+        for (int j = 0; j < copies; ++j) {
+            vertices[n++] = it->x;
+            vertices[n++] = y1;
+            vertices[n++] = (GLfloat) i;
+        }
+    }
 }
 
 /**
  * Starts rendering.
  *
+ * State is changed through the current [state cache](@ref StateCache), which
+ * only skips changes if the application opted in to caching.
+ *
  * @param width Width of the viewport
  * @param height Height of the viewport
  */
 void TextRenderer::beginRendering(const GLsizei width, const GLsizei height) {
 
     // Enable blending
-    glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);
+    StateCache& state = StateCache::current();
+    state.blendEquation(GL_FUNC_ADD);
+    state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.enable(GL_BLEND);
 
     // Bind texture
-    textureUnit.activate();
-    textureTarget.bind(textureObject);
+    state.activeTexture(textureUnit.toEnum());
+    state.bindTexture(GL_TEXTURE_2D, textureObject.id());
 
     // Use program
-    program.use();
-
-    // Set transformation matrix
-    const M3d::Mat4 mat = Projection::orthographic(width, height);
-    GLfloat arr[16];
-    mat.toArrayInColumnMajor(arr);
-    const GLint location = program.uniformLocation("MVPMatrix");
-    glUniformMatrix4fv(location, 1, false, arr);
+    state.useProgram(program.id());
+
+    // Set transformation matrix and drop text outside the viewport if the size changed
+    if ((width != viewportWidth) || (height != viewportHeight)) {
+        const M3d::Mat4 mat = Projection::orthographic(width, height);
+        GLfloat arr[16];
+        mat.toArrayInColumnMajor(arr);
+        glUniformMatrix4fv(matrixLocation, 1, false, arr);
+        viewport.clip(0, 0, width, height);
+        viewportWidth = width;
+        viewportHeight = height;
+    }
 
     // Bind VAO and VBO
-    vertexArrayObject.bind();
-    arrayBuffer.bind(bufferObject);
+    state.bindVertexArray(vertexArrayObject.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, streamBuffer.id());
+}
+
+/**
+ * Checks a scale before anything is made with it.
+ *
+ * @param scale Size to draw characters at relative to the font
+ * @return The same scale
+ * @throws invalid_argument if scale is not positive
+ */
+GLfloat TextRenderer::checkScale(const GLfloat scale) {
+    if (!(scale > 0)) {
+        throw std::invalid_argument("[TextRenderer] Scale must be positive!");
+    }
+    return scale;
+}
+
+/**
+ * Makes the table of glyphs in the font.
+ *
+ * The font holds the printable ASCII characters on a single page.
+ *
+ * @return Table mapping code points to indices in the font
+ */
+GlyphTable TextRenderer::createGlyphTable() {
+    GlyphTable table;
+    table.add(FIRST_CHARACTER, NUMBER_OF_CHARACTERS, 0, 0);
+    table.fallback(FALLBACK_CHARACTER);
+    return table;
 }
 
 /**
  * Creates the shader program used to render the text.
  *
+ * @param distanceField Whether the font texture holds a signed distance field
  * @return Shader program used to render the text
  */
-Gloop::Program TextRenderer::createProgram() {
+Gloop::Program TextRenderer::createProgram(const bool distanceField) {
 
     // Create shaders
     ShaderFactory shaderFactory;
-    const Gloop::Shader vertexShader = shaderFactory.createShaderFromFile(
-            GL_VERTEX_SHADER, getResource(VERTEX_SHADER_FILENAME));
-    const Gloop::Shader fragmentShader = shaderFactory.createShaderFromFile(
-            GL_FRAGMENT_SHADER, getResource(FRAGMENT_SHADER_FILENAME));
+    const Gloop::Shader vertexShader = shaderFactory.createShaderFromResource(GL_VERTEX_SHADER, VERTEX_SHADER_FILENAME);
+    const Gloop::Shader fragmentShader = shaderFactory.createShaderFromResource(
+            GL_FRAGMENT_SHADER,
+            distanceField ? DISTANCE_FIELD_FRAGMENT_SHADER_FILENAME : FRAGMENT_SHADER_FILENAME);
 
     // Create programs and attach shaders
     const Gloop::Program program = Gloop::Program::create();
@@ -135,33 +211,22 @@ Gloop::Program TextRenderer::createProgram() {
     return program;
 }
 
-/**
- * Creates the list of directories to look for resources in.
- *
- * @return List of directories to look for resources in
- */
-std::vector<std::string> TextRenderer::createResourceDirectories() {
-    std::vector<std::string> directories;
-    directories.push_back(PACKAGE_TARNAME);
-    directories.push_back(DATA_DIR "/" PACKAGE_TARNAME "-" PACKAGE_MAJOR_VERSION_AS_STRING);
-    return directories;
-}
-
 /**
  * Creates the texture holding the font's glyphs.
  *
+ * @param distanceField Whether to use the shared signed distance field of the glyphs
  * @return Handle to the texture holding the font's glyphs
  */
-Gloop::TextureObject TextRenderer::createTextureObject() {
+Gloop::TextureObject TextRenderer::createTextureObject(const bool distanceField) {
 
-    // Read the bitmap into a texture
-    BitmapReader reader;
-    const Bitmap bitmap = reader.read(getResource(FONT_FILENAME));
-    const Gloop::TextureObject textureObject = bitmap.createTexture(false);
+    // Upload the glyphs or their distance field
+    const Gloop::TextureObject textureObject = distanceField
+            ? getDistanceField().createTexture()
+            : readFont().createTexture(false);
 
     // Set the filtering
     const Gloop::TextureTarget texture2d = Gloop::TextureTarget::texture2d();
-    texture2d.bind(textureObject);
+    StateCache::current().bindTexture(GL_TEXTURE_2D, textureObject.id());
     texture2d.minFilter(GL_LINEAR);
     texture2d.magFilter(GL_LINEAR);
 
@@ -170,99 +235,298 @@ Gloop::TextureObject TextRenderer::createTextureObject() {
 }
 
 /**
- * Draws a string of text.
+ * Makes a layout that positions characters the way this renderer draws them.
+ *
+ * @return Layout with no wrapping or clipping, for use with `draw`
+ */
+TextLayout TextRenderer::createLayout() const {
+    return TextLayout(CHARACTER_WIDTH * scale, CHARACTER_HEIGHT * scale, DESCENT * scale);
+}
+
+/**
+ * Draws a string of text, dropping characters outside the viewport.
+ *
+ * The text is only collected here, and is actually drawn by `endRendering`.
+ *
+ * @param text Text to draw, where each newline starts another line below
+ * @param x Location on X axis to draw text
+ * @param y Location on Y axis to draw baseline of text
+ */
+void TextRenderer::draw(const std::string& text, const GLfloat x, const GLfloat y) {
+    draw(text, x, y, viewport);
+}
+
+/**
+ * Draws a string of text with a layout.
+ *
+ * Only the characters the layout keeps are collected, so clipping to the
+ * visible part of a pane saves making vertices for the rest.
  *
  * @param text Text to draw
  * @param x Location on X axis to draw text
+ * @param y Location on Y axis to draw baseline of first line
+ * @param layout Layout from `createLayout`, changed as needed
+ */
+void TextRenderer::draw(const std::string& text, const GLfloat x, const GLfloat y, const TextLayout& layout) {
+    glyphs.clear();
+    layout.layout(text, x, y, glyphs);
+    append(glyphs, vertices);
+}
+
+/**
+ * Draws a text block right away, laying it out first if its text changed.
+ *
+ * @param block Block to draw
+ * @param x Location on X axis to draw text
  * @param y Location on Y axis to draw baseline of text
  */
-void TextRenderer::draw(const std::string& text, GLfloat x, const GLfloat y) {
-
-    // Calculate Y positions and texture coordinates
-    const GLfloat y1 = y - DESCENT;
-    const GLfloat y2 = y1 + CHARACTER_HEIGHT;
-    const GLfloat t1 = 0.0f;
-    const GLfloat t2 = 1.0f;
-
-    for (std::string::const_iterator it = text.begin(); it != text.end(); ++it) {
-
-        // Determine index in texture
-        const int i = (*it) - FIRST_CHARACTER;
-
-        // Calculate X positions and texture coordinates
-        const GLfloat x1 = x;
-        const GLfloat x2 = x + CHARACTER_WIDTH;
-        const GLfloat s1 = DELTA_S * i;
-        const GLfloat s2 = s1 + DELTA_S;
-
-        // Draw rectangle
-        const GLfloat data[] = {
-            x2, y2,
-            s2, t2,
-            x1, y2,
-            s1, t2,
-            x1, y1,
-            s1, t1,
-            x1, y1,
-            s1, t1,
-            x2, y1,
-            s2, t1,
-            x2, y2,
-            s2, t2
-        };
-        arrayBuffer.subData(0, sizeof(data), data);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        // Advance cursor
-        x += CHARACTER_WIDTH;
+void TextRenderer::draw(TextBlock& block, const GLfloat x, const GLfloat y) {
+
+    // Lay out and upload if needed, including for a different renderer
+    if (block._dirty
+            || (block._scale != scale)
+            || (block._location != characterLocation)
+            || (block._instanced != instanced)) {
+        update(block);
+    }
+    if (block._count == 0) {
+        return;
+    }
+
+    // Draw at the location
+    StateCache& state = StateCache::current();
+    glUniform2f(translationLocation, x, y);
+    state.bindVertexArray(block._vertexArray);
+    if (instanced) {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, VERTICES_PER_CHARACTER, block._count);
+    } else {
+        glDrawArrays(GL_TRIANGLES, 0, block._count);
+    }
+
+    // Go back to collecting strings
+    glUniform2f(translationLocation, 0, 0);
+    state.bindVertexArray(vertexArrayObject.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, streamBuffer.id());
+}
+
+/**
+ * Draws a string of text into a sprite batch.
+ *
+ * @param batch Batch to add the characters to, on its current layer and with its current blend mode
+ * @param text Text to draw, where each newline starts another line below
+ * @param x Location on X axis to draw text
+ * @param y Location on Y axis to draw baseline of text
+ * @param color Color to draw text in, white by default
+ */
+void TextRenderer::draw(SpriteBatch& batch,
+                        const std::string& text,
+                        const GLfloat x,
+                        const GLfloat y,
+                        const Color& color) {
+    draw(batch, text, x, y, createLayout(), color);
+}
+
+/**
+ * Draws a string of text into a sprite batch with a layout.
+ *
+ * @param batch Batch to add the characters to, on its current layer and with its current blend mode
+ * @param text Text to draw
+ * @param x Location on X axis to draw text
+ * @param y Location on Y axis to draw baseline of first line
+ * @param layout Layout from `createLayout`, changed as needed
+ * @param color Color to draw text in, white by default
+ */
+void TextRenderer::draw(SpriteBatch& batch,
+                        const std::string& text,
+                        const GLfloat x,
+                        const GLfloat y,
+                        const TextLayout& layout,
+                        const Color& color) {
+
+    glyphs.clear();
+    layout.layout(text, x, y, glyphs);
+
+    // Draw with the batch's shading mode for the font, then put it back
+    const SpriteBatch::Mode mode = batch.mode();
+    batch.mode((scale != 1) ? SpriteBatch::DISTANCE_FIELD : SpriteBatch::COVERAGE);
+    const GLfloat width = CHARACTER_WIDTH * scale;
+    const GLfloat height = CHARACTER_HEIGHT * scale;
+    for (std::vector<TextLayout::Glyph>::const_iterator it = glyphs.begin(); it != glyphs.end(); ++it) {
+        const GLfloat s0 = glyphTable.find(it->character).index * DELTA_S;
+        batch.draw(textureObject, it->x, it->y - DESCENT * scale, width, height, s0, 0, s0 + DELTA_S, 1, color);
+    }
+    batch.mode(mode);
+}
+
+/**
+ * Reads the bitmap holding the font's glyphs.
+ *
+ * @return Bitmap holding the font's glyphs
+ */
+Bitmap TextRenderer::readFont() {
+    BitmapReader reader;
+    const std::string path = Resource::getOverride(FONT_FILENAME);
+    if (!path.empty()) {
+        return reader.read(path);
     }
+    const Resource font = Resource::find(FONT_FILENAME);
+    return reader.readMemory(font.data(), font.size());
 }
 
 /**
- * Finishes rendering.
+ * Finishes rendering, drawing all the text collected since rendering started.
+ *
+ * The texture, program, vertex array and buffer are unbound again.
  */
 void TextRenderer::endRendering() {
-    textureTarget.unbind();
-    glUseProgram(0);
-    vertexArrayObject.unbind();
-    arrayBuffer.unbind(bufferObject);
+    flush();
+    StateCache& state = StateCache::current();
+    state.bindTexture(GL_TEXTURE_2D, 0);
+    state.useProgram(0);
+    state.bindVertexArray(0);
+    state.bindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 /**
- * Checks if a file exists.
+ * Uploads the collected text in one piece and draws it with one call.
  *
- * @param path Path of the file to check for
- * @return `true` if file exists
+ * The stream buffer is replaced with one twice as large whenever the text
+ * does not fit in it.
  */
-bool TextRenderer::exists(const std::string& path) {
-    std::ifstream file(path.c_str());
-    return file;
+void TextRenderer::flush() {
+
+    if (vertices.empty()) {
+        return;
+    }
+
+    // Make room
+    const GLsizeiptr size = vertices.size() * sizeof(GLfloat);
+    if (size > streamBuffer.capacity()) {
+        GLsizeiptr capacity = streamBuffer.capacity();
+        while (capacity < size) {
+            capacity *= 2;
+        }
+        streamBuffer.reserve(capacity);
+        StateCache::current().bindBuffer(GL_ARRAY_BUFFER, streamBuffer.id());
+        setUpPointers(0);
+    }
+
+    // Upload and draw
+    const GLsizeiptr stride = COMPONENTS_PER_CHARACTER * sizeof(GLfloat);
+    const GLsizei count = vertices.size() / COMPONENTS_PER_CHARACTER;
+    if (instanced) {
+        const GLintptr offset = streamBuffer.write(&vertices[0], size, stride);
+        setUpPointers(offset);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, VERTICES_PER_CHARACTER, count);
+    } else {
+        const GLintptr offset = streamBuffer.write(&vertices[0], size, stride * VERTICES_PER_CHARACTER);
+        glDrawArrays(GL_TRIANGLES, offset / stride, count);
+    }
+    streamBuffer.fence();
+    vertices.clear();
 }
 
 /**
- * Finds a resource in one of the resource directories.
+ * Returns the signed distance field of the font, making it the first time.
+ *
+ * The field only depends on the font, so it is made once per process and
+ * shared by every scaled renderer, in every context.  It is kept as a
+ * single channel compressed with BC4, which takes a sixth of the memory of
+ * the font itself.
  *
- * @param name Name of the resource to find
- * @throws std::invalid_argument if name of resource is empty
- * @throws std::runtime_error if could not find resource
+ * @return Distance field of the font's glyphs in `GL_COMPRESSED_RED_RGTC1` format
+ * @throws runtime_error if the font could not be read
  */
-std::string TextRenderer::getResource(const std::string& name) {
+const CompressedBitmap& TextRenderer::getDistanceField() {
+    pthread_mutex_lock(&distanceFieldMutex);
+    try {
+        if (sharedDistanceField == NULL) {
+            const Bitmap field = DistanceFieldGenerator().spread(DISTANCE_FIELD_SPREAD).generate(readFont());
+            BitmapCompressor compressor;
+            compressor.format(BitmapCompressor::BC4).channel(GL_RED);
+            sharedDistanceField = new CompressedBitmap(compressor.compress(field));
+        }
+    } catch (...) {
+        pthread_mutex_unlock(&distanceFieldMutex);
+        throw;
+    }
+    pthread_mutex_unlock(&distanceFieldMutex);
+    return (*sharedDistanceField);
+}
 
-    // Check argument
-    if (name.empty()) {
-        throw std::invalid_argument("[TextRenderer] Name of resource is empty");
+/**
+ * Points the vertex attributes at the stream buffer.
+ *
+ * The vertex array object and the stream buffer must already be bound.
+ *
+ * @param offset Offset in bytes of the first character in the stream buffer
+ */
+void TextRenderer::setUpPointers(const GLintptr offset) const {
+    vertexArrayObject.enableVertexAttribArray(characterLocation);
+    vertexArrayObject.vertexAttribPointer(Gloop::VertexAttribPointer()
+            .index(characterLocation)
+            .size(COMPONENTS_PER_CHARACTER)
+            .stride(COMPONENTS_PER_CHARACTER * sizeof(GLfloat))
+            .offset(offset));
+    if (instanced) {
+        glVertexAttribDivisor(characterLocation, 1);
     }
+}
 
-    // Look for resource in each directory
-    for (int i = 0; i < RESOURCE_DIRECTORIES.size(); ++i) {
-        const std::string path = RESOURCE_DIRECTORIES[i] + '/' + name;
-        if (exists(path)) {
-            return path;
+/**
+ * Lays out a text block and uploads it to a buffer owned by the block.
+ *
+ * @param block Block to lay out
+ */
+void TextRenderer::update(TextBlock& block) const {
+
+    // Lay out at the origin
+    std::vector<TextLayout::Glyph> glyphs;
+    createLayout().layout(block._text, 0, 0, glyphs);
+    std::vector<GLfloat> data;
+    append(glyphs, data);
+    block._count = data.size() / COMPONENTS_PER_CHARACTER;
+    block._dirty = false;
+
+    block._scale = scale;
+
+    // Drop a vertex array pointed by a renderer that differs
+    StateCache& state = StateCache::current();
+    if ((block._vertexArray != 0)
+            && ((block._location != characterLocation) || (block._instanced != instanced))) {
+        state.forgetVertexArray(block._vertexArray);
+        glDeleteVertexArrays(1, &block._vertexArray);
+        block._vertexArray = 0;
+    }
+
+    // Make the buffer and point at it the first time
+    if (block._buffer == 0) {
+        glGenBuffers(1, &block._buffer);
+    }
+    if (block._vertexArray == 0) {
+        glGenVertexArrays(1, &block._vertexArray);
+        state.bindVertexArray(block._vertexArray);
+        state.bindBuffer(GL_ARRAY_BUFFER, block._buffer);
+        glEnableVertexAttribArray(characterLocation);
+        glVertexAttribPointer(characterLocation, COMPONENTS_PER_CHARACTER, GL_FLOAT, GL_FALSE, 0, NULL);
+        if (instanced) {
+            glVertexAttribDivisor(characterLocation, 1);
         }
+        block._location = characterLocation;
+        block._instanced = instanced;
+    } else {
+        state.bindVertexArray(block._vertexArray);
+        state.bindBuffer(GL_ARRAY_BUFFER, block._buffer);
+    }
+
+    // Upload once
+    if (!data.empty()) {
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(GLfloat), &data[0], GL_STATIC_DRAW);
     }
 
-    // Not found
-    throw std::runtime_error("[TextRenderer] Could not find resource!");
+    // Go back to collecting strings
+    state.bindVertexArray(vertexArrayObject.id());
+    state.bindBuffer(GL_ARRAY_BUFFER, streamBuffer.id());
 }
 
 }
@@ -19,8 +19,6 @@
 #define GLYCERIN_TEXT_RENDERER_HXX
 #include <string>
 #include <vector>
-#include <gloop/BufferObject.hxx>
-#include <gloop/BufferTarget.hxx>
 #include <gloop/Program.hxx>
 #include <gloop/TextureObject.hxx>
 #include <gloop/TextureTarget.hxx>
@@ -31,49 +29,122 @@
 #include "glycerin/common.h"
 #include "glycerin/Bitmap.hxx"
 #include "glycerin/BitmapReader.hxx"
-#include "glycerin/BufferLayout.hxx"
-#include "glycerin/BufferLayoutBuilder.hxx"
+#include "glycerin/CompressedBitmap.hxx"
+#include "glycerin/GlyphTable.hxx"
+#include "glycerin/ProgramReflection.hxx"
 #include "glycerin/Projection.hxx"
 #include "glycerin/ShaderFactory.hxx"
+#include "glycerin/SpriteBatch.hxx"
+#include "glycerin/StreamBuffer.hxx"
+#include "glycerin/TextBlock.hxx"
+#include "glycerin/TextLayout.hxx"
 namespace Glycerin {
 
 
 /**
  * Utility for rendering text.
+ *
+ * The font and shaders are compiled into the library, so no files are read
+ * when a renderer is made.  To try out changes to them without rebuilding,
+ * set the `GLYCERIN_RESOURCE_DIR` environment variable to a directory holding
+ * replacements for all of them.
+ *
+ * By default characters are drawn at the size of the font.  To draw them at
+ * another size, pass a scale to the constructor.  The font is then drawn
+ * from a [signed distance field](@ref DistanceFieldGenerator) with a shader
+ * that keeps edges sharp at any scale.  The field is made by the first
+ * scaled renderer and shared by the rest, as a single compressed channel.
+ *
+ * Text drawn between `beginRendering` and `endRendering` is collected on the
+ * CPU and sent to the GPU all at once when rendering ends, with one upload
+ * and one draw call no matter how many strings were drawn.  Uploads go to the
+ * next free part of a [stream buffer](@ref StreamBuffer), so they never wait
+ * for earlier frames to finish drawing.
+ *
+ * Each character is sent as just its position and its index in the font,
+ * and the vertex shader expands it into a quad.  When instanced arrays are
+ * available, as in OpenGL 3.3, each character is one instance.  Otherwise its
+ * position and index are repeated for each of the quad's six vertices.
+ *
+ * Strings are UTF-8.  Characters the font has no glyph for are drawn as a
+ * question mark.  Strings are broken into lines at newlines, and characters that would be
+ * drawn outside the viewport are dropped before any vertices are made for
+ * them.  To wrap, align or clip text further, make a [layout] for the
+ * renderer with `createLayout`, change it, and pass it to `draw`.
+ *
+ * Text that rarely changes can be kept on the GPU in a [text block] instead.
+ * Blocks are drawn as soon as they are passed to `draw`, while strings are
+ * drawn when rendering ends.
+ *
+ * Text can also be drawn into a [sprite batch] along with rectangles and
+ * icons, which also lets it be tinted.  The batch draws it with the rest of
+ * its contents when its own rendering ends, so the renderer does not need to
+ * be rendering itself.
+ *
+ * [layout]: @ref TextLayout "TextLayout"
+ * [text block]: @ref TextBlock "TextBlock"
+ * [sprite batch]: @ref SpriteBatch "SpriteBatch"
  */
 class TextRenderer {
 public:
 // Methods
-    TextRenderer();
+    explicit TextRenderer(GLfloat scale = 1.0f);
     void beginRendering(GLsizei width, GLsizei height);
+    TextLayout createLayout() const;
     void draw(const std::string& text, GLfloat x, GLfloat y);
+    void draw(const std::string& text, GLfloat x, GLfloat y, const TextLayout& layout);
+    void draw(TextBlock& block, GLfloat x, GLfloat y);
+    void draw(SpriteBatch& batch, const std::string& text, GLfloat x, GLfloat y,
+            const Color& color = Color(1, 1, 1, 1));
+    void draw(SpriteBatch& batch, const std::string& text, GLfloat x, GLfloat y, const TextLayout& layout,
+            const Color& color = Color(1, 1, 1, 1));
     void endRendering();
 private:
 // Constants
-    static const std::vector<std::string> RESOURCE_DIRECTORIES;
     static const std::string VERTEX_SHADER_FILENAME;
     static const std::string FRAGMENT_SHADER_FILENAME;
+    static const std::string DISTANCE_FIELD_FRAGMENT_SHADER_FILENAME;
     static const std::string FONT_FILENAME;
-    static const char FIRST_CHARACTER = ' ';
+    static const GLuint FIRST_CHARACTER = ' ';
+    static const GLuint FALLBACK_CHARACTER = '?';
     static const GLint NUMBER_OF_CHARACTERS = 95; 
     static const GLfloat CHARACTER_WIDTH = 16;
     static const GLfloat CHARACTER_HEIGHT = 28;
     static const GLfloat DELTA_S = 1.0f / NUMBER_OF_CHARACTERS;
     static const GLfloat DESCENT = 6;
+    static const int VERTICES_PER_CHARACTER = 6;
+    static const int COMPONENTS_PER_CHARACTER = 3;
+    static const GLsizeiptr STREAM_BUFFER_CAPACITY = 262144;
+    static const GLfloat DISTANCE_FIELD_SPREAD = 4;
 // Attributes
-    const Gloop::BufferObject bufferObject;
-    const Gloop::BufferTarget arrayBuffer;
+    const GLfloat scale;
+    const bool instanced;
+    StreamBuffer streamBuffer;
     const Gloop::Program program;
+    const ProgramReflection reflection;
+    const GLint characterLocation;
+    const GLint matrixLocation;
+    const GLint translationLocation;
     const Gloop::TextureObject textureObject;
     const Gloop::TextureUnit textureUnit;
-    const Gloop::TextureTarget textureTarget;
     const Gloop::VertexArrayObject vertexArrayObject;
+    const GlyphTable glyphTable;
+    GLsizei viewportWidth;
+    GLsizei viewportHeight;
+    TextLayout viewport;
+    std::vector<TextLayout::Glyph> glyphs;
+    std::vector<GLfloat> vertices;
 // Methods
-    static Gloop::Program createProgram();
-    static std::vector<std::string> createResourceDirectories();
-    static Gloop::TextureObject createTextureObject();
-    static bool exists(const std::string& path);
-    static std::string getResource(const std::string& name);
+    void append(const std::vector<TextLayout::Glyph>& glyphs, std::vector<GLfloat>& vertices) const;
+    static GLfloat checkScale(GLfloat scale);
+    static Gloop::Program createProgram(bool distanceField);
+    static GlyphTable createGlyphTable();
+    static Gloop::TextureObject createTextureObject(bool distanceField);
+    void flush();
+    static const CompressedBitmap& getDistanceField();
+    static Bitmap readFont();
+    void setUpPointers(GLintptr offset) const;
+    void update(TextBlock& block) const;
 };
 
 } /* namespace Glycerin */
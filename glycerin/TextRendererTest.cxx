@@ -20,6 +20,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <cppunit/extensions/HelperMacros.h>
 #include <GL/glfw.h>
 #include "glycerin/TextRenderer.hxx"
 
@@ -41,14 +42,38 @@ public:
 
         // Render text
         Glycerin::TextRenderer textRenderer;
+        Glycerin::TextBlock label("Retained label");
         textRenderer.beginRendering(512, 512);
+        textRenderer.draw(label, 10, 480);
+        textRenderer.draw(label.text("Changed label"), 10, 450);
         textRenderer.draw("Hello, World! 12345", 10, 10);
+        for (int i = 1; i < 16; ++i) {
+            textRenderer.draw(std::string(30, (char) ('A' + i)), 10, 10 + i * 30);
+        }
+        Glycerin::TextLayout layout = textRenderer.createLayout();
+        layout.width(200).alignment(Glycerin::TextLayout::RIGHT).clip(300, 300, 200, 100);
+        textRenderer.draw("Wrapped and clipped to a small pane on the right\nsecond paragraph", 300, 390, layout);
         textRenderer.endRendering();
 
+        // Render scaled text
+        Glycerin::TextRenderer largeTextRenderer(2.5f);
+        largeTextRenderer.beginRendering(512, 512);
+        largeTextRenderer.draw("Scaled", 200, 240);
+        largeTextRenderer.draw(label, 200, 180);
+        largeTextRenderer.endRendering();
+
         // Flush and wait
         glfwSwapBuffers();
         glfwSleep(2.0);
     }
+
+    /**
+     * Ensures `TextRenderer` rejects a scale that is not positive.
+     */
+    void testConstructorWithBadScale() {
+        CPPUNIT_ASSERT_THROW(Glycerin::TextRenderer(0.0f), std::invalid_argument);
+        CPPUNIT_ASSERT_THROW(Glycerin::TextRenderer(-1.0f), std::invalid_argument);
+    }
 };
 
 int main(int argc, char* argv[]) {
@@ -82,6 +107,7 @@ int main(int argc, char* argv[]) {
     // Run test
     try {
         TextRendererTest test;
+        test.testConstructorWithBadScale();
         test.testDraw();
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -0,0 +1,150 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "glycerin/Utf8Decoder.hxx"
+using namespace std;
+namespace Glycerin {
+
+/*
+ * Class of each byte when it starts a sequence.
+ *
+ * 0 is invalid, 1 is ASCII, 2 starts two bytes, 3 starts three bytes, 4 is
+ * E0 (no overlong forms), 5 is ED (no surrogates), 6 starts four bytes, 7 is
+ * F0 (no overlong forms) and 8 is F4 (nothing past U+10FFFF).
+ */
+const GLubyte Utf8Decoder::CLASSES[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 00
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 10
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 20
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 30
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 40
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 50
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 60
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 70
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 80
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 90
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // A0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // B0
+    0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  // C0
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  // D0
+    4, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 5, 3, 3,  // E0
+    7, 6, 6, 6, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // F0
+};
+
+// Number of bytes in a sequence of each class
+const GLubyte Utf8Decoder::LENGTHS[9] = { 1, 1, 2, 3, 3, 3, 4, 4, 4 };
+
+// Smallest second byte allowed for each class
+const GLubyte Utf8Decoder::LOWER_BOUNDS[9] = { 0, 0, 0x80, 0x80, 0xA0, 0x80, 0x80, 0x90, 0x80 };
+
+// Largest second byte allowed for each class
+const GLubyte Utf8Decoder::UPPER_BOUNDS[9] = { 0, 0, 0xBF, 0xBF, 0xBF, 0x9F, 0xBF, 0xBF, 0x8F };
+
+// Bits of the lead byte that belong to the code point for each class
+const GLubyte Utf8Decoder::LEAD_MASKS[9] = { 0, 0x7F, 0x1F, 0x0F, 0x0F, 0x0F, 0x07, 0x07, 0x07 };
+
+/**
+ * Adds the code points of some UTF-8 text to a vector.
+ *
+ * @param data Bytes of the text
+ * @param size Number of bytes
+ * @param codePoints Vector to add the code points to, which is not cleared first
+ */
+void Utf8Decoder::decode(const char* data, const size_t size, std::vector<GLuint>& codePoints) {
+
+    // Make room for the most code points there could be
+    const GLubyte* const bytes = (const GLubyte*) data;
+    size_t n = codePoints.size();
+    codePoints.resize(n + size);
+    GLuint* const out = size ? &codePoints[0] : NULL;
+
+    size_t i = 0;
+    while (i < size) {
+
+#ifdef __SSE2__
+        // Widen ASCII sixteen bytes at a time until a byte has its high bit set
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= size) {
+            const __m128i v = _mm_loadu_si128((const __m128i*) (bytes + i));
+            if (_mm_movemask_epi8(v) != 0) {
+                break;
+            }
+            const __m128i low = _mm_unpacklo_epi8(v, zero);
+            const __m128i high = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128((__m128i*) (out + n), _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128((__m128i*) (out + n + 4), _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128((__m128i*) (out + n + 8), _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128((__m128i*) (out + n + 12), _mm_unpackhi_epi16(high, zero));
+            i += 16;
+            n += 16;
+        }
+        if (i == size) {
+            break;
+        }
+#endif
+
+        // Copy ASCII directly
+        const GLubyte lead = bytes[i];
+        if (lead < 0x80) {
+            out[n++] = lead;
+            ++i;
+            continue;
+        }
+
+        // Check the class of the lead byte
+        const int c = CLASSES[lead];
+        if (c == 0) {
+            out[n++] = REPLACEMENT_CHARACTER;
+            ++i;
+            continue;
+        }
+
+        // Add continuation bytes, stopping at the first one out of range
+        const size_t length = LENGTHS[c];
+        GLuint codePoint = lead & LEAD_MASKS[c];
+        size_t j = 1;
+        for (; j < length && i + j < size; ++j) {
+            const GLubyte b = bytes[i + j];
+            const GLubyte lower = (j == 1) ? LOWER_BOUNDS[c] : 0x80;
+            const GLubyte upper = (j == 1) ? UPPER_BOUNDS[c] : 0xBF;
+            if ((b < lower) || (b > upper)) {
+                break;
+            }
+            codePoint = (codePoint << 6) | (b & 0x3F);
+        }
+        out[n++] = (j == length) ? codePoint : REPLACEMENT_CHARACTER;
+        i += j;
+    }
+
+    codePoints.resize(n);
+}
+
+/**
+ * Adds the code points of some UTF-8 text to a vector.
+ *
+ * @param text Text to decode
+ * @param codePoints Vector to add the code points to, which is not cleared first
+ */
+void Utf8Decoder::decode(const std::string& text, std::vector<GLuint>& codePoints) {
+    decode(text.data(), text.size(), codePoints);
+}
+
+} /* namespace Glycerin */
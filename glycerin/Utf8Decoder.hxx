@@ -0,0 +1,63 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_UTF8_DECODER_HXX
+#define GLYCERIN_UTF8_DECODER_HXX
+#include "glycerin/common.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+namespace Glycerin {
+
+
+/**
+ * Utility for turning UTF-8 text into code points.
+ *
+ * Each lead byte is classified with a table that gives the length of its
+ * sequence and the range its second byte must be in, so overlong forms,
+ * surrogates and values past U+10FFFF are rejected without any branching on
+ * the byte itself.  Runs of ASCII are copied sixteen bytes at a time with SSE2
+ * when the compiler allows.
+ *
+ * Invalid or truncated sequences become U+FFFD, one for each lead byte or
+ * stray continuation byte, so decoding never fails.
+ *
+ * ~~~
+ * std::vector<GLuint> codePoints;
+ * Utf8Decoder::decode(text, codePoints);
+ * ~~~
+ */
+class Utf8Decoder {
+public:
+// Constants
+    static const GLuint REPLACEMENT_CHARACTER = 0xFFFD;
+// Methods
+    static void decode(const char* data, size_t size, std::vector<GLuint>& codePoints);
+    static void decode(const std::string& text, std::vector<GLuint>& codePoints);
+private:
+// Constants
+    static const GLubyte CLASSES[256];
+    static const GLubyte LENGTHS[9];
+    static const GLubyte LOWER_BOUNDS[9];
+    static const GLubyte UPPER_BOUNDS[9];
+    static const GLubyte LEAD_MASKS[9];
+// Methods
+    Utf8Decoder();
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/Utf8Decoder.hxx"
+
+
+/**
+ * Unit test for `Utf8Decoder`.
+ */
+class Utf8DecoderTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the code points of some UTF-8 text.
+     */
+    static std::vector<GLuint> decode(const std::string& text) {
+        std::vector<GLuint> codePoints;
+        Glycerin::Utf8Decoder::decode(text, codePoints);
+        return codePoints;
+    }
+
+    /**
+     * Ensures `Utf8Decoder::decode` copies ASCII for every length around the vector width.
+     */
+    void testDecodeAscii() {
+        std::string text;
+        for (int length = 0; length < 40; ++length) {
+            const std::vector<GLuint> codePoints = decode(text);
+            CPPUNIT_ASSERT_EQUAL(text.size(), codePoints.size());
+            for (size_t i = 0; i < text.size(); ++i) {
+                CPPUNIT_ASSERT_EQUAL((GLuint) text[i], codePoints[i]);
+            }
+            text += (char) ('!' + length * 3 % 94);
+        }
+    }
+
+    /**
+     * Ensures `Utf8Decoder::decode` handles sequences of every length, including after a run of ASCII.
+     */
+    void testDecodeMultibyte() {
+        const std::vector<GLuint> codePoints = decode("0123456789abcdefgh\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z");
+        CPPUNIT_ASSERT_EQUAL((size_t) 22, codePoints.size());
+        CPPUNIT_ASSERT_EQUAL((GLuint) 'h', codePoints[17]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0xE9, codePoints[18]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0x20AC, codePoints[19]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 0x1F600, codePoints[20]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 'z', codePoints[21]);
+    }
+
+    /**
+     * Ensures `Utf8Decoder::decode` replaces invalid and truncated sequences.
+     */
+    void testDecodeInvalid() {
+        const GLuint r = Glycerin::Utf8Decoder::REPLACEMENT_CHARACTER;
+
+        // Stray continuation byte, overlong form, surrogate, past U+10FFFF
+        const std::vector<GLuint> a = decode("\x80" "a" "\xC0\xAF" "\xED\xA0\x80" "\xF4\x90\x80\x80");
+        const GLuint expected[] = { r, 'a', r, r, r, r, r, r, r, r, r };
+        CPPUNIT_ASSERT_EQUAL((size_t) 11, a.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(expected[i], a[i]);
+        }
+
+        // Truncated sequences keep the byte that cut them short
+        const std::vector<GLuint> b = decode("\xE2\x82" "b" "\xF0\x9F\x98");
+        CPPUNIT_ASSERT_EQUAL((size_t) 3, b.size());
+        CPPUNIT_ASSERT_EQUAL(r, b[0]);
+        CPPUNIT_ASSERT_EQUAL((GLuint) 'b', b[1]);
+        CPPUNIT_ASSERT_EQUAL(r, b[2]);
+    }
+
+    CPPUNIT_TEST_SUITE(Utf8DecoderTest);
+    CPPUNIT_TEST(testDecodeAscii);
+    CPPUNIT_TEST(testDecodeMultibyte);
+    CPPUNIT_TEST(testDecodeInvalid);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(Utf8DecoderTest::suite());
+    runner.run();
+    return 0;
+}
@@ -38,6 +38,10 @@ Viewport::Viewport(GLint x, GLint y, GLint width, GLint height) : _x(x), _y(y),
 /**
  * Returns the current OpenGL viewport.
  *
+ * OpenGL is asked every time, so changes made with `glViewport` are always
+ * seen.  Code that sets the viewport only through a caching
+ * [state cache](@ref StateCache) can use `StateCache::viewport` instead.
+ *
  * @return Current OpenGL viewport
  */
 Viewport Viewport::getViewport() {
@@ -86,6 +86,10 @@ public:
         const Glycerin::Viewport expected(1, 2, 3, 4);
         const Glycerin::Viewport actual = Glycerin::Viewport::getViewport();
         CPPUNIT_ASSERT_EQUAL(expected, actual);
+
+        // Change it directly and get it again
+        glViewport(5, 6, 7, 8);
+        CPPUNIT_ASSERT_EQUAL(Glycerin::Viewport(5, 6, 7, 8), Glycerin::Viewport::getViewport());
     }
 
     /**
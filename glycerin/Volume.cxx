@@ -17,8 +17,10 @@
  */
 #include "config.h"
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 #include <gloop/TextureTarget.hxx>
+#include "glycerin/StateCache.hxx"
 #include "glycerin/Volume.hxx"
 namespace Glycerin {
 
@@ -39,7 +41,7 @@ Volume::Volume(const Volume& volume) :
         endianness(volume.endianness),
         pitch(volume.pitch),
         size(volume.size),
-        type(type) {
+        type(volume.type) {
     // empty
 }
 
@@ -79,7 +81,7 @@ Gloop::TextureObject Volume::createTexture() const {
 
     // Bind the texture
     const Gloop::TextureTarget texture3d = Gloop::TextureTarget::texture3d();
-    texture3d.bind(texture);
+    StateCache::current().bindTexture(GL_TEXTURE_3D, texture.id());
 
     // Store unpack alignment
     const GLenum lastAlignment = getUnpackAlignment();
@@ -193,15 +195,13 @@ GLenum Volume::getType() const {
 }
 
 /**
- * Returns the current value of `GL_UNPACK_ALIGNMENT`.
+ * Returns the current value of `GL_UNPACK_ALIGNMENT`, from the state cache when it is known.
  *
  * @return Current value of `GL_UNPACK_ALIGNMENT`
  * @see http://www.opengl.org/sdk/docs/man3/xhtml/glGet.xml
  */
 GLenum Volume::getUnpackAlignment() {
-    GLint value;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &value);
-    return (GLenum) value;
+    return (GLenum) StateCache::current().pixelStore(GL_UNPACK_ALIGNMENT);
 }
 
 /**
@@ -239,7 +239,7 @@ bool Volume::isUnpackAlignment(const GLenum enumeration) {
  */
 void Volume::setUnpackAlignment(const GLenum alignment) {
     assert (isUnpackAlignment(alignment));
-    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    StateCache::current().pixelStore(GL_UNPACK_ALIGNMENT, alignment);
 }
 
 /**
@@ -71,7 +71,10 @@ private:
     static void setUnpackAlignment(GLenum unpackAlignment);
     static GLsizei sizeOf(const GLenum type);
 // Friends
+    friend class VolumeFilter;
+    friend class VolumeGenerator;
     friend class VolumeReader;
+    friend class VolumeWriter;
 };
 
 }
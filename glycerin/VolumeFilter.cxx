@@ -0,0 +1,407 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "glycerin/Parallel.hxx"
+#include "glycerin/Simd.hxx"
+#include "glycerin/VolumeFilter.hxx"
+namespace Glycerin {
+
+/**
+ * Samples of a volume converted to floating point.
+ */
+class VolumeFilter::Samples : public Parallel::Task {
+public:
+    Samples(const Volume& volume);
+    void load();
+    void store();
+    virtual void run(size_t begin, size_t end);
+    GLsizei width;
+    GLsizei height;
+    GLsizei depth;
+    std::vector<GLfloat> values;
+private:
+    Samples(const Samples&);
+    Samples& operator=(const Samples&);
+    template <typename T> void load(size_t begin, size_t end);
+    template <typename T> void store(size_t begin, size_t end, T low, T high);
+    GLubyte* data;
+    GLenum type;
+    bool swap;
+    bool storing;
+};
+
+/**
+ * Blurs rows of samples along the X axis.
+ */
+class VolumeFilter::XPass : public Parallel::Task {
+public:
+    XPass(Samples& samples, const std::vector<GLfloat>& kernel) : samples(samples), kernel(kernel) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    Samples& samples;
+    const std::vector<GLfloat>& kernel;
+};
+
+/**
+ * Blurs slices of samples along the Y axis.
+ */
+class VolumeFilter::YPass : public Parallel::Task {
+public:
+    YPass(Samples& samples, const std::vector<GLfloat>& kernel) : samples(samples), kernel(kernel) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    Samples& samples;
+    const std::vector<GLfloat>& kernel;
+};
+
+/**
+ * Blurs samples along the Z axis, one XZ plane at a time.
+ */
+class VolumeFilter::ZPass : public Parallel::Task {
+public:
+    ZPass(Samples& samples, const std::vector<GLfloat>& kernel) : samples(samples), kernel(kernel) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    Samples& samples;
+    const std::vector<GLfloat>& kernel;
+};
+
+/**
+ * Replaces slices of samples with the median of their 3x3x3 neighborhoods.
+ */
+class VolumeFilter::MedianPass : public Parallel::Task {
+public:
+    MedianPass(const Samples& samples, std::vector<GLfloat>& result) : samples(samples), result(result) { }
+    virtual void run(size_t begin, size_t end);
+private:
+    const Samples& samples;
+    std::vector<GLfloat>& result;
+};
+
+/**
+ * Constructs a `VolumeFilter`.
+ */
+VolumeFilter::VolumeFilter() {
+    // empty
+}
+
+/**
+ * Computes the weights of a normalized one-dimensional Gaussian kernel.
+ *
+ * @param sigma Standard deviation of the kernel, in samples
+ * @return Weights of the kernel, with the center in the middle
+ * @throws std::invalid_argument if sigma is not positive
+ */
+std::vector<GLfloat> VolumeFilter::createKernel(const GLfloat sigma) {
+
+    if (!(sigma > 0)) {
+        throw std::invalid_argument("[VolumeFilter] Sigma must be positive!");
+    }
+
+    // Compute the weights out to three standard deviations
+    const int radius = std::max(1, (int) ceil(3 * sigma));
+    std::vector<GLfloat> kernel(2 * radius + 1);
+    double sum = 0;
+    for (int i = -radius; i <= radius; ++i) {
+        const double weight = exp(-(i * i) / (2.0 * sigma * sigma));
+        kernel[i + radius] = (GLfloat) weight;
+        sum += weight;
+    }
+
+    // Normalize them
+    for (size_t i = 0; i < kernel.size(); ++i) {
+        kernel[i] = (GLfloat) (kernel[i] / sum);
+    }
+    return kernel;
+}
+
+/**
+ * Makes a smoothed copy of a volume using a Gaussian blur.
+ *
+ * @param volume Volume to smooth
+ * @param sigma Standard deviation of the blur, in samples
+ * @return Smoothed copy of the volume
+ * @throws std::invalid_argument if volume has no data or sigma is not positive
+ */
+Volume VolumeFilter::gaussian(const Volume& volume, const GLfloat sigma) {
+    Volume copy(volume);
+    gaussianInPlace(copy, sigma);
+    return copy;
+}
+
+/**
+ * Smooths a volume using a Gaussian blur.
+ *
+ * The blur is separated into one pass along each axis.  Every pass works on
+ * whole rows of samples at a time, so the inner loop always runs along the X
+ * axis where the samples are contiguous.
+ *
+ * @param volume Volume to smooth
+ * @param sigma Standard deviation of the blur, in samples
+ * @throws std::invalid_argument if volume has no data or sigma is not positive
+ */
+void VolumeFilter::gaussianInPlace(Volume& volume, const GLfloat sigma) {
+
+    // Make the kernel and convert the samples
+    const std::vector<GLfloat> kernel = createKernel(sigma);
+    Samples samples(volume);
+    samples.load();
+
+    // Blur along each axis
+    XPass xPass(samples, kernel);
+    Parallel::forEach(((size_t) samples.height) * samples.depth, xPass, 64);
+    YPass yPass(samples, kernel);
+    Parallel::forEach(samples.depth, yPass);
+    ZPass zPass(samples, kernel);
+    Parallel::forEach(samples.height, zPass);
+
+    // Convert back
+    samples.store();
+}
+
+/**
+ * Checks if an endianness matches the byte order of this machine.
+ *
+ * @param endianness Either _big_ or _little_
+ * @return `true` if endianness matches the byte order of this machine
+ */
+bool VolumeFilter::isHostEndianness(const std::string& endianness) {
+    const GLushort one = 1;
+    const bool little = *((const GLubyte*) &one) == 1;
+    return little ? (endianness != "big") : (endianness != "little");
+}
+
+/**
+ * Makes a denoised copy of a volume using a 3x3x3 median filter.
+ *
+ * @param volume Volume to denoise
+ * @return Denoised copy of the volume
+ * @throws std::invalid_argument if volume has no data
+ */
+Volume VolumeFilter::median(const Volume& volume) {
+    Volume copy(volume);
+    medianInPlace(copy);
+    return copy;
+}
+
+/**
+ * Denoises a volume using a 3x3x3 median filter.
+ *
+ * @param volume Volume to denoise
+ * @throws std::invalid_argument if volume has no data
+ */
+void VolumeFilter::medianInPlace(Volume& volume) {
+
+    // Convert the samples
+    Samples samples(volume);
+    samples.load();
+
+    // Filter into a second buffer, since every sample depends on its neighbors
+    std::vector<GLfloat> result(samples.values.size());
+    MedianPass medianPass(samples, result);
+    Parallel::forEach(samples.depth, medianPass);
+
+    // Convert back
+    samples.values.swap(result);
+    samples.store();
+}
+
+// HELPERS
+
+VolumeFilter::Samples::Samples(const Volume& volume) :
+        width(volume.size.width),
+        height(volume.size.height),
+        depth(volume.size.depth),
+        data(volume.data),
+        type(volume.type),
+        swap(!isHostEndianness(volume.endianness)),
+        storing(false) {
+    if (data == NULL) {
+        throw std::invalid_argument("[VolumeFilter] Volume has no data!");
+    }
+}
+
+void VolumeFilter::Samples::load() {
+    values.resize(((size_t) width) * height * depth);
+    storing = false;
+    Parallel::forEach(depth, *this);
+}
+
+void VolumeFilter::Samples::store() {
+    storing = true;
+    Parallel::forEach(depth, *this);
+}
+
+void VolumeFilter::Samples::run(const size_t begin, const size_t end) {
+    const size_t first = begin * width * height;
+    const size_t last = end * width * height;
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+        storing ? store<GLubyte>(first, last, 0, 255) : load<GLubyte>(first, last);
+        break;
+    case GL_SHORT:
+        storing ? store<GLshort>(first, last, -32768, 32767) : load<GLshort>(first, last);
+        break;
+    case GL_UNSIGNED_SHORT:
+        storing ? store<GLushort>(first, last, 0, 65535) : load<GLushort>(first, last);
+        break;
+    case GL_FLOAT:
+        storing ? store<GLfloat>(first, last, -HUGE_VALF, HUGE_VALF) : load<GLfloat>(first, last);
+        break;
+    }
+}
+
+template <typename T>
+void VolumeFilter::Samples::load(const size_t begin, const size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        T value;
+        GLubyte* const bytes = (GLubyte*) &value;
+        memcpy(bytes, data + i * sizeof(T), sizeof(T));
+        if (swap) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        values[i] = (GLfloat) value;
+    }
+}
+
+template <typename T>
+void VolumeFilter::Samples::store(const size_t begin, const size_t end, const T low, const T high) {
+    const bool integral = (((T) 0.5f) == 0);
+    for (size_t i = begin; i < end; ++i) {
+        const GLfloat rounded = integral ? floor(values[i] + 0.5f) : values[i];
+        T value = (T) std::min((GLfloat) high, std::max((GLfloat) low, rounded));
+        GLubyte* const bytes = (GLubyte*) &value;
+        if (swap) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        memcpy(data + i * sizeof(T), bytes, sizeof(T));
+    }
+}
+
+void VolumeFilter::XPass::run(const size_t begin, const size_t end) {
+
+    const size_t width = samples.width;
+    const size_t radius = kernel.size() / 2;
+    std::vector<GLfloat> padded(width + 2 * radius);
+
+    for (size_t r = begin; r < end; ++r) {
+
+        // Copy the row, repeating the samples on either end
+        GLfloat* const row = &samples.values[r * width];
+        std::fill(padded.begin(), padded.begin() + radius, row[0]);
+        std::copy(row, row + width, padded.begin() + radius);
+        std::fill(padded.begin() + radius + width, padded.end(), row[width - 1]);
+
+        // Sum shifted copies of it
+        std::fill(row, row + width, 0.0f);
+        for (size_t k = 0; k < kernel.size(); ++k) {
+            Simd::accumulate(width, kernel[k], &padded[k], row);
+        }
+    }
+}
+
+void VolumeFilter::YPass::run(const size_t begin, const size_t end) {
+
+    const int width = samples.width;
+    const int height = samples.height;
+    const int radius = kernel.size() / 2;
+    std::vector<GLfloat> slice(((size_t) width) * height);
+
+    for (size_t z = begin; z < end; ++z) {
+
+        // Copy the slice
+        GLfloat* const first = &samples.values[z * width * height];
+        std::copy(first, first + slice.size(), slice.begin());
+
+        // Make each row a weighted sum of its neighboring rows
+        for (int y = 0; y < height; ++y) {
+            GLfloat* const row = first + ((size_t) y) * width;
+            std::fill(row, row + width, 0.0f);
+            for (int k = -radius; k <= radius; ++k) {
+                const int j = std::min(height - 1, std::max(0, y + k));
+                Simd::accumulate(width, kernel[k + radius], &slice[((size_t) j) * width], row);
+            }
+        }
+    }
+}
+
+void VolumeFilter::ZPass::run(const size_t begin, const size_t end) {
+
+    const size_t width = samples.width;
+    const size_t height = samples.height;
+    const int depth = samples.depth;
+    const int radius = kernel.size() / 2;
+    std::vector<GLfloat> plane(width * depth);
+
+    for (size_t y = begin; y < end; ++y) {
+
+        // Gather the rows at this height from every slice
+        for (int z = 0; z < depth; ++z) {
+            const GLfloat* const row = &samples.values[(z * height + y) * width];
+            std::copy(row, row + width, plane.begin() + z * width);
+        }
+
+        // Make each row a weighted sum of the same row in neighboring slices
+        for (int z = 0; z < depth; ++z) {
+            GLfloat* const row = &samples.values[(z * height + y) * width];
+            std::fill(row, row + width, 0.0f);
+            for (int k = -radius; k <= radius; ++k) {
+                const int j = std::min(depth - 1, std::max(0, z + k));
+                Simd::accumulate(width, kernel[k + radius], &plane[j * width], row);
+            }
+        }
+    }
+}
+
+void VolumeFilter::MedianPass::run(const size_t begin, const size_t end) {
+
+    const int width = samples.width;
+    const int height = samples.height;
+    const int depth = samples.depth;
+    const std::vector<GLfloat>& values = samples.values;
+    GLfloat neighborhood[27];
+
+    for (int z = begin; z < (int) end; ++z) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+
+                // Gather the neighbors, clamping to the border
+                int n = 0;
+                for (int k = z - 1; k <= z + 1; ++k) {
+                    const size_t slice = std::min(depth - 1, std::max(0, k));
+                    for (int j = y - 1; j <= y + 1; ++j) {
+                        const size_t row = (slice * height + std::min(height - 1, std::max(0, j))) * width;
+                        for (int i = x - 1; i <= x + 1; ++i) {
+                            neighborhood[n++] = values[row + std::min(width - 1, std::max(0, i))];
+                        }
+                    }
+                }
+
+                // Select the middle one
+                std::nth_element(neighborhood, neighborhood + 13, neighborhood + 27);
+                result[(((size_t) z) * height + y) * width + x] = neighborhood[13];
+            }
+        }
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,79 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_VOLUME_FILTER_HXX
+#define GLYCERIN_VOLUME_FILTER_HXX
+#include <vector>
+#include "glycerin/common.h"
+#include "glycerin/Volume.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for smoothing and denoising volumes.
+ *
+ * _VolumeFilter_ offers a separable Gaussian blur and a 3x3x3 median filter.
+ * Both work on any type a [volume] can hold, and both split their work across
+ * all available processors.  Samples outside the volume are treated as
+ * copies of the nearest sample on the border.
+ *
+ * To filter into a new volume, pass the original volume to [gaussian] or
+ * [median].
+ *
+ * ~~~
+ * VolumeReader reader;
+ * const Volume volume = reader.read("bunny.vlb");
+ * VolumeFilter filter;
+ * const Volume smoothed = filter.gaussian(volume, 1.5f);
+ * ~~~
+ *
+ * To avoid the copy, filter the volume in place with [gaussian-in-place] or
+ * [median-in-place] instead.
+ *
+ * ~~~
+ * Volume volume = reader.read("bunny.vlb");
+ * filter.medianInPlace(volume);
+ * ~~~
+ *
+ * [gaussian]: @ref gaussian(const Volume&, GLfloat) "gaussian(const Volume&, GLfloat)"
+ * [gaussian-in-place]: @ref gaussianInPlace(Volume&, GLfloat) "gaussianInPlace(Volume&, GLfloat)"
+ * [median]: @ref median(const Volume&) "median(const Volume&)"
+ * [median-in-place]: @ref medianInPlace(Volume&) "medianInPlace(Volume&)"
+ * [volume]: @ref Volume "Volume"
+ */
+class VolumeFilter {
+public:
+// Methods
+    VolumeFilter();
+    Volume gaussian(const Volume& volume, GLfloat sigma);
+    void gaussianInPlace(Volume& volume, GLfloat sigma);
+    Volume median(const Volume& volume);
+    void medianInPlace(Volume& volume);
+private:
+// Types
+    class Samples;
+    class XPass;
+    class YPass;
+    class ZPass;
+    class MedianPass;
+// Methods
+    static std::vector<GLfloat> createKernel(GLfloat sigma);
+    static bool isHostEndianness(const std::string& endianness);
+};
+
+} /* namespace Glycerin */
+#endif
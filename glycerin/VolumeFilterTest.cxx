@@ -0,0 +1,150 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/Volume.hxx"
+#include "glycerin/VolumeFilter.hxx"
+#include "glycerin/VolumeReader.hxx"
+
+
+/**
+ * Unit test for `VolumeFilter`.
+ */
+class VolumeFilterTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the samples of a volume.
+     */
+    static std::vector<GLubyte> getData(const Glycerin::Volume& volume) {
+        std::vector<GLubyte> data(volume.getLength());
+        volume.getData(&data[0]);
+        return data;
+    }
+
+    /**
+     * Returns the sum of the differences between neighboring samples along X.
+     */
+    static long getVariation(const Glycerin::Volume& volume) {
+        const std::vector<GLubyte> data = getData(volume);
+        long variation = 0;
+        for (size_t i = 1; i < data.size(); ++i) {
+            if ((i % volume.getWidth()) != 0) {
+                variation += abs(data[i] - data[i - 1]);
+            }
+        }
+        return variation;
+    }
+
+    /**
+     * Reads the volume used for testing.
+     */
+    static Glycerin::Volume readVolume() {
+        Glycerin::VolumeReader reader;
+        return reader.read("glycerin/bunny.vlb");
+    }
+
+    /**
+     * Ensures `VolumeFilter::gaussian` keeps the size and type of the volume.
+     */
+    void testGaussianKeepsSizeAndType() {
+        const Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        const Glycerin::Volume result = filter.gaussian(volume, 1.0f);
+        CPPUNIT_ASSERT_EQUAL(volume.getWidth(), result.getWidth());
+        CPPUNIT_ASSERT_EQUAL(volume.getHeight(), result.getHeight());
+        CPPUNIT_ASSERT_EQUAL(volume.getDepth(), result.getDepth());
+        CPPUNIT_ASSERT_EQUAL(volume.getType(), result.getType());
+    }
+
+    /**
+     * Ensures `VolumeFilter::gaussian` smooths the volume.
+     */
+    void testGaussianSmooths() {
+        const Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        const Glycerin::Volume result = filter.gaussian(volume, 1.0f);
+        CPPUNIT_ASSERT(getVariation(result) < getVariation(volume));
+    }
+
+    /**
+     * Ensures `VolumeFilter::gaussianInPlace` gives the same result as `VolumeFilter::gaussian`.
+     */
+    void testGaussianInPlace() {
+        Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        const Glycerin::Volume expected = filter.gaussian(volume, 1.5f);
+        filter.gaussianInPlace(volume, 1.5f);
+        CPPUNIT_ASSERT(getData(expected) == getData(volume));
+    }
+
+    /**
+     * Ensures `VolumeFilter::gaussian` throws if sigma is zero.
+     */
+    void testGaussianWithZeroSigma() {
+        const Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        CPPUNIT_ASSERT_THROW(filter.gaussian(volume, 0.0f), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `VolumeFilter::median` keeps the size and type of the volume and reduces noise.
+     */
+    void testMedian() {
+        const Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        const Glycerin::Volume result = filter.median(volume);
+        CPPUNIT_ASSERT_EQUAL(volume.getWidth(), result.getWidth());
+        CPPUNIT_ASSERT_EQUAL(volume.getHeight(), result.getHeight());
+        CPPUNIT_ASSERT_EQUAL(volume.getDepth(), result.getDepth());
+        CPPUNIT_ASSERT_EQUAL(volume.getType(), result.getType());
+        CPPUNIT_ASSERT(getVariation(result) < getVariation(volume));
+    }
+
+    /**
+     * Ensures `VolumeFilter::medianInPlace` gives the same result as `VolumeFilter::median`.
+     */
+    void testMedianInPlace() {
+        Glycerin::Volume volume = readVolume();
+        Glycerin::VolumeFilter filter;
+        const Glycerin::Volume expected = filter.median(volume);
+        filter.medianInPlace(volume);
+        CPPUNIT_ASSERT(getData(expected) == getData(volume));
+    }
+
+    CPPUNIT_TEST_SUITE(VolumeFilterTest);
+    CPPUNIT_TEST(testGaussianKeepsSizeAndType);
+    CPPUNIT_TEST(testGaussianSmooths);
+    CPPUNIT_TEST(testGaussianInPlace);
+    CPPUNIT_TEST(testGaussianWithZeroSigma);
+    CPPUNIT_TEST(testMedian);
+    CPPUNIT_TEST(testMedianInPlace);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(VolumeFilterTest::suite());
+    runner.run();
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "glycerin/Noise.hxx"
+#include "glycerin/Parallel.hxx"
+#include "glycerin/VolumeGenerator.hxx"
+#include "glycerin/VolumeWriter.hxx"
+namespace Glycerin {
+
+/**
+ * Generates a range of rows into memory.
+ */
+class VolumeGenerator::RowTask : public Parallel::Task {
+public:
+    RowTask(const VolumeGenerator& generator, size_t first, GLubyte* dst) :
+            generator(generator), first(first), dst(dst) { }
+    virtual void run(size_t begin, size_t end) {
+        const size_t rowSize = ((size_t) generator._size.width) * sizeOf(generator._type);
+        for (size_t i = begin; i < end; ++i) {
+            generator.generateRow(first + i, dst + i * rowSize);
+        }
+    }
+private:
+    const VolumeGenerator& generator;
+    const size_t first;
+    GLubyte* const dst;
+};
+
+/**
+ * Constructs a `VolumeGenerator` with default settings.
+ */
+VolumeGenerator::VolumeGenerator() :
+        _cellSize(DEFAULT_CELL_SIZE),
+        _pattern(NOISE),
+        _seed(0),
+        _type(DEFAULT_TYPE) {
+    _size.width = DEFAULT_SIZE;
+    _size.height = DEFAULT_SIZE;
+    _size.depth = DEFAULT_SIZE;
+}
+
+/**
+ * Changes the size of the cubes in the checkerboard pattern.
+ *
+ * @param cellSize Number of samples along each edge of a cube
+ * @return Reference to this generator to support chaining
+ * @throws std::invalid_argument if cell size is less than one
+ */
+VolumeGenerator& VolumeGenerator::cellSize(const GLsizei cellSize) {
+    if (cellSize < 1) {
+        throw std::invalid_argument("[VolumeGenerator] Cell size is less than one!");
+    }
+    _cellSize = cellSize;
+    return (*this);
+}
+
+/**
+ * Computes the number of bytes in a number of slices, without overflowing.
+ *
+ * @param depth Number of slices
+ * @return Number of bytes in that many slices
+ * @throws std::length_error if the bytes could not be counted by a `GLsizei`
+ */
+size_t VolumeGenerator::computeLength(const GLsizei depth) const {
+    const size_t maximum = std::numeric_limits<GLsizei>::max();
+    size_t len = sizeOf(_type);
+    const GLsizei dimensions[] = { _size.width, _size.height, depth };
+    for (int i = 0; i < 3; ++i) {
+        if ((size_t) dimensions[i] > maximum / len) {
+            throw std::length_error("[VolumeGenerator] Volume is too large to hold in memory!");
+        }
+        len *= dimensions[i];
+    }
+    return len;
+}
+
+/**
+ * Makes a volume in memory using the current settings.
+ *
+ * @return Volume that was generated
+ * @throws std::length_error if volume would be too large to hold in memory
+ */
+Volume VolumeGenerator::generate() const {
+
+    // Check the length
+    const size_t rows = ((size_t) _size.height) * _size.depth;
+    const size_t len = computeLength(_size.depth);
+
+    // Make the volume
+    Volume volume;
+    volume.size = _size;
+    volume.type = _type;
+    volume.pitch.x = 1;
+    volume.pitch.y = 1;
+    volume.pitch.z = 1;
+    volume.endianness = VolumeWriter::getHostEndianness();
+    volume.data = new GLubyte[len];
+
+    // Fill in the samples
+    RowTask task(*this, 0, volume.data);
+    Parallel::forEach(rows, task, 16);
+    return volume;
+}
+
+/**
+ * Computes the samples for one row.
+ *
+ * @param row Index of the row, counting up in Y and then Z
+ * @param dst Memory to store the samples in
+ */
+void VolumeGenerator::generateRow(const size_t row, GLubyte* const dst) const {
+
+    const GLsizei width = _size.width;
+    const GLsizei y = row % _size.height;
+    const GLsizei z = row / _size.height;
+    std::vector<GLfloat> values(width);
+
+    switch (_pattern) {
+    case CHECKERBOARD: {
+        const GLsizei parity = (y / _cellSize) + (z / _cellSize);
+        for (GLsizei x = 0; x < width; ++x) {
+            values[x] = (((x / _cellSize) + parity) % 2) ? 1.0f : 0.0f;
+        }
+        break;
+    }
+    case GRADIENT: {
+        const GLfloat dy = (_size.height > 1) ? (((GLfloat) y) / (_size.height - 1)) : 0;
+        const GLfloat dz = (_size.depth > 1) ? (((GLfloat) z) / (_size.depth - 1)) : 0;
+        for (GLsizei x = 0; x < width; ++x) {
+            const GLfloat dx = (width > 1) ? (((GLfloat) x) / (width - 1)) : 0;
+            values[x] = (dx + dy + dz) / 3;
+        }
+        break;
+    }
+    case NOISE: {
+        const GLuint base = Noise::hash(_seed ^ Noise::hash(y ^ Noise::hash(z)));
+        for (GLsizei x = 0; x < width; ++x) {
+            values[x] = Noise::toUnit(Noise::hash(base + x));
+        }
+        break;
+    }
+    case SPHERES: {
+        const GLfloat smallest = std::min(width, std::min(_size.height, _size.depth));
+        std::fill(values.begin(), values.end(), 0.0f);
+        for (int i = 0; i < NUMBER_OF_SPHERES; ++i) {
+
+            // Place the sphere
+            const GLuint h = Noise::hash(_seed + i);
+            const GLfloat cx = Noise::toUnit(Noise::hash(h + 1)) * width;
+            const GLfloat cy = Noise::toUnit(Noise::hash(h + 2)) * _size.height;
+            const GLfloat cz = Noise::toUnit(Noise::hash(h + 3)) * _size.depth;
+            const GLfloat r = smallest * (1.0f + 3.0f * Noise::toUnit(Noise::hash(h + 4))) / 16;
+
+            // Find where this row crosses it
+            const GLfloat dy = y - cy;
+            const GLfloat dz = z - cz;
+            const GLfloat rr = r * r - dy * dy - dz * dz;
+            if (rr <= 0) {
+                continue;
+            }
+            const GLfloat half = sqrt(rr);
+            const GLsizei x1 = std::max(0, (GLsizei) ceil(cx - half));
+            const GLsizei x2 = std::min(width - 1, (GLsizei) floor(cx + half));
+            for (GLsizei x = x1; x <= x2; ++x) {
+                const GLfloat dx = x - cx;
+                const GLfloat value = 1 - (dx * dx + dy * dy + dz * dz) / (r * r);
+                values[x] = std::max(values[x], value);
+            }
+        }
+        break;
+    }
+    }
+
+    // Convert to the type of the volume
+    switch (_type) {
+    case GL_UNSIGNED_BYTE:
+        store<GLubyte>(&values[0], width, 255, dst);
+        break;
+    case GL_SHORT:
+        store<GLshort>(&values[0], width, 32767, dst);
+        break;
+    case GL_UNSIGNED_SHORT:
+        store<GLushort>(&values[0], width, 65535, dst);
+        break;
+    case GL_FLOAT:
+        store<GLfloat>(&values[0], width, 1, dst);
+        break;
+    }
+}
+
+/**
+ * Changes the kind of samples to generate.
+ *
+ * @param pattern Kind of samples to generate
+ * @return Reference to this generator to support chaining
+ */
+VolumeGenerator& VolumeGenerator::pattern(const Pattern pattern) {
+    _pattern = pattern;
+    return (*this);
+}
+
+/**
+ * Changes the seed used for random patterns.
+ *
+ * @param seed Seed used for random patterns
+ * @return Reference to this generator to support chaining
+ */
+VolumeGenerator& VolumeGenerator::seed(const GLuint seed) {
+    _seed = seed;
+    return (*this);
+}
+
+/**
+ * Changes the number of samples in each direction.
+ *
+ * @param width Number of samples in the X direction
+ * @param height Number of samples in the Y direction
+ * @param depth Number of samples in the Z direction
+ * @return Reference to this generator to support chaining
+ * @throws std::invalid_argument if width, height, or depth is less than one
+ */
+VolumeGenerator& VolumeGenerator::size(const GLsizei width, const GLsizei height, const GLsizei depth) {
+    if ((width < 1) || (height < 1) || (depth < 1)) {
+        throw std::invalid_argument("[VolumeGenerator] Width, height, or depth is less than one!");
+    }
+    _size.width = width;
+    _size.height = height;
+    _size.depth = depth;
+    return (*this);
+}
+
+/**
+ * Computes the size of a data type in bytes.
+ *
+ * @param type Data type to compute size of
+ * @return Size of type in bytes
+ */
+size_t VolumeGenerator::sizeOf(const GLenum type) {
+    return (type == GL_UNSIGNED_BYTE) ? 1 : ((type == GL_FLOAT) ? 4 : 2);
+}
+
+/**
+ * Scales values and stores them as another type.
+ *
+ * @param values Values between zero and one
+ * @param n Number of values
+ * @param scale Amount to multiply each value by
+ * @param dst Memory to store the converted values in
+ */
+template <typename T>
+void VolumeGenerator::store(const GLfloat* values, const size_t n, const GLfloat scale, GLubyte* dst) {
+    const GLfloat offset = std::numeric_limits<T>::is_integer ? 0.5f : 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const T value = (T) (values[i] * scale + offset);
+        memcpy(dst + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+/**
+ * Changes the type of the samples.
+ *
+ * @param type Either `GL_UNSIGNED_BYTE`, `GL_SHORT`, `GL_UNSIGNED_SHORT`, or `GL_FLOAT`
+ * @return Reference to this generator to support chaining
+ * @throws std::invalid_argument if type is unexpected
+ */
+VolumeGenerator& VolumeGenerator::type(const GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_FLOAT:
+        _type = type;
+        return (*this);
+    default:
+        throw std::invalid_argument("[VolumeGenerator] Unexpected type!");
+    }
+}
+
+/**
+ * Writes a volume file using the current settings, one slice at a time.
+ *
+ * @param filename Path to the file to write
+ * @throws std::length_error if one slice would be too large to hold in memory
+ * @throws std::runtime_error if file could not be opened or written
+ */
+void VolumeGenerator::write(const std::string& filename) const {
+
+    // Open file
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file) {
+        throw std::runtime_error("[VolumeGenerator] Could not open file!");
+    }
+
+    // Write header
+    const size_t sliceSize = computeLength(1);
+    Volume::Pitch pitch;
+    pitch.x = 1;
+    pitch.y = 1;
+    pitch.z = 1;
+    VolumeWriter::writeHeader(file, _size, _type, "", pitch);
+
+    // Generate and write each slice
+    std::vector<GLubyte> slice(sliceSize);
+    for (GLsizei z = 0; z < _size.depth; ++z) {
+        RowTask task(*this, ((size_t) z) * _size.height, &slice[0]);
+        Parallel::forEach(_size.height, task, 16);
+        file.write((const char*) &slice[0], sliceSize);
+        if (!file) {
+            throw std::runtime_error("[VolumeGenerator] Could not write data!");
+        }
+    }
+}
+
+} /* namespace Glycerin */
@@ -0,0 +1,101 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_VOLUME_GENERATOR_HXX
+#define GLYCERIN_VOLUME_GENERATOR_HXX
+#include <string>
+#include "glycerin/common.h"
+#include "glycerin/Volume.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for making volumes procedurally.
+ *
+ * _VolumeGenerator_ makes reproducible volumes of any size and type, which
+ * is useful for measuring how loading, uploading, and processing scale.  Like
+ * _BufferLayoutBuilder_, its properties are set with chained calls.
+ *
+ * ~~~
+ * VolumeGenerator generator;
+ * generator.size(256, 256, 256).type(GL_UNSIGNED_SHORT).pattern(VolumeGenerator::SPHERES);
+ * ~~~
+ *
+ * The generator starts out making a 64x64x64 volume of `GL_UNSIGNED_BYTE`
+ * samples filled with [noise](@ref NOISE), using a seed of zero and a
+ * checkerboard cell size of eight samples.  Each pattern produces values
+ * between zero and one, which are scaled to the full range of integer types.
+ * The same settings always produce the same samples.
+ *
+ * Then call [generate] to make a volume in memory.
+ *
+ * ~~~
+ * const Volume volume = generator.generate();
+ * ~~~
+ *
+ * Or call [write] to write a volume file directly.  Only one slice is kept in
+ * memory at a time, so files can be much larger than available memory.
+ *
+ * ~~~
+ * generator.size(4096, 4096, 1024).write("large.vlb");
+ * ~~~
+ *
+ * [generate]: @ref generate() const "generate()"
+ * [write]: @ref write(const std::string&) const "write(const std::string&)"
+ */
+class VolumeGenerator {
+public:
+// Types
+    /// Kind of samples to generate
+    enum Pattern {
+        CHECKERBOARD, ///< Alternating cubes of zero and one
+        GRADIENT,     ///< Ramp from zero at the first corner to one at the opposite corner
+        NOISE,        ///< Independent random value for every sample
+        SPHERES       ///< Randomly placed spheres fading from one at the center to zero at the edge
+    };
+// Methods
+    VolumeGenerator();
+    VolumeGenerator& cellSize(GLsizei cellSize);
+    Volume generate() const;
+    VolumeGenerator& pattern(Pattern pattern);
+    VolumeGenerator& seed(GLuint seed);
+    VolumeGenerator& size(GLsizei width, GLsizei height, GLsizei depth);
+    VolumeGenerator& type(GLenum type);
+    void write(const std::string& filename) const;
+private:
+// Types
+    class RowTask;
+// Constants
+    static const GLsizei DEFAULT_CELL_SIZE = 8;
+    static const GLsizei DEFAULT_SIZE = 64;
+    static const GLenum DEFAULT_TYPE = GL_UNSIGNED_BYTE;
+    static const int NUMBER_OF_SPHERES = 8;
+// Attributes
+    GLsizei _cellSize;
+    Volume::Size _size;
+    Pattern _pattern;
+    GLuint _seed;
+    GLenum _type;
+// Methods
+    size_t computeLength(GLsizei depth) const;
+    void generateRow(size_t row, GLubyte* dst) const;
+    static size_t sizeOf(GLenum type);
+    template <typename T> static void store(const GLfloat* values, size_t n, GLfloat scale, GLubyte* dst);
+};
+
+} /* namespace Glycerin */
+#endif
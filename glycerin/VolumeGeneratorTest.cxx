@@ -0,0 +1,169 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/VolumeGenerator.hxx"
+#include "glycerin/VolumeReader.hxx"
+
+
+/**
+ * Unit test for `VolumeGenerator`.
+ */
+class VolumeGeneratorTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Returns the samples of a volume.
+     */
+    static std::vector<GLubyte> getData(const Glycerin::Volume& volume) {
+        std::vector<GLubyte> data(volume.getLength());
+        volume.getData(&data[0]);
+        return data;
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` uses the size and type given.
+     */
+    void testGenerateWithSizeAndType() {
+        const Glycerin::Volume volume = Glycerin::VolumeGenerator()
+                .size(5, 6, 7)
+                .type(GL_UNSIGNED_SHORT)
+                .generate();
+        CPPUNIT_ASSERT_EQUAL(5, volume.getWidth());
+        CPPUNIT_ASSERT_EQUAL(6, volume.getHeight());
+        CPPUNIT_ASSERT_EQUAL(7, volume.getDepth());
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_UNSIGNED_SHORT, volume.getType());
+        CPPUNIT_ASSERT_EQUAL(5 * 6 * 7 * 2, volume.getLength());
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` makes a checkerboard correctly.
+     */
+    void testGenerateCheckerboard() {
+        const Glycerin::Volume volume = Glycerin::VolumeGenerator()
+                .size(4, 4, 4)
+                .cellSize(2)
+                .pattern(Glycerin::VolumeGenerator::CHECKERBOARD)
+                .generate();
+        const std::vector<GLubyte> data = getData(volume);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 0, data[0]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 0, data[1]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, data[2]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, data[4 * 2]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 0, data[4 * 4 * 2 + 4 * 2]);
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` makes a gradient correctly.
+     */
+    void testGenerateGradient() {
+        const Glycerin::Volume volume = Glycerin::VolumeGenerator()
+                .size(3, 3, 3)
+                .pattern(Glycerin::VolumeGenerator::GRADIENT)
+                .generate();
+        const std::vector<GLubyte> data = getData(volume);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 0, data.front());
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 128, data[13]);
+        CPPUNIT_ASSERT_EQUAL((GLubyte) 255, data.back());
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` makes the same noise for the same seed.
+     */
+    void testGenerateNoiseIsReproducible() {
+        Glycerin::VolumeGenerator generator;
+        generator.size(16, 16, 16).pattern(Glycerin::VolumeGenerator::NOISE);
+        const std::vector<GLubyte> first = getData(generator.seed(1).generate());
+        const std::vector<GLubyte> second = getData(generator.seed(1).generate());
+        const std::vector<GLubyte> third = getData(generator.seed(2).generate());
+        CPPUNIT_ASSERT(first == second);
+        CPPUNIT_ASSERT(first != third);
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` makes some empty and some filled space for spheres.
+     */
+    void testGenerateSpheres() {
+        const Glycerin::Volume volume = Glycerin::VolumeGenerator()
+                .size(32, 32, 32)
+                .pattern(Glycerin::VolumeGenerator::SPHERES)
+                .generate();
+        const std::vector<GLubyte> data = getData(volume);
+        const size_t empty = std::count(data.begin(), data.end(), 0);
+        CPPUNIT_ASSERT(empty > 0);
+        CPPUNIT_ASSERT(empty < data.size());
+    }
+
+    /**
+     * Ensures `VolumeGenerator::generate` throws if the volume would be too large.
+     */
+    void testGenerateWithHugeSize() {
+        Glycerin::VolumeGenerator generator;
+        generator.size(std::numeric_limits<GLsizei>::max(), 2, 1);
+        CPPUNIT_ASSERT_THROW(generator.generate(), std::length_error);
+        generator.size(2048, 2048, 2048);
+        CPPUNIT_ASSERT_THROW(generator.generate(), std::length_error);
+    }
+
+    /**
+     * Ensures `VolumeGenerator::size` throws if passed zero.
+     */
+    void testSizeWithZero() {
+        Glycerin::VolumeGenerator generator;
+        CPPUNIT_ASSERT_THROW(generator.size(0, 1, 1), std::invalid_argument);
+    }
+
+    /**
+     * Ensures `VolumeGenerator::write` makes a file with the same samples as `VolumeGenerator::generate`.
+     */
+    void testWrite() {
+        Glycerin::VolumeGenerator generator;
+        generator.size(8, 9, 10).type(GL_FLOAT).pattern(Glycerin::VolumeGenerator::SPHERES).seed(3);
+        generator.write("VolumeGeneratorTest.vlb");
+        Glycerin::VolumeReader reader;
+        const Glycerin::Volume volume = reader.read("VolumeGeneratorTest.vlb");
+        remove("VolumeGeneratorTest.vlb");
+        CPPUNIT_ASSERT_EQUAL((GLenum) GL_FLOAT, volume.getType());
+        CPPUNIT_ASSERT(getData(generator.generate()) == getData(volume));
+    }
+
+    CPPUNIT_TEST_SUITE(VolumeGeneratorTest);
+    CPPUNIT_TEST(testGenerateWithSizeAndType);
+    CPPUNIT_TEST(testGenerateCheckerboard);
+    CPPUNIT_TEST(testGenerateGradient);
+    CPPUNIT_TEST(testGenerateNoiseIsReproducible);
+    CPPUNIT_TEST(testGenerateSpheres);
+    CPPUNIT_TEST(testGenerateWithHugeSize);
+    CPPUNIT_TEST(testSizeWithZero);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(VolumeGeneratorTest::suite());
+    runner.run();
+    return 0;
+}
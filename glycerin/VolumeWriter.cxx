@@ -0,0 +1,139 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <fstream>
+#include <stdexcept>
+#include "glycerin/VolumeWriter.hxx"
+namespace Glycerin {
+
+/**
+ * Constructs a `VolumeWriter`.
+ */
+VolumeWriter::VolumeWriter() {
+    // empty
+}
+
+/**
+ * Returns the byte order of this machine.
+ *
+ * @return Either _big_ or _little_
+ */
+std::string VolumeWriter::getHostEndianness() {
+    const GLushort one = 1;
+    return (*((const GLubyte*) &one) == 1) ? "little" : "big";
+}
+
+/**
+ * Returns the name used for a type in a volume file.
+ *
+ * @param type Type of the data in the volume
+ * @return Name used for the type in a volume file
+ * @throws std::invalid_argument if type is unexpected
+ */
+std::string VolumeWriter::getTypeName(const GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+        return "uint8";
+    case GL_SHORT:
+        return "int16";
+    case GL_UNSIGNED_SHORT:
+        return "uint16";
+    case GL_FLOAT:
+        return "float";
+    default:
+        throw std::invalid_argument("[VolumeWriter] Unexpected type!");
+    }
+}
+
+/**
+ * Returns the smallest and largest values of a type, separated by a space.
+ *
+ * @param type Type of the data in the volume
+ * @return Smallest and largest values of the type, separated by a space
+ * @throws std::invalid_argument if type is unexpected
+ */
+std::string VolumeWriter::getTypeRange(const GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+        return "0 255";
+    case GL_SHORT:
+        return "-32768 32767";
+    case GL_UNSIGNED_SHORT:
+        return "0 65535";
+    case GL_FLOAT:
+        return "0 1";
+    default:
+        throw std::invalid_argument("[VolumeWriter] Unexpected type!");
+    }
+}
+
+/**
+ * Writes a volume to a file.
+ *
+ * @param volume Volume to write
+ * @param filename Path to the file to write
+ * @throws std::invalid_argument if volume has no data
+ * @throws std::runtime_error if file could not be opened or written
+ */
+void VolumeWriter::write(const Volume& volume, const std::string& filename) {
+
+    // Check volume
+    if (volume.data == NULL) {
+        throw std::invalid_argument("[VolumeWriter] Volume has no data!");
+    }
+
+    // Open file
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file) {
+        throw std::runtime_error("[VolumeWriter] Could not open file!");
+    }
+
+    // Write header and data
+    writeHeader(file, volume.size, volume.type, volume.endianness, volume.pitch);
+    file.write((const char*) volume.data, volume.getLength());
+    if (!file) {
+        throw std::runtime_error("[VolumeWriter] Could not write data!");
+    }
+}
+
+/**
+ * Writes the header of a volume file.
+ *
+ * @param stream Stream to write to
+ * @param size Number of samples in each direction
+ * @param type Type of the data in the volume
+ * @param endianness Endianness of the data, or empty for this machine's
+ * @param pitch Spacing between samples in each direction
+ * @throws std::invalid_argument if type is unexpected
+ */
+void VolumeWriter::writeHeader(std::ostream& stream,
+                               const Volume::Size& size,
+                               const GLenum type,
+                               const std::string& endianness,
+                               const Volume::Pitch& pitch) {
+    const std::string range = getTypeRange(type);
+    stream << "VLIB.1" << '\n';
+    stream << size.width << ' ' << size.height << ' ' << size.depth << '\n';
+    stream << getTypeName(type) << '\n';
+    stream << (endianness.empty() ? getHostEndianness() : endianness) << '\n';
+    stream << pitch.x << ' ' << pitch.y << ' ' << pitch.z << '\n';
+    stream << range << '\n';
+    stream << range << '\n';
+}
+
+} /* namespace Glycerin */
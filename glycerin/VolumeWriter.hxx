@@ -0,0 +1,59 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLYCERIN_VOLUME_WRITER_HXX
+#define GLYCERIN_VOLUME_WRITER_HXX
+#include <ostream>
+#include <string>
+#include "glycerin/common.h"
+#include "glycerin/Volume.hxx"
+namespace Glycerin {
+
+
+/**
+ * Utility for writing a volume to a file.
+ *
+ * Volumes are written in the same _VLIB.1_ format read by [read].
+ *
+ * ~~~
+ * VolumeWriter writer;
+ * writer.write(volume, "copy.vlb");
+ * ~~~
+ *
+ * [read]: @ref VolumeReader::read(const std::string&) "VolumeReader::read(const std::string&)"
+ */
+class VolumeWriter {
+public:
+// Methods
+    VolumeWriter();
+    void write(const Volume& volume, const std::string& filename);
+private:
+// Methods
+    static std::string getHostEndianness();
+    static std::string getTypeName(GLenum type);
+    static std::string getTypeRange(GLenum type);
+    static void writeHeader(std::ostream& stream,
+                            const Volume::Size& size,
+                            GLenum type,
+                            const std::string& endianness,
+                            const Volume::Pitch& pitch);
+// Friends
+    friend class VolumeGenerator;
+};
+
+} /* namespace Glycerin */
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.h"
+#include <cstdio>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/ui/text/TestRunner.h>
+#include "glycerin/VolumeReader.hxx"
+#include "glycerin/VolumeWriter.hxx"
+
+
+/**
+ * Unit test for `VolumeWriter`.
+ */
+class VolumeWriterTest : public CppUnit::TestFixture {
+public:
+
+    /**
+     * Ensures a volume written by `VolumeWriter::write` can be read back in.
+     */
+    void testWrite() {
+
+        // Read a volume and write it back out
+        Glycerin::VolumeReader reader;
+        const Glycerin::Volume expected = reader.read("glycerin/bunny.vlb");
+        Glycerin::VolumeWriter writer;
+        writer.write(expected, "VolumeWriterTest.vlb");
+
+        // Read it back in
+        const Glycerin::Volume actual = reader.read("VolumeWriterTest.vlb");
+        remove("VolumeWriterTest.vlb");
+
+        // Compare
+        CPPUNIT_ASSERT_EQUAL(expected.getWidth(), actual.getWidth());
+        CPPUNIT_ASSERT_EQUAL(expected.getHeight(), actual.getHeight());
+        CPPUNIT_ASSERT_EQUAL(expected.getDepth(), actual.getDepth());
+        CPPUNIT_ASSERT_EQUAL(expected.getType(), actual.getType());
+        CPPUNIT_ASSERT_EQUAL(expected.getEndianness(), actual.getEndianness());
+        CPPUNIT_ASSERT_EQUAL(expected.getPitchX(), actual.getPitchX());
+        std::vector<GLubyte> e(expected.getLength());
+        std::vector<GLubyte> a(actual.getLength());
+        expected.getData(&e[0]);
+        actual.getData(&a[0]);
+        CPPUNIT_ASSERT(e == a);
+    }
+
+    CPPUNIT_TEST_SUITE(VolumeWriterTest);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+int main(int argc, char* argv[]) {
+    CppUnit::TextUi::TestRunner runner;
+    runner.addTest(VolumeWriterTest::suite());
+    runner.run();
+    return 0;
+}
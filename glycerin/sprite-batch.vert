@@ -0,0 +1,47 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#version 140
+
+// Uniforms
+uniform mat4 MVPMatrix = mat4(1);
+
+// Inputs
+in vec4 MCRectangle;
+in vec4 Region;
+in vec4 Tint;
+
+// Outputs
+out vec2 Coord0;
+out vec4 Color;
+
+// Corners of the quad for each of its six vertices
+const vec2 CORNERS[6] = vec2[6](
+        vec2(1, 1),
+        vec2(0, 1),
+        vec2(0, 0),
+        vec2(0, 0),
+        vec2(1, 0),
+        vec2(1, 1));
+
+
+void main() {
+    vec2 corner = CORNERS[gl_VertexID % 6];
+    gl_Position = MVPMatrix * vec4(MCRectangle.xy + corner * MCRectangle.zw, 0, 1);
+    Coord0 = mix(Region.xy, Region.zw, corner);
+    Color = Tint;
+}
@@ -0,0 +1,34 @@
+/*
+ * Glycerin - Fuel for OpenGL applications
+ * Copyright (C) 2013  Andrew Brown
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#version 140
+
+// Uniforms
+uniform sampler2D Texture;
+
+// Inputs
+in vec2 Coord0;
+
+// Outputs
+out vec4 FragColor;
+
+
+void main() {
+    float distance = texture(Texture, Coord0).r;
+    float width = fwidth(distance);
+    FragColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - width, 0.5 + width, distance));
+}
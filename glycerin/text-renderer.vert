@@ -19,16 +19,28 @@
 
 // Uniforms
 uniform mat4 MVPMatrix = mat4(1);
+uniform vec2 CharacterSize;
+uniform float DeltaS;
+uniform vec2 Translation = vec2(0);
 
 // Inputs
-in vec4 MCVertex;
-in vec2 TexCoord0;
+in vec3 MCCharacter;
 
 // Outputs
 out vec2 Coord0;
 
+// Corners of the quad for each of its six vertices
+const vec2 CORNERS[6] = vec2[6](
+        vec2(1, 1),
+        vec2(0, 1),
+        vec2(0, 0),
+        vec2(0, 0),
+        vec2(1, 0),
+        vec2(1, 1));
+
 
 void main() {
-    gl_Position = MVPMatrix * MCVertex;
-    Coord0 = TexCoord0;
+    vec2 corner = CORNERS[gl_VertexID % 6];
+    gl_Position = MVPMatrix * vec4(Translation + MCCharacter.xy + corner * CharacterSize, 0, 1);
+    Coord0 = vec2((MCCharacter.z + corner.x) * DeltaS, corner.y);
 }